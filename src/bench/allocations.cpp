@@ -0,0 +1,87 @@
+#include "allocations.h"
+
+#include "generator.h"
+#include "measure.h"
+#include "svgscene/svghandler.h"
+#include "svgscene/svgtree.h"
+
+#include <QGraphicsScene>
+#include <atomic>
+#include <cstdlib>
+
+#if defined(__GLIBC__)
+    #define SVGSCENE_BENCH_COUNT_ALLOCATIONS 1
+#endif
+
+/** Calls of the allocation functions, constant initialized before any allocation. */
+static std::atomic<unsigned long long> g_allocations(0);
+
+#ifdef SVGSCENE_BENCH_COUNT_ALLOCATIONS
+// Definitions in the executable interpose the ones of the C library for the whole process,
+// including Qt and `operator new`. glibc exports its implementations under these names.
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+}
+#endif
+
+namespace bench {
+
+static qint64 allocations() {
+#ifdef SVGSCENE_BENCH_COUNT_ALLOCATIONS
+    return qint64(g_allocations.load());
+#else
+    return -1;
+#endif
+}
+
+static qint64 difference(qint64 before, qint64 after) {
+    return (before < 0) ? -1 : after - before;
+}
+
+void benchAllocations(QTextStream &out, const QByteArray &sample, const QString &dir) {
+    using namespace svgscene;
+    out << "# heap allocations\n";
+    out << "copies\telements\ttree_allocs\ttree_per_element\tarena_allocs\tarena_blocks"
+           "\tload_allocs\tload_per_element\n";
+    // Single thread, worker threads add allocations of their own.
+    ParseOptions options;
+    options.threads = 1;
+    forEachScale(
+        out, sample, dir, QStringLiteral("allocations.svg"),
+        [&](int copies, const QByteArray &, const QString &path) {
+            qint64 before = allocations();
+            const SvgTree tree = parseTreeFromFileName(path, options);
+            const qint64 tree_allocs = difference(before, allocations());
+
+            QGraphicsScene scene;
+            SvgHandler handler(&scene);
+            before = allocations();
+            handler.load(tree);
+            const qint64 load_allocs = difference(before, allocations());
+
+            const int elements = qMax(1, tree.nodes().size());
+            out << copies << '\t' << tree.nodes().size() << '\t' << tree_allocs << '\t'
+                << double(tree_allocs) / elements << '\t' << tree.stats().arenaAllocations << '\t'
+                << tree.stats().arenaBlocks << '\t' << load_allocs << '\t'
+                << double(load_allocs) / elements << '\n';
+        });
+}
+
+} // namespace bench
@@ -0,0 +1,21 @@
+/**
+ * Heap allocation counts of the parse.
+ *
+ * @file
+ */
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QTextStream>
+
+namespace bench {
+
+/**
+ * Counts heap allocations of the tree phase and of the materialization per element of the scaled
+ * sample, next to the temporaries served by arenas instead (see `svgarena.h`). Counting replaces
+ * `malloc` of the process, which is only possible with glibc; elsewhere the counts are -1.
+ */
+void benchAllocations(QTextStream &out, const QByteArray &sample, const QString &dir);
+
+} // namespace bench
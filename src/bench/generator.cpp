@@ -0,0 +1,251 @@
+#include "generator.h"
+
+#include <QDir>
+#include <QFile>
+#include <QVector>
+
+namespace bench {
+
+/**
+ * Content of the root element of the sample (without the root tags).
+ */
+static QByteArray rootContent(const QByteArray &sample) {
+    // Skip prolog, comments and processing instructions to the root start tag.
+    int pos = 0;
+    while ((pos = sample.indexOf('<', pos)) >= 0) {
+        const char next = (pos + 1 < sample.size()) ? sample.at(pos + 1) : '\0';
+        if (next != '?' && next != '!') {
+            break;
+        }
+        ++pos;
+    }
+    if (pos < 0) {
+        return {};
+    }
+    const int start = sample.indexOf('>', pos) + 1;
+    const int end = sample.lastIndexOf("</");
+    if (start <= 0 || end < start) {
+        return {};
+    }
+    return sample.mid(start, end - start);
+}
+
+QByteArray scaleSample(const QByteArray &sample, int copies) {
+    const QByteArray content = rootContent(sample);
+    const int columns = 16;
+
+    QByteArray out;
+    out.reserve(content.size() * copies + 1024);
+    out += "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>\n"
+           "<svg xmlns=\"http://www.w3.org/2000/svg\"\n"
+           "   xmlns:dc=\"http://purl.org/dc/elements/1.1/\"\n"
+           "   xmlns:cc=\"http://creativecommons.org/ns#\"\n"
+           "   xmlns:rdf=\"http://www.w3.org/1999/02/22-rdf-syntax-ns#\"\n"
+           "   xmlns:sodipodi=\"http://sodipodi.sourceforge.net/DTD/sodipodi-0.dtd\"\n"
+           "   xmlns:inkscape=\"http://www.inkscape.org/namespaces/inkscape\"\n"
+           "   version=\"1.1\">\n";
+    for (int i = 0; i < copies; ++i) {
+        out += "<g transform=\"translate(";
+        out += QByteArray::number((i % columns) * 210);
+        out += ',';
+        out += QByteArray::number((i / columns) * 297);
+        out += ")\">";
+        out += content;
+        out += "</g>\n";
+    }
+    out += "</svg>\n";
+    return out;
+}
+
+/**
+ * Xorshift generator, the documents must not depend on the platform's `rand`.
+ */
+class Random {
+public:
+    explicit Random(quint32 seed) : m_state(seed ? seed : 0x9e3779b9u) {}
+
+    quint32 next() {
+        m_state ^= m_state << 13;
+        m_state ^= m_state >> 17;
+        m_state ^= m_state << 5;
+        return m_state;
+    }
+
+    /** Integer in range [0, bound). */
+    int below(int bound) { return int(next() % quint32(bound)); }
+    /** True with the given probability. */
+    bool chance(double probability) { return next() < probability * 4294967296.0; }
+
+private:
+    quint32 m_state;
+};
+
+static const int CANVAS_SIZE = 2000;
+/** Groups of each level hold this many groups of the next level. */
+static const int GROUP_FANOUT = 4;
+
+static const char *const COLORS[] = {
+    "#1f77b4", "#ff7f0e", "#2ca02c", "#d62728", "#9467bd", "#8c564b", "#e377c2", "#7f7f7f",
+};
+
+static void appendTransform(QByteArray &out, Random &random, double density) {
+    if (!random.chance(density)) {
+        return;
+    }
+    switch (random.below(3)) {
+    case 0:
+        out += " transform=\"translate(";
+        out += QByteArray::number(random.below(40) - 20);
+        out += ',';
+        out += QByteArray::number(random.below(40) - 20);
+        out += ")\"";
+        break;
+    case 1:
+        out += " transform=\"rotate(";
+        out += QByteArray::number(random.below(360));
+        out += ")\"";
+        break;
+    default:
+        out += " transform=\"matrix(1,0,0,1,";
+        out += QByteArray::number(random.below(10));
+        out += ',';
+        out += QByteArray::number(random.below(10));
+        out += ")\"";
+        break;
+    }
+}
+
+static void appendElementAttributes(
+    QByteArray &out,
+    Random &random,
+    const SyntheticShape &shape,
+    int index) {
+    out += " id=\"e";
+    out += QByteArray::number(index);
+    out += "\" class=\"c";
+    out += QByteArray::number(index % 16);
+    out += '"';
+    for (int i = 0; i < shape.attributes; ++i) {
+        out += " data-a";
+        out += QByteArray::number(i);
+        out += "=\"";
+        out += QByteArray::number(random.below(1000));
+        out += '"';
+    }
+    appendTransform(out, random, shape.transformDensity);
+}
+
+static void appendPath(QByteArray &out, Random &random, const SyntheticShape &shape, int index) {
+    out += "<path";
+    appendElementAttributes(out, random, shape, index);
+    out += " style=\"fill:";
+    out += COLORS[random.below(8)];
+    out += ";stroke:#000000;stroke-width:";
+    out += QByteArray::number(1 + random.below(3));
+    out += "\" d=\"M ";
+    out += QByteArray::number(random.below(CANVAS_SIZE));
+    out += ',';
+    out += QByteArray::number(random.below(CANVAS_SIZE));
+    const int segments = 4 + random.below(9);
+    for (int i = 0; i < segments; ++i) {
+        if (random.below(4) == 0) {
+            out += " c";
+            for (int j = 0; j < 3; ++j) {
+                out += ' ';
+                out += QByteArray::number(random.below(60) - 30);
+                out += ',';
+                out += QByteArray::number(random.below(60) - 30);
+            }
+        } else {
+            out += " l ";
+            out += QByteArray::number(random.below(60) - 30);
+            out += ',';
+            out += QByteArray::number(random.below(60) - 30);
+        }
+    }
+    out += " z\"/>\n";
+}
+
+static void appendText(QByteArray &out, Random &random, const SyntheticShape &shape, int index) {
+    out += "<text";
+    appendElementAttributes(out, random, shape, index);
+    out += " x=\"";
+    out += QByteArray::number(random.below(CANVAS_SIZE));
+    out += "\" y=\"";
+    out += QByteArray::number(random.below(CANVAS_SIZE));
+    out += "\" style=\"font-size:";
+    out += QByteArray::number(8 + 2 * random.below(4));
+    out += "px;font-family:sans-serif\">Label ";
+    out += QByteArray::number(index);
+    out += "</text>\n";
+}
+
+QByteArray generateSynthetic(const SyntheticShape &shape) {
+    Random random(shape.seed);
+    QByteArray out;
+    out.reserve(shape.paths * (160 + 24 * shape.attributes));
+    out += "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>\n"
+           "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\" width=\"";
+    out += QByteArray::number(CANVAS_SIZE);
+    out += "\" height=\"";
+    out += QByteArray::number(CANVAS_SIZE);
+    out += "\">\n";
+
+    // Elements per group of each level, the outermost level first.
+    QVector<int> span(shape.groupDepth);
+    for (int level = shape.groupDepth - 1, size = LEAF_ELEMENTS; level >= 0; --level) {
+        span[level] = size;
+        size *= GROUP_FANOUT;
+    }
+    // Index of the open group of each level, -1 when none is open.
+    QVector<int> open(shape.groupDepth, -1);
+    int element = 0;
+    double text_credit = 0;
+    for (int i = 0; i < shape.paths; ++i) {
+        // Groups opened (and closed) here are those whose index changed with this element.
+        int level = 0;
+        while (level < shape.groupDepth && open[level] == element / span[level]) {
+            ++level;
+        }
+        for (int inner = shape.groupDepth - 1; inner >= level; --inner) {
+            if (open[inner] >= 0) {
+                out += "</g>\n";
+            }
+        }
+        for (; level < shape.groupDepth; ++level) {
+            open[level] = element / span[level];
+            out += "<g id=\"g";
+            out += QByteArray::number(level);
+            out += '_';
+            out += QByteArray::number(open[level]);
+            out += '"';
+            appendTransform(out, random, shape.transformDensity);
+            out += ">\n";
+        }
+
+        appendPath(out, random, shape, element++);
+        text_credit += shape.textDensity;
+        while (text_credit >= 1) {
+            appendText(out, random, shape, element++);
+            text_credit -= 1;
+        }
+    }
+    for (int level = 0; level < shape.groupDepth; ++level) {
+        if (open[level] >= 0) {
+            out += "</g>\n";
+        }
+    }
+    out += "</svg>\n";
+    return out;
+}
+
+QString writeTemporary(const QString &dir, const QString &name, const QByteArray &data) {
+    const QString path = QDir(dir).filePath(name);
+    QFile file(path);
+    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        file.write(data);
+    }
+    return path;
+}
+
+} // namespace bench
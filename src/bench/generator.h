@@ -0,0 +1,53 @@
+/**
+ * Synthetic SVG inputs for benchmarks.
+ *
+ * @file
+ */
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+
+namespace bench {
+
+/**
+ * Shape of a synthetic document, see `generateSynthetic`.
+ */
+struct SyntheticShape {
+    /** Number of path elements. */
+    int paths = 1000;
+    /** Depth of the nested groups holding the elements, 0 places them in the root. */
+    int groupDepth = 3;
+    /** Text elements per path element. */
+    double textDensity = 0.1;
+    /** Fraction of elements and groups having a transform. */
+    double transformDensity = 0.25;
+    /** Additional `data-*` attributes of each element. */
+    int attributes = 2;
+    /** Seed of the generator, the same shape with the same seed gives the same document. */
+    quint32 seed = 1;
+};
+
+/** Elements of an innermost group of `generateSynthetic`. */
+const int LEAF_ELEMENTS = 16;
+
+/**
+ * Generates a document of the given shape. Each group holds about `LEAF_ELEMENTS` elements or four
+ * groups of the next level. Element `i` has id `e<i>` and class `c<i % 16>`, groups have ids
+ * `g<level>_<index>`, so the searches of the benchmarks know what to look for.
+ */
+QByteArray generateSynthetic(const SyntheticShape &shape);
+
+/**
+ * Replicates the content of a sample document `copies` times, each copy placed in its own
+ * translated group of a new `<svg>` root element.
+ */
+QByteArray scaleSample(const QByteArray &sample, int copies);
+
+/**
+ * Writes data to a file in the temporary directory, returns its path.
+ */
+QString writeTemporary(const QString &dir, const QString &name, const QByteArray &data);
+
+} // namespace bench
@@ -0,0 +1,127 @@
+#include "keywords.h"
+
+#include "svgscene/svgkeywords.h"
+
+#include <QColor>
+#include <QElapsedTimer>
+#include <QFont>
+#include <QStringList>
+#include <limits>
+
+namespace bench {
+
+static const int ROUNDS = 20;
+/** Lookups per round, each input is resolved many times to get measurable times. */
+static const int REPEATS = 200;
+
+/**
+ * Font stretch parsing used before `svgkeywords.h`, kept as the baseline.
+ */
+static int legacyFontStretch(const QString &value) {
+    if (value == QLatin1String("ultra-condensed"))
+        return QFont::UltraCondensed;
+    else if (value == QLatin1String("extra-condensed"))
+        return QFont::ExtraCondensed;
+    else if (value == QLatin1String("condensed"))
+        return QFont::Condensed;
+    else if (value == QLatin1String("semi-condensed"))
+        return QFont::SemiCondensed;
+    else if (value == QLatin1String("semi-expanded"))
+        return QFont::SemiExpanded;
+    else if (value == QLatin1String("expanded"))
+        return QFont::Expanded;
+    else if (value == QLatin1String("extra-expanded"))
+        return QFont::ExtraExpanded;
+    else if (value == QLatin1String("ultra-expanded"))
+        return QFont::UltraExpanded;
+    else
+        return QFont::Unstretched;
+}
+
+static int fontStretch(const QString &value) {
+    using svgscene::Keyword;
+    switch (svgscene::findKeyword(value)) {
+    case Keyword::UltraCondensed: return QFont::UltraCondensed;
+    case Keyword::ExtraCondensed: return QFont::ExtraCondensed;
+    case Keyword::Condensed: return QFont::Condensed;
+    case Keyword::SemiCondensed: return QFont::SemiCondensed;
+    case Keyword::SemiExpanded: return QFont::SemiExpanded;
+    case Keyword::Expanded: return QFont::Expanded;
+    case Keyword::ExtraExpanded: return QFont::ExtraExpanded;
+    case Keyword::UltraExpanded: return QFont::UltraExpanded;
+    default: return QFont::Unstretched;
+    }
+}
+
+static QRgb legacyColor(const QString &name) {
+    return QColor(name).rgba();
+}
+
+static QRgb namedColor(const QString &name) {
+    QRgb rgb;
+    // Same value as the invalid color made by the baseline.
+    return svgscene::findNamedColor(name.constData(), name.size(), &rgb) ? rgb : QColor().rgba();
+}
+
+template<typename Resolve>
+static double timeResolve(const QStringList &inputs, Resolve resolve) {
+    double best = std::numeric_limits<double>::max();
+    volatile uint sink = 0;
+    for (int i = 0; i < ROUNDS; ++i) {
+        QElapsedTimer timer;
+        timer.start();
+        uint sum = 0;
+        for (int j = 0; j < REPEATS; ++j) {
+            for (const QString &input : inputs) {
+                sum += static_cast<uint>(resolve(input));
+            }
+        }
+        sink = sink + sum;
+        best = qMin(best, timer.nsecsElapsed() / 1e6);
+    }
+    return best;
+}
+
+void benchKeywords(QTextStream &out) {
+    QStringList colors = QColor::colorNames();
+    // Names differing only in case and names, which are not colors.
+    for (const QString &name : QColor::colorNames()) {
+        colors.append(name.toUpper());
+    }
+    colors << QStringLiteral("currentColor") << QStringLiteral("inherit")
+           << QStringLiteral("none") << QStringLiteral("reddish");
+    const QStringList stretches { QStringLiteral("ultra-condensed"),
+                                  QStringLiteral("extra-condensed"),
+                                  QStringLiteral("condensed"),
+                                  QStringLiteral("semi-condensed"),
+                                  QStringLiteral("normal"),
+                                  QStringLiteral("semi-expanded"),
+                                  QStringLiteral("expanded"),
+                                  QStringLiteral("extra-expanded"),
+                                  QStringLiteral("ultra-expanded"),
+                                  QStringLiteral("inherit") };
+
+    int color_differences = 0;
+    for (const QString &name : colors) {
+        if (legacyColor(name) != namedColor(name)) {
+            ++color_differences;
+        }
+    }
+    int stretch_differences = 0;
+    for (const QString &value : stretches) {
+        if (legacyFontStretch(value) != fontStretch(value)) {
+            ++stretch_differences;
+        }
+    }
+
+    out << "# keywords: legacy vs perfect hash (" << REPEATS << " lookups of each input)\n";
+    out << "set\tinputs\tlegacy_ms\thash_ms\tdifferences\n";
+    out << "color\t" << colors.size() << '\t' << timeResolve(colors, legacyColor) << '\t'
+        << timeResolve(colors, namedColor) << '\t' << color_differences << '\n';
+    out << "font-stretch\t" << stretches.size() << '\t'
+        << timeResolve(stretches, legacyFontStretch) << '\t' << timeResolve(stretches, fontStretch)
+        << '\t' << stretch_differences << '\n';
+    out.flush();
+}
+
+} // namespace bench
@@ -0,0 +1,19 @@
+/**
+ * Micro-benchmark of the keyword and named color lookup.
+ *
+ * @file
+ */
+#pragma once
+
+#include <QTextStream>
+
+namespace bench {
+
+/**
+ * Resolves every color keyword and every font-stretch keyword with the perfect hash and with the
+ * previous implementation (`QColor` construction and a chain of comparisons), reports the time
+ * and the number of differing results.
+ */
+void benchKeywords(QTextStream &out);
+
+} // namespace bench
@@ -0,0 +1,580 @@
+/**
+ * Performance measurements of the svgscene parser.
+ *
+ * Usage: svgscene_bench [options] [sample.svg]
+ *
+ * Inputs are synthesized by scaling up the sample (by default `samples/1.svg`) to sizes from
+ * tens of kilobytes to megabytes. The scaling section uses generated documents instead, their
+ * shape is set by the options (see `--help`); `--json` writes its results to a file.
+ */
+#include "allocations.h"
+#include "generator.h"
+#include "keywords.h"
+#include "measure.h"
+#include "numbers.h"
+#include "queries.h"
+#include "scaling.h"
+#include "svgscene/components/lazysubtreeitem.h"
+#include "svgscene/svgasync.h"
+#include "svgscene/svgcompiled.h"
+#include "svgscene/svghandler.h"
+#include "svgscene/svgstream.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QGraphicsScene>
+#include <QLoggingCategory>
+#include <QTemporaryDir>
+#include <QTimer>
+#include <QTextStream>
+
+using namespace svgscene;
+
+/**
+ * Best of several runs in milliseconds. Scene teardown is not measured.
+ */
+static double timeParse(const QString &path, const ParseOptions &options) {
+    bench::BestTime best;
+    for (int i = 0; i < bench::REPEATS; ++i) {
+        QGraphicsScene scene;
+        best.start();
+        parseFromFileName(&scene, path, options);
+        best.stop();
+    }
+    return best.ms();
+}
+
+/**
+ * Compares reading through QIODevice with parsing from the memory mapped file.
+ */
+static void benchInputModes(QTextStream &out, const QByteArray &sample, const QString &dir) {
+    out << "# input: device vs mapped\n";
+    out << "copies\tbytes\tdevice_ms\tmapped_ms\n";
+    bench::forEachScale(
+        out, sample, dir, QStringLiteral("input.svg"),
+        [&](int copies, const QByteArray &data, const QString &path) {
+            const double device = timeParse(path, ParseOptions(InputMode::Device));
+            const double mapped = timeParse(path, ParseOptions(InputMode::Mapped));
+            out << copies << '\t' << data.size() << '\t' << device << '\t' << mapped << '\n';
+        });
+}
+
+/**
+ * Compares QXmlStreamReader with the specialized tokenizer, both reading the mapped file.
+ */
+static void benchReaders(QTextStream &out, const QByteArray &sample, const QString &dir) {
+    out << "# reader: qtxml vs tokenizer\n";
+    out << "copies\tbytes\tqtxml_ms\ttokenizer_ms\n";
+    ParseOptions qt_xml;
+    ParseOptions tokenizer;
+    tokenizer.reader = ReaderBackend::Tokenizer;
+    bench::forEachScale(
+        out, sample, dir, QStringLiteral("reader.svg"),
+        [&](int copies, const QByteArray &data, const QString &path) {
+            const double qt_xml_ms = timeParse(path, qt_xml);
+            const double tokenizer_ms = timeParse(path, tokenizer);
+            out << copies << '\t' << data.size() << '\t' << qt_xml_ms << '\t' << tokenizer_ms
+                << '\n';
+        });
+}
+
+/**
+ * Parses every sample with both readers and compares the compiled trees, which hold everything
+ * the scene is created from. Differences are reported to stderr.
+ *
+ * @return  false, when the trees of a sample differ
+ */
+static bool checkReaders(QTextStream &out) {
+    out << "# reader: qtxml vs tokenizer trees of the samples\n";
+    out << "sample\tbytes\tidentical\n";
+    ParseOptions qt_xml;
+    ParseOptions tokenizer;
+    tokenizer.reader = ReaderBackend::Tokenizer;
+    bool identical = true;
+    const QDir samples(QStringLiteral(SVGSCENE_SAMPLES_DIR));
+    for (const QFileInfo &sample :
+         samples.entryInfoList({ QStringLiteral("*.svg") }, QDir::Files, QDir::Name)) {
+        const QString path = sample.filePath();
+        const bool same = compileTree(parseTreeFromFileName(path, qt_xml))
+                          == compileTree(parseTreeFromFileName(path, tokenizer));
+        out << sample.fileName() << '\t' << sample.size() << '\t' << (same ? "yes" : "no") << '\n';
+        out.flush();
+        if (!same) {
+            QTextStream(stderr) << "Reader backends produce different trees for " << path << '\n';
+            identical = false;
+        }
+    }
+    return identical;
+}
+
+/**
+ * Splits the parse into the tree phase (may run on a worker thread) and the materialization
+ * phase (GUI thread only).
+ */
+static void benchPhases(QTextStream &out, const QByteArray &sample, const QString &dir) {
+    out << "# phases: tree vs materialize\n";
+    out << "copies\tbytes\ttree_ms\tmaterialize_ms\n";
+    bench::forEachScale(
+        out, sample, dir, QStringLiteral("phases.svg"),
+        [&](int copies, const QByteArray &data, const QString &path) {
+            bench::BestTime tree_ms;
+            bench::BestTime materialize_ms;
+            for (int i = 0; i < bench::REPEATS; ++i) {
+                tree_ms.start();
+                const SvgTree tree = parseTreeFromFileName(path);
+                tree_ms.stop();
+                QGraphicsScene scene;
+                materialize_ms.start();
+                materialize(&scene, tree);
+                materialize_ms.stop();
+            }
+            out << copies << '\t' << data.size() << '\t' << tree_ms.ms() << '\t'
+                << materialize_ms.ms() << '\n';
+        });
+}
+
+/**
+ * Profile of a large document: time of each phase and counters per element name. The profiled
+ * parse is compared with the plain one to show the cost of the timers.
+ */
+static void benchProfile(QTextStream &out, const QByteArray &sample, const QString &dir) {
+    const QByteArray data = bench::scaleSample(sample, 256);
+    const QString path = bench::writeTemporary(dir, QStringLiteral("profile.svg"), data);
+    ParseOptions profiled;
+    profiled.profile = true;
+    const double plain_ms = timeParse(path, ParseOptions());
+    const double profiled_ms = timeParse(path, profiled);
+    QGraphicsScene scene;
+    const ParseStats stats = parseFromFileName(&scene, path, profiled).getStats();
+
+    out << "# profile: phases (plain " << plain_ms << " ms, profiled " << profiled_ms << " ms)\n";
+    out << "phase\tcount\tms\n";
+    for (int i = 0; i < PARSE_PHASE_COUNT; ++i) {
+        const PhaseStats &phase = stats.profile.phases[i];
+        out << phaseName(ParsePhase(i)) << '\t' << phase.count << '\t'
+            << phase.nanoseconds / 1e6 << '\n';
+    }
+    out << "# profile: elements\n";
+    out << "element\tcount\tms\tattribute_bytes\tpath_segments\n";
+    for (auto it = stats.profile.elements.constBegin(); it != stats.profile.elements.constEnd();
+         ++it) {
+        out << it.key() << '\t' << it->count << '\t' << it->nanoseconds / 1e6 << '\t'
+            << it->attributeBytes << '\t' << it->pathSegments << '\n';
+    }
+    out.flush();
+}
+
+/**
+ * Scaling of the tree phase with the number of geometry decoding threads.
+ */
+static void benchThreads(QTextStream &out, const QByteArray &sample, const QString &dir) {
+    out << "# geometry decoding threads\n";
+    out << "threads\tbytes\ttree_ms\tmb_per_s\n";
+    const QByteArray data = bench::scaleSample(sample, 256);
+    const QString path = bench::writeTemporary(dir, QStringLiteral("threads.svg"), data);
+    for (int threads : { 1, 2, 4, 8 }) {
+        ParseOptions options;
+        options.threads = threads;
+        const double best = bench::bestOf([&] { parseTreeFromFileName(path, options); });
+        const double throughput = data.size() / 1e6 / (best / 1e3);
+        out << threads << '\t' << data.size() << '\t' << best << '\t' << throughput << '\n';
+        out.flush();
+    }
+}
+
+/**
+ * Tree phase with and without sharing of identical path data.
+ */
+static void benchPathCache(QTextStream &out, const QByteArray &sample, const QString &dir) {
+    out << "# path cache: none vs document\n";
+    out << "copies\tnone_ms\tdocument_ms\thits\tmisses\tsaved_elements\n";
+    ParseOptions none;
+    none.pathCache = PathCacheMode::None;
+    ParseOptions document;
+    document.pathCache = PathCacheMode::Document;
+    bench::forEachScale(
+        out, sample, dir, QStringLiteral("paths.svg"),
+        [&](int copies, const QByteArray &, const QString &path) {
+            ParseStats stats;
+            const double none_ms = bench::bestOf([&] { parseTreeFromFileName(path, none); });
+            const double document_ms = bench::bestOf(
+                [&] { stats = parseTreeFromFileName(path, document).stats(); });
+            out << copies << '\t' << none_ms << '\t' << document_ms << '\t'
+                << stats.pathCacheHits << '\t' << stats.pathCacheMisses << '\t'
+                << stats.pathCacheSavedElements << '\n';
+        });
+}
+
+/**
+ * Transform lists parsed once per document and shared by elements repeating them.
+ */
+static void benchTransformCache(QTextStream &out, const QByteArray &sample, const QString &dir) {
+    out << "# transform cache\n";
+    out << "copies\ttree_ms\thits\tmisses\thit_ratio\n";
+    bench::forEachScale(
+        out, sample, dir, QStringLiteral("transforms.svg"),
+        [&](int copies, const QByteArray &, const QString &path) {
+            ParseStats stats;
+            const double best
+                = bench::bestOf([&] { stats = parseTreeFromFileName(path).stats(); });
+            const quint64 lookups = stats.transformCacheHits + stats.transformCacheMisses;
+            out << copies << '\t' << best << '\t' << stats.transformCacheHits << '\t'
+                << stats.transformCacheMisses << '\t'
+                << (lookups ? double(stats.transformCacheHits) / lookups : 0.0) << '\n';
+        });
+}
+
+/**
+ * Counters of one of the caches shared among the created items.
+ */
+struct ItemCache {
+    /** Name of the section and (with an `s`) of its temporary file. */
+    const char *name;
+    /** Column of the cached values. */
+    const char *values;
+    quint64 ParseStats::*size;
+    quint64 ParseStats::*hits;
+    quint64 ParseStats::*misses;
+};
+
+/** Resolved pens and brushes. */
+static const ItemCache PAINT_CACHE = { "paint", "paints", &ParseStats::paintCacheSize,
+                                       &ParseStats::paintCacheHits,
+                                       &ParseStats::paintCacheMisses };
+
+/** Resolved fonts and metrics of the text items. */
+static const ItemCache FONT_CACHE = { "font", "fonts", &ParseStats::fontCacheSize,
+                                      &ParseStats::fontCacheHits,
+                                      &ParseStats::fontCacheMisses };
+
+/**
+ * Materialization of a parsed tree with the hits and misses of one of the item caches.
+ */
+static void benchItemCache(
+    QTextStream &out,
+    const QByteArray &sample,
+    const QString &dir,
+    const ItemCache &cache) {
+    out << "# " << cache.name << " cache\n";
+    out << "copies\tmaterialize_ms\t" << cache.values << "\thits\tmisses\thit_ratio\n";
+    bench::forEachScale(
+        out, sample, dir, QString::fromLatin1(cache.name) + QStringLiteral("s.svg"),
+        [&](int copies, const QByteArray &, const QString &path) {
+            const SvgTree tree = parseTreeFromFileName(path);
+            bench::BestTime best;
+            ParseStats stats;
+            for (int i = 0; i < bench::REPEATS; ++i) {
+                QGraphicsScene scene;
+                SvgHandler handler(&scene);
+                best.start();
+                handler.load(tree);
+                best.stop();
+                stats = handler.getStats();
+            }
+            const quint64 hits = stats.*cache.hits;
+            const quint64 lookups = hits + stats.*cache.misses;
+            out << copies << '\t' << best.ms() << '\t' << stats.*cache.size << '\t' << hits
+                << '\t' << stats.*cache.misses << '\t'
+                << (lookups ? double(hits) / lookups : 0.0) << '\n';
+        });
+}
+
+/**
+ * Tree phase from XML compared with loading a fresh compiled cache entry.
+ */
+static void benchCompiled(QTextStream &out, const QByteArray &sample, const QString &dir) {
+    out << "# compiled cache: xml vs compiled\n";
+    out << "copies\tbytes\tcompiled_bytes\txml_ms\tcompiled_ms\n";
+    ParseOptions cached;
+    cached.cacheDirectory = dir + QStringLiteral("/cache");
+    bench::forEachScale(
+        out, sample, dir, QStringLiteral("compiled.svg"),
+        [&](int copies, const QByteArray &data, const QString &path) {
+            // Compiles the entry.
+            const SvgTree tree = parseTreeFromFileName(path, cached);
+            const double xml_ms = bench::bestOf([&] { parseTreeFromFileName(path); });
+            const double compiled_ms
+                = bench::bestOf([&] { parseTreeFromFileName(path, cached); });
+            out << copies << '\t' << data.size() << '\t' << compileTree(tree).size() << '\t'
+                << xml_ms << '\t' << compiled_ms << '\n';
+        });
+}
+
+/**
+ * Eager materialization compared with the lazy one: initial load, expansion of the first view
+ * (four copies of the sample) and expansion of everything. Memory is the growth of the resident
+ * set while loading into a fresh scene, which is only indicative as the allocator reuses memory.
+ */
+static void benchLazy(QTextStream &out, const QByteArray &sample, const QString &dir) {
+    out << "# lazy materialization\n";
+    out << "copies\tmode\titems\tplaceholders\trss_kb\tload_ms\tview_items\tview_ms\tall_ms\n";
+    const QRectF view(0, 0, 2 * 210, 2 * 297);
+    bench::forEachScale(
+        out, sample, dir, QStringLiteral("lazy.svg"), { 64, 256, 1024 },
+        [&](int copies, const QByteArray &, const QString &path) {
+            const SvgTree tree = parseTreeFromFileName(path);
+            for (bool lazy : { true, false }) {
+                QGraphicsScene scene;
+                const qint64 rss = bench::statusKilobytes("VmRSS");
+                QElapsedTimer timer;
+                timer.start();
+                const SvgDocument document = materialize(&scene, tree, lazy);
+                const double load_ms = timer.nsecsElapsed() / 1e6;
+                const qint64 rss_growth
+                    = (rss < 0) ? -1 : bench::statusKilobytes("VmRSS") - rss;
+                const int items = scene.items().size();
+                const int placeholders = LazySubtreeItem::pendingCount();
+
+                timer.restart();
+                LazySubtreeItem::expandIn(&scene, view);
+                const double view_ms = timer.nsecsElapsed() / 1e6;
+                const int view_items = scene.items().size();
+                timer.restart();
+                LazySubtreeItem::expandAll(document.getRoot().getElement());
+                const double all_ms = timer.nsecsElapsed() / 1e6;
+
+                out << copies << '\t' << (lazy ? "lazy" : "eager") << '\t' << items << '\t'
+                    << placeholders << '\t' << rss_growth << '\t' << load_ms << '\t'
+                    << view_items << '\t' << view_ms << '\t' << all_ms << '\n';
+                out.flush();
+            }
+        });
+}
+
+/**
+ * Hot reload after a small edit (one element added) compared with parsing the edited file into a
+ * new scene. Reload includes parsing of the tree, which dominates it.
+ */
+static void benchReload(QTextStream &out, const QByteArray &sample, const QString &dir) {
+    out << "# hot reload of a small edit\n";
+    out << "copies\tbytes\ttree_ms\treload_ms\treparse_ms\n";
+    bench::forEachScale(
+        out, sample, dir, QStringLiteral("reload.svg"), { 16, 64, 256 },
+        [&](int copies, const QByteArray &data, const QString &path) {
+            QByteArray edited = data;
+            edited.insert(
+                edited.lastIndexOf("</svg>"),
+                "<rect id=\"reload-probe\" x=\"0\" y=\"0\" width=\"10\" height=\"10\"/>\n");
+            const QString edited_path
+                = bench::writeTemporary(dir, QStringLiteral("reload-edited.svg"), edited);
+
+            bench::BestTime tree_ms;
+            bench::BestTime reload_ms;
+            for (int i = 0; i < bench::REPEATS; ++i) {
+                QGraphicsScene scene;
+                const SvgDocument document = parseFromFileName(&scene, path);
+                tree_ms.start();
+                parseTreeFromFileName(edited_path);
+                tree_ms.stop();
+                reload_ms.start();
+                reloadFromFileName(document, edited_path);
+                reload_ms.stop();
+            }
+            const double reparse_ms = timeParse(edited_path, ParseOptions());
+            out << copies << '\t' << edited.size() << '\t' << tree_ms.ms() << '\t'
+                << reload_ms.ms() << '\t' << reparse_ms << '\n';
+        });
+}
+
+/**
+ * Synchronous load compared with the time-sliced one. The longest slice is the longest time the
+ * event loop is blocked, the first slice is the latency until the first items can be painted.
+ */
+static void benchStream(QTextStream &out, const QByteArray &sample, const QString &dir) {
+    out << "# time-sliced loading\n";
+    out << "copies\tbytes\tsync_ms\tstream_ms\tslices\tfirst_slice_ms\tmax_slice_ms\n";
+    bench::forEachScale(
+        out, sample, dir, QStringLiteral("stream.svg"), { 16, 64, 256 },
+        [&](int copies, const QByteArray &data, const QString &path) {
+            const double sync_ms = timeParse(path, ParseOptions(InputMode::Device));
+
+            QGraphicsScene scene;
+            SvgStreamLoader loader(&scene);
+            QEventLoop loop;
+            QElapsedTimer total;
+            QElapsedTimer slice;
+            int slices = 0;
+            double first_slice_ms = 0;
+            double max_slice_ms = 0;
+            QObject::connect(&loader, &SvgStreamLoader::progress, [&](qint64, qint64) {
+                // Slices are scheduled back to back, the gap between them is the slice itself.
+                const double slice_ms = slice.nsecsElapsed() / 1e6;
+                if (slices++ == 0) {
+                    first_slice_ms = total.nsecsElapsed() / 1e6;
+                }
+                max_slice_ms = qMax(max_slice_ms, slice_ms);
+                slice.restart();
+            });
+            QObject::connect(&loader, &SvgStreamLoader::finished, &loop, &QEventLoop::quit);
+            total.start();
+            slice.start();
+            loader.loadFile(path);
+            loop.exec();
+            const double stream_ms = total.nsecsElapsed() / 1e6;
+
+            out << copies << '\t' << data.size() << '\t' << sync_ms << '\t' << stream_ms << '\t'
+                << slices << '\t' << first_slice_ms << '\t' << max_slice_ms << '\n';
+        });
+}
+
+/**
+ * Asynchronous load: latency from the request to the first inserted batch of items (painted in
+ * the next frame) and total time, compared with the synchronous load. Cancel is the time from
+ * canceling until the future finishes, after the first batch (insert) and while the worker
+ * thread is parsing (parse).
+ */
+static void benchAsync(QTextStream &out, const QByteArray &sample, const QString &dir) {
+    out << "# asynchronous load\n";
+    out << "copies\tbytes\tsync_ms\tfirst_batch_ms\ttotal_ms\tcancel_insert_ms"
+           "\tcancel_parse_ms\n";
+    enum Cancel { None, Insert, Parse };
+    bench::forEachScale(
+        out, sample, dir, QStringLiteral("async.svg"), { 16, 64, 256 },
+        [&](int copies, const QByteArray &data, const QString &path) {
+            const double sync_ms = timeParse(path, ParseOptions());
+
+            double first_batch_ms = -1;
+            double total_ms = 0;
+            double cancel_ms[] = { -1, -1, -1 };
+            for (Cancel cancel : { None, Insert, Parse }) {
+                QGraphicsScene scene;
+                QFutureWatcher<SvgDocument> watcher;
+                QEventLoop loop;
+                QElapsedTimer timer;
+                QElapsedTimer canceled;
+                QObject::connect(
+                    &watcher, &QFutureWatcher<SvgDocument>::progressValueChanged, [&] {
+                        if (watcher.progressValue() <= 0 || canceled.isValid()) {
+                            return;
+                        }
+                        if (cancel == Insert) {
+                            canceled.start();
+                            watcher.cancel();
+                        } else if (first_batch_ms < 0) {
+                            first_batch_ms = timer.nsecsElapsed() / 1e6;
+                        }
+                    });
+                QObject::connect(
+                    &watcher, &QFutureWatcher<SvgDocument>::finished, &loop, &QEventLoop::quit);
+                // A quarter of the synchronous load is spent in the middle of the parse.
+                QTimer cancel_timer;
+                cancel_timer.setSingleShot(true);
+                QObject::connect(&cancel_timer, &QTimer::timeout, [&] {
+                    canceled.start();
+                    watcher.cancel();
+                });
+                timer.start();
+                watcher.setFuture(parseAsync(&scene, path));
+                if (cancel == Parse) {
+                    cancel_timer.start(qMax(1, int(sync_ms / 4)));
+                }
+                loop.exec();
+                if (cancel == None) {
+                    total_ms = timer.nsecsElapsed() / 1e6;
+                } else {
+                    cancel_ms[cancel] = canceled.isValid() ? canceled.nsecsElapsed() / 1e6 : -1;
+                }
+            }
+            out << copies << '\t' << data.size() << '\t' << sync_ms << '\t' << first_batch_ms
+                << '\t' << total_ms << '\t' << cancel_ms[Insert] << '\t' << cancel_ms[Parse]
+                << '\n';
+        });
+}
+
+int main(int argc, char *argv[]) {
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+    // Parser debug output would dominate the measurements.
+    QLoggingCategory::setFilterRules(QStringLiteral("svgscene.*=false"));
+    QTextStream out(stdout);
+
+    const bench::SyntheticShape defaults;
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addPositionalArgument(
+        QStringLiteral("sample"), QStringLiteral("Sample document to scale up."));
+    const QCommandLineOption scaling_only(
+        QStringLiteral("scaling-only"), QStringLiteral("Run only the scaling section."));
+    const QCommandLineOption check_readers(
+        QStringLiteral("check-readers"),
+        QStringLiteral("Only check that both readers produce the same trees of the samples."));
+    const QCommandLineOption json(
+        QStringLiteral("json"), QStringLiteral("Write scaling results to <file> as JSON."),
+        QStringLiteral("file"));
+    const QCommandLineOption depth(
+        QStringLiteral("group-depth"), QStringLiteral("Depth of nested groups."),
+        QStringLiteral("n"), QString::number(defaults.groupDepth));
+    const QCommandLineOption text_density(
+        QStringLiteral("text-density"), QStringLiteral("Text elements per path."),
+        QStringLiteral("ratio"), QString::number(defaults.textDensity));
+    const QCommandLineOption transform_density(
+        QStringLiteral("transform-density"),
+        QStringLiteral("Fraction of elements with a transform."), QStringLiteral("ratio"),
+        QString::number(defaults.transformDensity));
+    const QCommandLineOption attributes(
+        QStringLiteral("attributes"), QStringLiteral("Extra attributes per element."),
+        QStringLiteral("n"), QString::number(defaults.attributes));
+    const QCommandLineOption seed(
+        QStringLiteral("seed"), QStringLiteral("Seed of the generator."), QStringLiteral("n"),
+        QString::number(defaults.seed));
+    parser.addOptions({ scaling_only, check_readers, json, depth, text_density, transform_density,
+                        attributes, seed });
+    parser.process(app);
+
+    bench::SyntheticShape shape;
+    shape.groupDepth = parser.value(depth).toInt();
+    shape.textDensity = parser.value(text_density).toDouble();
+    shape.transformDensity = parser.value(transform_density).toDouble();
+    shape.attributes = parser.value(attributes).toInt();
+    shape.seed = parser.value(seed).toUInt();
+
+    if (parser.isSet(check_readers)) {
+        return checkReaders(out) ? 0 : 1;
+    }
+
+    QTemporaryDir dir;
+    bench::benchScaling(out, shape, dir.path(), parser.value(json));
+    if (parser.isSet(scaling_only)) {
+        return 0;
+    }
+
+    const QString sample_path = parser.positionalArguments().value(
+        0, QStringLiteral(SVGSCENE_SAMPLES_DIR "/1.svg"));
+    QFile sample_file(sample_path);
+    if (!sample_file.open(QIODevice::ReadOnly)) {
+        QTextStream(stderr) << "Cannot open sample " << sample_path << '\n';
+        return 1;
+    }
+    const QByteArray sample = sample_file.readAll();
+
+    benchInputModes(out, sample, dir.path());
+    if (!checkReaders(out)) {
+        return 1;
+    }
+    benchReaders(out, sample, dir.path());
+    benchPhases(out, sample, dir.path());
+    bench::benchAllocations(out, sample, dir.path());
+    benchProfile(out, sample, dir.path());
+    benchThreads(out, sample, dir.path());
+    benchPathCache(out, sample, dir.path());
+    benchTransformCache(out, sample, dir.path());
+    benchItemCache(out, sample, dir.path(), PAINT_CACHE);
+    benchItemCache(out, sample, dir.path(), FONT_CACHE);
+    benchCompiled(out, sample, dir.path());
+    benchLazy(out, sample, dir.path());
+    benchReload(out, sample, dir.path());
+    benchStream(out, sample, dir.path());
+    benchAsync(out, sample, dir.path());
+    bench::benchQueries(out, dir.path());
+    bench::benchNumbers(out, sample);
+    bench::benchKeywords(out);
+    return 0;
+}
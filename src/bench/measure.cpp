@@ -0,0 +1,26 @@
+#include "measure.h"
+
+#include <QFile>
+
+namespace bench {
+
+qint64 statusKilobytes(const char *field) {
+    QFile status(QStringLiteral("/proc/self/status"));
+    if (!status.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    const QByteArray prefix = QByteArray(field) + ':';
+    for (QByteArray line = status.readLine(); !line.isEmpty(); line = status.readLine()) {
+        if (line.startsWith(prefix)) {
+            return line.mid(prefix.size()).trimmed().split(' ').value(0).toLongLong();
+        }
+    }
+    return -1;
+}
+
+bool resetPeakMemory() {
+    QFile clear_refs(QStringLiteral("/proc/self/clear_refs"));
+    return clear_refs.open(QIODevice::WriteOnly) && clear_refs.write("5") == 1;
+}
+
+} // namespace bench
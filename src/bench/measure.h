@@ -0,0 +1,88 @@
+/**
+ * Timing and memory measurements shared by the benchmark sections.
+ *
+ * @file
+ */
+#pragma once
+
+#include "generator.h"
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QString>
+#include <QTextStream>
+#include <QtGlobal>
+#include <initializer_list>
+#include <limits>
+
+namespace bench {
+
+/** Runs of each measurement, the best one is reported. */
+const int REPEATS = 3;
+
+/**
+ * Shortest of several measured runs in milliseconds. Only the time between `start` and `stop`
+ * counts, setup and teardown of a run (e.g. of its scene) stay outside.
+ */
+class BestTime {
+public:
+    void start() { m_timer.start(); }
+    void stop() { m_best = qMin(m_best, m_timer.nsecsElapsed() / 1e6); }
+    double ms() const { return m_best; }
+
+private:
+    QElapsedTimer m_timer;
+    double m_best = std::numeric_limits<double>::max();
+};
+
+/** Best of `REPEATS` calls of `run()` in milliseconds. */
+template<typename F>
+double bestOf(F run) {
+    BestTime best;
+    for (int i = 0; i < REPEATS; ++i) {
+        best.start();
+        run();
+        best.stop();
+    }
+    return best.ms();
+}
+
+/**
+ * Calls `section(copies, data, path)` for each number of copies, `data` is the sample scaled up
+ * by `scaleSample` and `path` the temporary file `name` holding it. The output is flushed after
+ * each size.
+ */
+template<typename F>
+void forEachScale(
+    QTextStream &out,
+    const QByteArray &sample,
+    const QString &dir,
+    const QString &name,
+    std::initializer_list<int> copies,
+    F section) {
+    for (int count : copies) {
+        const QByteArray data = scaleSample(sample, count);
+        const QString path = writeTemporary(dir, name, data);
+        section(count, data, path);
+        out.flush();
+    }
+}
+
+/** Variant of the above for the sizes of most sections, 1 to 256 copies. */
+template<typename F>
+void forEachScale(
+    QTextStream &out,
+    const QByteArray &sample,
+    const QString &dir,
+    const QString &name,
+    F section) {
+    forEachScale(out, sample, dir, name, { 1, 16, 64, 256 }, section);
+}
+
+/** Field of `/proc/self/status` in kilobytes, -1 when not available (Linux only). */
+qint64 statusKilobytes(const char *field);
+
+/** Resets the peak resident set size to the current one, false when not supported. */
+bool resetPeakMemory();
+
+} // namespace bench
@@ -0,0 +1,172 @@
+#include "numbers.h"
+
+#include "svgscene/svgnumber.h"
+
+#include <QElapsedTimer>
+#include <QRegularExpression>
+#include <QStringList>
+#include <QVector>
+#include <cstring>
+#include <limits>
+
+namespace bench {
+
+static const int ROUNDS = 20;
+
+static inline bool isDigit(ushort ch) {
+    static quint16 magic = 0x3ff;
+    return ((ch >> 4) == 3) && (magic >> (ch & 15));
+}
+
+/**
+ * Number parser used before `svgnumber.h`, kept as the baseline.
+ */
+static qreal legacyToDouble(const QChar *&str) {
+    const int maxLen = 255; // technically doubles can go til 308+ but whatever
+    char temp[maxLen + 1];
+    int pos = 0;
+    if (*str == QLatin1Char('-')) {
+        temp[pos++] = '-';
+        ++str;
+    } else if (*str == QLatin1Char('+')) {
+        ++str;
+    }
+    while (isDigit(str->unicode()) && pos < maxLen) {
+        temp[pos++] = str->toLatin1();
+        ++str;
+    }
+    if (*str == QLatin1Char('.') && pos < maxLen) {
+        temp[pos++] = '.';
+        ++str;
+    }
+    while (isDigit(str->unicode()) && pos < maxLen) {
+        temp[pos++] = str->toLatin1();
+        ++str;
+    }
+    bool exponent = false;
+    if ((*str == QLatin1Char('e') || *str == QLatin1Char('E')) && pos < maxLen) {
+        exponent = true;
+        temp[pos++] = 'e';
+        ++str;
+        if ((*str == QLatin1Char('-') || *str == QLatin1Char('+')) && pos < maxLen) {
+            temp[pos++] = str->toLatin1();
+            ++str;
+        }
+        while (isDigit(str->unicode()) && pos < maxLen) {
+            temp[pos++] = str->toLatin1();
+            ++str;
+        }
+    }
+    temp[pos] = '\0';
+    qreal val;
+    if (!exponent && pos < 10) {
+        int ival = 0;
+        const char *t = temp;
+        bool neg = false;
+        if (*t == '-') {
+            neg = true;
+            ++t;
+        }
+        while (*t && *t != '.') {
+            ival *= 10;
+            ival += (*t) - '0';
+            ++t;
+        }
+        if (*t == '.') {
+            ++t;
+            int div = 1;
+            while (*t) {
+                ival *= 10;
+                ival += (*t) - '0';
+                div *= 10;
+                ++t;
+            }
+            val = ((qreal)ival) / ((qreal)div);
+        } else {
+            val = ival;
+        }
+        if (neg)
+            val = -val;
+    } else {
+        val = QByteArray::fromRawData(temp, pos).toDouble();
+    }
+    return val;
+}
+
+static inline bool startsNumber(QChar c) {
+    return isDigit(c.unicode()) || c == QLatin1Char('-') || c == QLatin1Char('+')
+           || c == QLatin1Char('.');
+}
+
+/**
+ * Scans the data the way path parsing does and sums all numbers (so the work is not optimized
+ * out). Results are appended to `values`, when given.
+ */
+template<typename Parse>
+static double scan(const QStringList &paths, Parse parse, QVector<double> *values) {
+    double sum = 0;
+    for (const QString &path : paths) {
+        const QChar *str = path.constData();
+        while (!str->isNull()) {
+            if (!startsNumber(*str)) {
+                ++str;
+                continue;
+            }
+            const double value = parse(str);
+            sum += value;
+            if (values) {
+                values->append(value);
+            }
+        }
+    }
+    return sum;
+}
+
+struct Legacy {
+    double operator()(const QChar *&str) const { return legacyToDouble(str); }
+};
+
+struct Kernel {
+    double operator()(const QChar *&str) const { return svgscene::parseNumber(str); }
+};
+
+template<typename Parse>
+static double timeScan(const QStringList &paths, Parse parse) {
+    double best = std::numeric_limits<double>::max();
+    volatile double sink = 0;
+    for (int i = 0; i < ROUNDS; ++i) {
+        QElapsedTimer timer;
+        timer.start();
+        sink = sink + scan(paths, parse, nullptr);
+        best = qMin(best, timer.nsecsElapsed() / 1e6);
+    }
+    return best;
+}
+
+void benchNumbers(QTextStream &out, const QByteArray &sample) {
+    QStringList paths;
+    const QRegularExpression path_data(QStringLiteral("\\sd=\"([^\"]*)\""));
+    auto matches = path_data.globalMatch(QString::fromUtf8(sample));
+    while (matches.hasNext()) {
+        paths.append(matches.next().captured(1));
+    }
+
+    QVector<double> legacy_values;
+    QVector<double> kernel_values;
+    scan(paths, Legacy(), &legacy_values);
+    scan(paths, Kernel(), &kernel_values);
+    int differences = 0;
+    for (int i = 0; i < qMin(legacy_values.size(), kernel_values.size()); ++i) {
+        if (std::memcmp(&legacy_values[i], &kernel_values[i], sizeof(double)) != 0) {
+            ++differences;
+        }
+    }
+
+    out << "# numbers: legacy vs kernel (path data of the sample)\n";
+    out << "numbers\tlegacy_ms\tkernel_ms\tdifferences\n";
+    out << kernel_values.size() << '\t' << timeScan(paths, Legacy()) << '\t'
+        << timeScan(paths, Kernel()) << '\t' << differences << '\n';
+    out.flush();
+}
+
+} // namespace bench
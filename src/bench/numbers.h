@@ -0,0 +1,19 @@
+/**
+ * Micro-benchmark of the number scanning kernel.
+ *
+ * @file
+ */
+#pragma once
+
+#include <QByteArray>
+#include <QTextStream>
+
+namespace bench {
+
+/**
+ * Parses all numbers of the path data found in the sample with the current kernel and with the
+ * previous implementation, reports the time and the number of differing results.
+ */
+void benchNumbers(QTextStream &out, const QByteArray &sample);
+
+} // namespace bench
@@ -0,0 +1,137 @@
+#include "queries.h"
+
+#include "generator.h"
+#include "measure.h"
+#include "svgscene/components/simpletextitem.h"
+#include "svgscene/svghandler.h"
+
+#include <QGraphicsScene>
+#include <QStringList>
+#include <stdexcept>
+
+using namespace svgscene;
+
+namespace bench {
+
+/**
+ * Values of the probes, `misses` of every ten are not present in the document, the others are
+ * taken from the present ones in turn.
+ */
+static QStringList probeValues(const QStringList &present, int count, int misses) {
+    QStringList values;
+    for (int i = 0; i < count; ++i) {
+        if (i % 10 < misses || present.isEmpty()) {
+            values.append(QStringLiteral("missing%1").arg(i));
+        } else {
+            values.append(present.at(i % present.size()));
+        }
+    }
+    return values;
+}
+
+template<typename T>
+static double
+timeFind(SvgDomTree<QGraphicsItem> &root, const QString &name, const QStringList &values) {
+    return bestOf([&] {
+        for (const QString &value : values) {
+            try {
+                root.find<T>(name, value);
+            } catch (const std::out_of_range &) {
+                // The miss being measured.
+            }
+        }
+    });
+}
+
+template<typename T>
+static double timeTryFind(
+    const SvgDomTree<QGraphicsItem> &root,
+    const QString &name,
+    const QStringList &values,
+    int &found) {
+    return bestOf([&] {
+        found = 0;
+        for (const QString &value : values) {
+            if (root.tryFind<T>(name, value) != nullptr) {
+                ++found;
+            }
+        }
+    });
+}
+
+template<typename T>
+static void benchQuery(
+    QTextStream &out,
+    SvgDomTree<QGraphicsItem> &root,
+    const char *query,
+    const QString &name,
+    const QStringList &present,
+    int count) {
+    for (int misses : { 10, 9 }) {
+        const QStringList values = probeValues(present, count, misses);
+        const double find_ms = timeFind<T>(root, name, values);
+        int found = 0;
+        const double try_find_ms = timeTryFind<T>(root, name, values, found);
+        out << query << '\t' << count << '\t' << (count - found) << '\t' << find_ms << '\t'
+            << try_find_ms << '\n';
+        out.flush();
+    }
+}
+
+static double timeSelect(const SvgDomTree<QGraphicsItem> &root, const SvgSelector &selector) {
+    return bestOf([&] {
+        for (int j = 0; j < 20; ++j) {
+            root.selectAll(selector);
+        }
+    });
+}
+
+void benchQueries(QTextStream &out, const QString &dir) {
+    out << "# lookups of missing elements\n";
+    out << "query\tprobes\tmisses\tfind_ms\ttry_find_ms\n";
+    SyntheticShape shape;
+    shape.paths = 2000;
+    shape.attributes = 1;
+    const QString path
+        = writeTemporary(dir, QStringLiteral("queries.svg"), generateSynthetic(shape));
+    QGraphicsScene scene;
+    ParseOptions options;
+    options.indexedSearch = true;
+    const SvgDocument document = parseFromFileName(&scene, path, options);
+    SvgDomTree<QGraphicsItem> root = document.getRoot();
+
+    QStringList ids;
+    for (int i = 0; i < shape.paths; ++i) {
+        ids.append(QStringLiteral("e%1").arg(i));
+    }
+    const QString data = QStringLiteral("data-a0");
+    QStringList text_values;
+    root.forEachMatch<SimpleTextItem>(data, QString(), [&](SimpleTextItem *item) {
+        text_values.append(getXmlAttributeOr(item, data, QString()));
+    });
+    QStringList path_values;
+    root.forEachMatch<QGraphicsPathItem>(data, QString(), [&](QGraphicsPathItem *item) {
+        path_values.append(getXmlAttributeOr(item, data, QString()));
+    });
+
+    benchQuery<QGraphicsItem>(out, root, "id", QStringLiteral("id"), ids, 10000);
+    benchQuery<SimpleTextItem>(out, root, "text", data, text_values, 1000);
+    benchQuery<QGraphicsItem>(out, root, "walk", data, path_values, 200);
+
+    out << "# selectors, compiled once, 20 queries each\n";
+    out << "selector\tmatches\twalk_ms\tindexed_ms\n";
+    // The same root without the index of the document walks the tree.
+    const SvgDomTree<QGraphicsItem> walked(root.getElement());
+    const char *const selectors[] = {
+        "#e100", ".c3", "#g0_1 .c3", "g > text.c5", "svg path[data-a0^='9']",
+    };
+    for (const char *text : selectors) {
+        const SvgSelector selector = SvgSelector::compile(QString::fromLatin1(text));
+        const int matches = root.selectAll(selector).size();
+        out << text << '\t' << matches << '\t' << timeSelect(walked, selector) << '\t'
+            << timeSelect(root, selector) << '\n';
+        out.flush();
+    }
+}
+
+} // namespace bench
@@ -0,0 +1,22 @@
+/**
+ * Lookups of optional elements.
+ *
+ * @file
+ */
+#pragma once
+
+#include <QString>
+#include <QTextStream>
+
+namespace bench {
+
+/**
+ * Probes a synthetic document for elements most of which are missing, by `find` (a miss throws
+ * and unwinds) and by `tryFind`. Probes by id use the index of the document, probes of text items
+ * by a data attribute scan the text items and probes of any element by it walk the tree.
+ *
+ * Then times `selectAll` of compiled selectors with the index of the document and by a walk.
+ */
+void benchQueries(QTextStream &out, const QString &dir);
+
+} // namespace bench
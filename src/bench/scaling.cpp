@@ -0,0 +1,170 @@
+#include "scaling.h"
+
+#include "measure.h"
+#include "svgscene/svghandler.h"
+
+#include <QFile>
+#include <QGraphicsScene>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPainter>
+#include <stdexcept>
+
+using namespace svgscene;
+
+namespace bench {
+
+/** Side of the offscreen image the scene is rendered to. */
+static const int RENDER_SIZE = 1024;
+
+struct ScalingResult {
+    int paths = 0;
+    int elements = 0;
+    int bytes = 0;
+    double parseMs = 0;
+    /** Growth of the peak resident set during one parse, -1 when not measurable. */
+    qint64 peakKb = -1;
+    double findMs = 0;
+    double findAllMs = 0;
+    int findAllCount = 0;
+    /** Searches walking the tree, without the index of the document. */
+    double findWalkMs = 0;
+    double findAllWalkMs = 0;
+    double renderMs = 0;
+};
+
+static ScalingResult measure(const SyntheticShape &shape, const QString &dir) {
+    ScalingResult result;
+    const QByteArray data = generateSynthetic(shape);
+    const QString path = writeTemporary(dir, QStringLiteral("scaling.svg"), data);
+    result.paths = shape.paths;
+    result.bytes = data.size();
+    result.elements = parseTreeFromFileName(path).nodes().size();
+
+    BestTime parse_ms;
+    for (int i = 0; i < REPEATS; ++i) {
+        QGraphicsScene scene;
+        parse_ms.start();
+        parseFromFileName(&scene, path);
+        parse_ms.stop();
+    }
+    result.parseMs = parse_ms.ms();
+
+    QGraphicsScene scene;
+    ParseOptions options;
+    options.indexedSearch = true;
+    const qint64 rss = statusKilobytes("VmRSS");
+    const bool peak_reset = rss >= 0 && resetPeakMemory();
+    const SvgDocument document = parseFromFileName(&scene, path, options);
+    if (peak_reset) {
+        result.peakKb = statusKilobytes("VmHWM") - rss;
+    }
+
+    // The last element is the worst case of the depth-first search.
+    const int elements = shape.paths + int(shape.paths * shape.textDensity);
+    const QString last_id = QStringLiteral("e%1").arg(elements - 1);
+    SvgDomTree<QGraphicsItem> indexed = document.getRoot();
+    SvgDomTree<QGraphicsItem> walked(indexed.getElement());
+    BestTime find_ms[2];
+    BestTime find_all_ms[2];
+    for (int i = 0; i < REPEATS; ++i) {
+        for (SvgDomTree<QGraphicsItem> *tree : { &indexed, &walked }) {
+            const int walk = (tree == &walked);
+            find_ms[walk].start();
+            try {
+                tree->find(QStringLiteral("id"), last_id);
+            } catch (const std::out_of_range &) {
+                // Rounding of the text count, the search has still visited everything.
+            }
+            find_ms[walk].stop();
+            find_all_ms[walk].start();
+            const auto found = tree->findAll(QStringLiteral("class"), QStringLiteral("c3"));
+            find_all_ms[walk].stop();
+            result.findAllCount = found.size();
+        }
+    }
+    result.findMs = find_ms[0].ms();
+    result.findAllMs = find_all_ms[0].ms();
+    result.findWalkMs = find_ms[1].ms();
+    result.findAllWalkMs = find_all_ms[1].ms();
+
+    QImage image(RENDER_SIZE, RENDER_SIZE, QImage::Format_ARGB32_Premultiplied);
+    BestTime render_ms;
+    for (int i = 0; i < REPEATS; ++i) {
+        image.fill(Qt::white);
+        QPainter painter(&image);
+        render_ms.start();
+        scene.render(&painter);
+        painter.end();
+        render_ms.stop();
+    }
+    result.renderMs = render_ms.ms();
+    return result;
+}
+
+static QJsonObject toJson(const SyntheticShape &shape) {
+    QJsonObject json;
+    json.insert(QStringLiteral("groupDepth"), shape.groupDepth);
+    json.insert(QStringLiteral("textDensity"), shape.textDensity);
+    json.insert(QStringLiteral("transformDensity"), shape.transformDensity);
+    json.insert(QStringLiteral("attributes"), shape.attributes);
+    json.insert(QStringLiteral("seed"), double(shape.seed));
+    return json;
+}
+
+static QJsonObject toJson(const ScalingResult &result) {
+    QJsonObject json;
+    json.insert(QStringLiteral("paths"), result.paths);
+    json.insert(QStringLiteral("elements"), result.elements);
+    json.insert(QStringLiteral("bytes"), result.bytes);
+    json.insert(QStringLiteral("parseMs"), result.parseMs);
+    json.insert(QStringLiteral("peakKb"), double(result.peakKb));
+    json.insert(QStringLiteral("findMs"), result.findMs);
+    json.insert(QStringLiteral("findAllMs"), result.findAllMs);
+    json.insert(QStringLiteral("findAllCount"), result.findAllCount);
+    json.insert(QStringLiteral("findWalkMs"), result.findWalkMs);
+    json.insert(QStringLiteral("findAllWalkMs"), result.findAllWalkMs);
+    json.insert(QStringLiteral("renderMs"), result.renderMs);
+    return json;
+}
+
+void benchScaling(
+    QTextStream &out,
+    const SyntheticShape &shape,
+    const QString &dir,
+    const QString &json_path) {
+    out << "# scaling: synthetic documents\n";
+    out << "paths\telements\tbytes\tparse_ms\tpeak_kb\tfind_ms\tfind_all_ms\tfind_all_count"
+           "\tfind_walk_ms\tfind_all_walk_ms\trender_ms\n";
+    QJsonArray results;
+    for (int paths : { 1000, 4000, 16000, 64000 }) {
+        SyntheticShape sized = shape;
+        sized.paths = paths;
+        const ScalingResult result = measure(sized, dir);
+        out << result.paths << '\t' << result.elements << '\t' << result.bytes << '\t'
+            << result.parseMs << '\t' << result.peakKb << '\t' << result.findMs << '\t'
+            << result.findAllMs << '\t' << result.findAllCount << '\t' << result.findWalkMs
+            << '\t' << result.findAllWalkMs << '\t' << result.renderMs << '\n';
+        out.flush();
+        results.append(toJson(result));
+    }
+
+    if (json_path.isEmpty()) {
+        return;
+    }
+    QJsonObject root;
+    root.insert(QStringLiteral("benchmark"), QStringLiteral("scaling"));
+    root.insert(QStringLiteral("qtVersion"), QString::fromLatin1(qVersion()));
+    root.insert(QStringLiteral("shape"), toJson(shape));
+    root.insert(QStringLiteral("results"), results);
+    QFile file(json_path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        QTextStream(stderr) << "Cannot write " << json_path << '\n';
+        return;
+    }
+    file.write(QJsonDocument(root).toJson());
+}
+
+} // namespace bench
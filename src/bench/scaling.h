@@ -0,0 +1,31 @@
+/**
+ * End-to-end scaling of the parser on synthetic documents.
+ *
+ * @file
+ */
+#pragma once
+
+#include "generator.h"
+
+#include <QByteArray>
+#include <QString>
+#include <QTextStream>
+
+namespace bench {
+
+/**
+ * Generates documents of the shape with growing number of paths and measures for each size the
+ * parse time, the peak memory of the parse, latency of `find` (the last element by id) and
+ * `findAll` (a class) with the index of the document and walking the tree, and the offscreen
+ * render time of the scene.
+ *
+ * Results are written as a tab separated section to `out` and, when `json_path` is not empty, as
+ * a JSON document to that file, to track the scaling across releases.
+ */
+void benchScaling(
+    QTextStream &out,
+    const SyntheticShape &shape,
+    const QString &dir,
+    const QString &json_path);
+
+} // namespace bench
@@ -7,4 +7,8 @@ namespace svgscene {
 GroupItem::GroupItem(QGraphicsItem *parent)
 	: Super(parent) {}
 
+int GroupItem::type() const {
+    return Type;
+}
+
 } // namespace svgscene
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "svgscene/svgitemtype.h"
+
 #include <QGraphicsItem>
 
 namespace svgscene {
@@ -8,7 +10,10 @@ class GroupItem : public QGraphicsRectItem {
     using Super = QGraphicsRectItem;
 
 public:
+    enum { Type = int(ItemType::Group) };
+
     explicit GroupItem(QGraphicsItem *parent = nullptr);
+    int type() const override;
 };
 
 } // namespace svgscene
\ No newline at end of file
@@ -9,6 +9,10 @@ namespace svgscene {
 
 HyperlinkItem::HyperlinkItem() = default;
 
+int HyperlinkItem::type() const {
+    return Type;
+}
+
 QString svgscene::HyperlinkItem::getTargetName() const {
     // href attribute is mandatory, therefore using default value
     return getXmlAttributeOr(this, "href", "");
@@ -14,7 +14,10 @@ namespace svgscene {
 class HyperlinkItem : public QObject, public GroupItem {
     Q_OBJECT
 public:
+    enum { Type = int(ItemType::Hyperlink) };
+
     explicit HyperlinkItem();
+    int type() const override;
     QString getTargetName() const;
 
     void mouseDoubleClickEvent(QGraphicsSceneMouseEvent *event) override;
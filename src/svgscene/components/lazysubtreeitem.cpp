@@ -0,0 +1,132 @@
+#include "lazysubtreeitem.h"
+
+#include "utils/logging.h"
+
+#include <QGraphicsScene>
+
+LOG_CATEGORY("svgscene.lazy");
+
+namespace svgscene {
+
+std::atomic<int> LazySubtreeItem::s_pending(0);
+
+LazySubtreeItem::LazySubtreeItem(
+    QSharedPointer<SvgHandler> handler,
+    const SvgTree &tree,
+    int node,
+    const QRectF &bounds,
+    QGraphicsItem *parent)
+    : Super(parent)
+    , m_handler(std::move(handler))
+    , m_tree(tree)
+    , m_node(node)
+    , m_bounds(bounds) {
+    setAcceptedMouseButtons(Qt::NoButton);
+    ++s_pending;
+}
+
+LazySubtreeItem::~LazySubtreeItem() {
+    if (!m_expanded) {
+        --s_pending;
+        // Deleted with its group, the index stops waiting for the subtree.
+        m_handler->m_index->subtreeDropped();
+    }
+}
+
+int LazySubtreeItem::type() const {
+    return Type;
+}
+
+QRectF LazySubtreeItem::boundingRect() const {
+    return m_bounds;
+}
+
+void LazySubtreeItem::paint(
+    QPainter *painter,
+    const QStyleOptionGraphicsItem *option,
+    QWidget *widget) {
+    Q_UNUSED(painter)
+    Q_UNUSED(option)
+    Q_UNUSED(widget)
+    // The scene must not be modified while it is being drawn, new items are painted by the update
+    // they cause.
+    if (!m_expandRequested) {
+        m_expandRequested = true;
+        QMetaObject::invokeMethod(this, "expand", Qt::QueuedConnection);
+    }
+}
+
+void LazySubtreeItem::expand() {
+    materialize();
+    deleteLater();
+}
+
+void LazySubtreeItem::materialize() {
+    if (m_expanded) {
+        return;
+    }
+    m_expanded = true;
+    --s_pending;
+
+    QGraphicsItem *group = parentItem();
+    // Detached first, so that the descendants take its place in the stacking order.
+    setParentItem(nullptr);
+    if (scene()) {
+        scene()->removeItem(this);
+    }
+    if (group) {
+        DEBUG() << "expanding subtree of node" << m_node;
+        m_handler->loadSubtree(m_tree, m_node, group);
+    } else {
+        m_handler->m_index->subtreeDropped();
+    }
+    // Released as soon as possible, the last placeholder owns the handler and the tree.
+    m_handler.reset();
+    m_tree = SvgTree();
+}
+
+void LazySubtreeItem::expandChildren(const QGraphicsItem *parent) {
+    if (parent == nullptr || s_pending == 0) {
+        return;
+    }
+    for (QGraphicsItem *child : parent->childItems()) {
+        if (auto *placeholder = itemCast<LazySubtreeItem>(child)) {
+            placeholder->materialize();
+            delete placeholder;
+        }
+    }
+}
+
+void LazySubtreeItem::expandAll(QGraphicsItem *root) {
+    if (root == nullptr || s_pending == 0) {
+        return;
+    }
+    expandChildren(root);
+    for (QGraphicsItem *child : root->childItems()) {
+        expandAll(child);
+    }
+}
+
+void LazySubtreeItem::expandIn(QGraphicsScene *scene, const QRectF &rect) {
+    bool found = true;
+    while (found && s_pending != 0) {
+        found = false;
+        for (QGraphicsItem *item : scene->items(rect)) {
+            if (auto *placeholder = itemCast<LazySubtreeItem>(item)) {
+                placeholder->materialize();
+                delete placeholder;
+                found = true;
+            }
+        }
+    }
+}
+
+int LazySubtreeItem::pendingCount() {
+    return s_pending;
+}
+
+void expandLazyChildren(const QGraphicsItem *parent) {
+    LazySubtreeItem::expandChildren(parent);
+}
+
+} // namespace svgscene
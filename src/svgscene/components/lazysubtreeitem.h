@@ -0,0 +1,79 @@
+#pragma once
+
+#include "svgscene/svghandler.h"
+#include "svgscene/svgitemtype.h"
+
+#include <QGraphicsObject>
+#include <atomic>
+
+namespace svgscene {
+
+/**
+ * Stands in for the not yet created descendants of a group, see `SvgHandler::setLazy`.
+ *
+ * The placeholder only knows (conservative) bounds of the descendants. It replaces itself with
+ * them, when a view paints it, i.e. its bounds intersect the exposed area, or when a `SvgDomTree`
+ * query descends into the group. The placeholder is deleted after the expansion.
+ */
+class LazySubtreeItem : public QGraphicsObject {
+    Q_OBJECT
+    using Super = QGraphicsObject;
+
+public:
+    enum { Type = int(ItemType::LazySubtree) };
+
+    /**
+     * @param handler   handler creating the descendants, kept alive by the placeholder
+     * @param tree      parsed document
+     * @param node      index of the group element in the tree
+     * @param bounds    bounds of the descendants in coordinates of the group
+     * @param parent    item of the group
+     */
+    LazySubtreeItem(
+        QSharedPointer<SvgHandler> handler,
+        const SvgTree &tree,
+        int node,
+        const QRectF &bounds,
+        QGraphicsItem *parent);
+    ~LazySubtreeItem() override;
+
+    int type() const override;
+
+    QRectF boundingRect() const override;
+    void paint(
+        QPainter *painter,
+        const QStyleOptionGraphicsItem *option,
+        QWidget *widget) override;
+
+    /** Expands placeholders among direct children of the item. */
+    static void expandChildren(const QGraphicsItem *parent);
+    /** Expands all placeholders in the subtree of the item, the subtree is complete afterwards. */
+    static void expandAll(QGraphicsItem *root);
+    /**
+     * Expands placeholders intersecting the rectangle (in scene coordinates), including those
+     * revealed by the expansion. Useful before rendering the scene without a view.
+     */
+    static void expandIn(QGraphicsScene *scene, const QRectF &rect);
+
+    /** Number of placeholders not expanded yet (in all scenes). */
+    static int pendingCount();
+
+public slots:
+    /** Creates the descendants and deletes the placeholder once control returns to the loop. */
+    void expand();
+
+private:
+    /** Creates the descendants and detaches the placeholder from the scene. */
+    void materialize();
+
+    QSharedPointer<SvgHandler> m_handler;
+    SvgTree m_tree;
+    int m_node;
+    QRectF m_bounds;
+    bool m_expandRequested = false;
+    bool m_expanded = false;
+
+    static std::atomic<int> s_pending;
+};
+
+} // namespace svgscene
@@ -1,18 +1,26 @@
 #include "simpletextitem.h"
 
+#include "svgkeywords.h"
+
 #include <QPainter>
 
 namespace svgscene {
 
 SimpleTextItem::SimpleTextItem(const CssAttributes &css, QGraphicsItem *parent)
     : Super(parent) {
-    const QString anchor = css.value(QStringLiteral("text-anchor"));
-    if (anchor == QLatin1String("middle"))
-        m_alignment = Qt::AlignHCenter;
-    else if (anchor == QLatin1String("end"))
-        m_alignment = Qt::AlignRight;
-    else
-        m_alignment = Qt::AlignLeft;
+    switch (findKeyword(css.value(QStringLiteral("text-anchor")))) {
+    case Keyword::Middle: m_alignment = Qt::AlignHCenter; break;
+    case Keyword::End: m_alignment = Qt::AlignRight; break;
+    default: m_alignment = Qt::AlignLeft; break;
+    }
+}
+
+SimpleTextItem::SimpleTextItem(const ComputedStyle &style, QGraphicsItem *parent)
+    : Super(parent)
+    , m_alignment(style->textAnchor) {}
+
+int SimpleTextItem::type() const {
+    return Type;
 }
 
 void SimpleTextItem::setText(const QString& text) {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "svgscene/svghandler.h"
+#include "svgscene/svgitemtype.h"
 
 #include <QGraphicsItem>
 
@@ -10,8 +11,12 @@ class SimpleTextItem : public QGraphicsSimpleTextItem {
     using Super = QGraphicsSimpleTextItem;
 
 public:
+    enum { Type = int(ItemType::SimpleText) };
+
     explicit SimpleTextItem(const CssAttributes &css, QGraphicsItem *parent = nullptr);
+    explicit SimpleTextItem(const ComputedStyle &style, QGraphicsItem *parent = nullptr);
 
+    int type() const override;
     void setText(const QString& text);
     void paint(
         QPainter *painter,
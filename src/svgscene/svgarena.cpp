@@ -0,0 +1,73 @@
+#include "svgarena.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace svgscene {
+
+Arena::Arena(size_t block_size) : m_blockSize(block_size) {}
+
+Arena::~Arena() {
+    release();
+}
+
+void *Arena::allocate(size_t size, size_t alignment) {
+    ++m_allocations;
+    if (m_current >= 0) {
+        const Block &block = m_blocks[m_current];
+        const size_t offset = (m_used + alignment - 1) & ~(alignment - 1);
+        if (offset + size <= block.size) {
+            m_used = offset + size;
+            return block.data + offset;
+        }
+    }
+    // Continue in the next block kept by a rewind, when it is large enough. Otherwise insert a new
+    // one there, the blocks after it stay available.
+    const int next = m_current + 1;
+    if (next >= m_blocks.size() || m_blocks[next].size < size) {
+        const size_t block_size = qMax(m_blockSize, size);
+        // malloc aligns for any fundamental type, the alignment of all types stored here.
+        char *data = static_cast<char *>(std::malloc(block_size));
+        if (data == nullptr) {
+            throw std::bad_alloc();
+        }
+        m_blocks.insert(next, Block { data, block_size });
+        ++m_blocksAllocated;
+    }
+    m_current = next;
+    m_used = size;
+    return m_blocks[next].data;
+}
+
+Arena::Mark Arena::mark() const {
+    Mark mark;
+    mark.block = m_current;
+    mark.used = m_used;
+    return mark;
+}
+
+void Arena::rewind(const Mark &mark) {
+    m_current = mark.block;
+    m_used = mark.used;
+}
+
+void Arena::release() {
+    for (const Block &block : m_blocks) {
+        std::free(block.data);
+    }
+    m_blocks.clear();
+    m_current = -1;
+    m_used = 0;
+    m_allocations = 0;
+    m_blocksAllocated = 0;
+}
+
+quint64 Arena::allocations() const {
+    return m_allocations;
+}
+
+quint64 Arena::blocks() const {
+    return m_blocksAllocated;
+}
+
+} // namespace svgscene
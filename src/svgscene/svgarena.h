@@ -0,0 +1,139 @@
+/**
+ * Arena (bump) allocation of data living only during a parse.
+ *
+ * Parsing creates many short-lived arrays (numbers of a path command, components of a color),
+ * each used to be a separate heap allocation. An arena serves them by moving a pointer in a few
+ * large blocks instead, nothing is freed individually: scopes rewind the arena when their data is
+ * no longer needed and the blocks are reused, `release` returns all of them at once.
+ *
+ * Only trivially destructible types can be stored, destructors are never run.
+ *
+ * @file
+ */
+#pragma once
+
+#include <QVector>
+#include <QtGlobal>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+namespace svgscene {
+
+/**
+ * Bump allocator over a list of blocks. Not thread safe, each thread needs its own arena.
+ */
+class Arena {
+public:
+    /** Position of the arena, see `rewind`. */
+    struct Mark {
+        int block = -1;
+        size_t used = 0;
+    };
+
+    static const size_t DEFAULT_BLOCK_SIZE = 16 * 1024;
+
+    explicit Arena(size_t block_size = DEFAULT_BLOCK_SIZE);
+    ~Arena();
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    /** Uninitialized memory, valid until the arena is rewound before it or released. */
+    void *allocate(size_t size, size_t alignment);
+
+    template<typename T>
+    T *allocate(int count) {
+        static_assert(
+            std::is_trivially_destructible<T>::value, "Arena never runs destructors");
+        return static_cast<T *>(allocate(sizeof(T) * size_t(count), alignof(T)));
+    }
+
+    Mark mark() const;
+    /** Makes the memory allocated since the mark available again, the blocks are kept. */
+    void rewind(const Mark &mark);
+    /** Frees all blocks and resets the counters. */
+    void release();
+
+    /** Number of allocations served, each would be a heap allocation otherwise. */
+    quint64 allocations() const;
+    /** Number of blocks allocated from the heap. */
+    quint64 blocks() const;
+
+private:
+    struct Block {
+        char *data;
+        size_t size;
+    };
+
+    QVector<Block> m_blocks;
+    /** Block being filled, -1 before the first allocation. */
+    int m_current = -1;
+    size_t m_used = 0;
+    size_t m_blockSize;
+    quint64 m_allocations = 0;
+    quint64 m_blocksAllocated = 0;
+};
+
+/**
+ * Rewinds the arena at the end of the scope.
+ */
+class ArenaScope {
+public:
+    explicit ArenaScope(Arena &arena) : m_arena(arena), m_mark(arena.mark()) {}
+    ~ArenaScope() { m_arena.rewind(m_mark); }
+    ArenaScope(const ArenaScope &) = delete;
+    ArenaScope &operator=(const ArenaScope &) = delete;
+
+private:
+    Arena &m_arena;
+    const Arena::Mark m_mark;
+};
+
+/**
+ * Growable array in an arena, replaces `QVarLengthArray` for temporaries of unbounded size. A
+ * grown array leaves its previous buffer in the arena until it is rewound.
+ */
+template<typename T>
+class ArenaArray {
+    static_assert(std::is_trivially_copyable<T>::value, "Elements are moved by memcpy");
+
+public:
+    explicit ArenaArray(Arena &arena, int capacity = 16)
+        : m_arena(arena)
+        , m_data(arena.allocate<T>(capacity))
+        , m_capacity(capacity) {}
+
+    void append(const T &value) {
+        if (m_size == m_capacity) {
+            grow();
+        }
+        m_data[m_size++] = value;
+    }
+
+    void clear() { m_size = 0; }
+    int size() const { return m_size; }
+    int count() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+
+    T *data() { return m_data; }
+    const T *constData() const { return m_data; }
+    T &operator[](int i) { return m_data[i]; }
+    const T &operator[](int i) const { return m_data[i]; }
+    T *begin() { return m_data; }
+    T *end() { return m_data + m_size; }
+
+private:
+    void grow() {
+        T *data = m_arena.allocate<T>(m_capacity * 2);
+        std::memcpy(data, m_data, sizeof(T) * size_t(m_size));
+        m_data = data;
+        m_capacity *= 2;
+    }
+
+    Arena &m_arena;
+    T *m_data;
+    int m_size = 0;
+    int m_capacity;
+};
+
+} // namespace svgscene
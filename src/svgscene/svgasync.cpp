@@ -0,0 +1,119 @@
+#include "svgasync.h"
+
+#include "svghandler.h"
+#include "utils/logging.h"
+
+#include <QElapsedTimer>
+#include <QGraphicsItem>
+#include <QRunnable>
+#include <QThreadPool>
+#include <stdexcept>
+
+LOG_CATEGORY("svgscene.async");
+
+namespace svgscene {
+
+/** Time spent creating items before yielding to the event loop. */
+static const int BATCH_TIME = 10;
+/** Nodes created between checks of the batch time. */
+static const int NODES_PER_CHECK = 256;
+
+QFuture<SvgDocument>
+parseAsync(QGraphicsScene *scene, const QString &filename, const ParseOptions &options) {
+    auto *load = new SvgAsyncLoad(scene, filename, options);
+    return load->start();
+}
+
+class SvgAsyncLoad::ParseTask : public QRunnable {
+public:
+    explicit ParseTask(SvgAsyncLoad *load) : m_load(load) {}
+
+    void run() override { m_load->parseTree(); }
+
+private:
+    SvgAsyncLoad *m_load;
+};
+
+SvgAsyncLoad::SvgAsyncLoad(
+    QGraphicsScene *scene,
+    const QString &filename,
+    const ParseOptions &options)
+    : m_scene(scene)
+    , m_filename(filename)
+    , m_options(options) {}
+
+SvgAsyncLoad::~SvgAsyncLoad() = default;
+
+QFuture<SvgDocument> SvgAsyncLoad::start() {
+    m_interface.reportStarted();
+    QFuture<SvgDocument> future = m_interface.future();
+    // The load is deleted only after the task reports back, the pointer stays valid.
+    QThreadPool::globalInstance()->start(new ParseTask(this));
+    return future;
+}
+
+void SvgAsyncLoad::parseTree() {
+    if (!m_interface.isCanceled()) {
+        ParseOptions options = m_options;
+        const QFutureInterface<SvgDocument> &interface = m_interface;
+        options.isCanceled = [&interface] { return interface.isCanceled(); };
+        m_tree = parseTreeFromFileName(m_filename, options);
+    }
+    // Posting the call publishes the tree to the thread of the load.
+    QMetaObject::invokeMethod(this, "treeReady", Qt::QueuedConnection);
+}
+
+void SvgAsyncLoad::treeReady() {
+    if (m_interface.isCanceled() || !m_scene) {
+        discard();
+        return;
+    }
+    m_handler.reset(new SvgHandler(m_scene));
+    m_handler->setIndexedAttributes(m_options.indexedAttributes);
+    m_handler->setIndexedSearch(m_options.indexedSearch);
+    m_interface.setProgressRange(0, m_tree.nodes().size());
+    insertBatch();
+}
+
+void SvgAsyncLoad::insertBatch() {
+    if (m_interface.isCanceled() || !m_scene) {
+        discard();
+        return;
+    }
+    const int size = m_tree.nodes().size();
+    QElapsedTimer timer;
+    timer.start();
+    do {
+        m_created = qMin(size, m_created + NODES_PER_CHECK);
+        m_handler->loadIncrement(m_tree, m_created, m_created == size);
+    } while (m_created < size && timer.elapsed() < BATCH_TIME);
+    m_interface.setProgressValue(m_created);
+
+    if (m_created < size) {
+        QMetaObject::invokeMethod(this, "insertBatch", Qt::QueuedConnection);
+    } else {
+        finish();
+    }
+}
+
+void SvgAsyncLoad::finish() {
+    try {
+        m_interface.reportResult(m_handler->getDocument());
+    } catch (const std::out_of_range &) {
+        WARN() << "document" << m_filename << "has no root element";
+    }
+    m_interface.reportFinished();
+    deleteLater();
+}
+
+void SvgAsyncLoad::discard() {
+    DEBUG() << "load of" << m_filename << "canceled";
+    if (m_handler && m_scene) {
+        delete m_handler->getRootItem();
+    }
+    m_interface.reportCanceled();
+    m_interface.reportFinished();
+    deleteLater();
+}
+
+} // namespace svgscene
@@ -0,0 +1,96 @@
+/**
+ * Asynchronous loading.
+ *
+ * `parseAsync` reads and decodes the document on a worker thread (see `svgtree.h`) and then
+ * creates the items on the thread of the scene in short batches run from the event loop. The
+ * application stays responsive during the whole load and items are painted as soon as the first
+ * batch is inserted.
+ *
+ * ## Example
+ * ```
+ *  m_load.cancel(); // A different file was opened meanwhile.
+ *  m_load = parseAsync(scene, path);
+ *  auto *watcher = new QFutureWatcher<SvgDocument>(this);
+ *  connect(watcher, &QFutureWatcher<SvgDocument>::finished, this, [this, watcher] {
+ *      if (watcher->future().resultCount() > 0) {
+ *          install(watcher->result());
+ *      }
+ *      watcher->deleteLater();
+ *  });
+ *  watcher->setFuture(m_load);
+ * ```
+ *
+ * @file
+ */
+#pragma once
+
+#include "svgdocument.h"
+#include "svgtree.h"
+
+#include <QFuture>
+#include <QFutureInterface>
+#include <QObject>
+#include <QPointer>
+
+class QGraphicsScene;
+
+namespace svgscene {
+
+class SvgHandler;
+
+/**
+ * Loads the file asynchronously. Must be called from the thread owning the scene.
+ *
+ * Progress of the future counts the nodes of the document whose items were created, the range is
+ * set once the worker thread has parsed the file. Canceling the future stops the load, also in
+ * the middle of the parse on the worker thread, items created so far are deleted. The future
+ * finishes without a result, when it was canceled, the scene was deleted or the document has no
+ * root element.
+ *
+ * @param scene     scene where produced elements will be placed
+ * @param filename  path to a SVG file
+ * @param options   see `ParseOptions`, `lazy` is not used
+ * @return          future of the loaded document
+ */
+QFuture<SvgDocument> parseAsync(
+    QGraphicsScene *scene,
+    const QString &filename,
+    const ParseOptions &options = ParseOptions());
+
+/**
+ * State of a single `parseAsync`, lives in the thread of the scene and deletes itself when done.
+ */
+class SvgAsyncLoad : public QObject {
+    Q_OBJECT
+
+public:
+    SvgAsyncLoad(QGraphicsScene *scene, const QString &filename, const ParseOptions &options);
+    ~SvgAsyncLoad() override;
+
+    /** Starts the parse on the global thread pool. */
+    QFuture<SvgDocument> start();
+
+private slots:
+    /** Called once the tree is parsed. */
+    void treeReady();
+    void insertBatch();
+
+private:
+    class ParseTask;
+
+    /** First phase, runs on the worker thread. */
+    void parseTree();
+    void finish();
+    void discard();
+
+    QPointer<QGraphicsScene> m_scene;
+    QString m_filename;
+    ParseOptions m_options;
+    QFutureInterface<SvgDocument> m_interface;
+    SvgTree m_tree;
+    QSharedPointer<SvgHandler> m_handler;
+    /** Number of nodes whose items were created. */
+    int m_created = 0;
+};
+
+} // namespace svgscene
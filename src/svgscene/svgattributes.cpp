@@ -0,0 +1,220 @@
+#include "svgattributes.h"
+
+#include <algorithm>
+
+namespace svgscene {
+
+static inline ushort codeUnit(QChar c) {
+    return c.unicode();
+}
+
+static inline ushort codeUnit(char c) {
+    return static_cast<uchar>(c);
+}
+
+/**
+ * FNV-1a over code units, identical for an ASCII name in any encoding.
+ */
+template<typename Char>
+static inline uint hashName(const Char *str, int length) {
+    uint hash = 2166136261u;
+    for (int i = 0; i < length; ++i) {
+        hash ^= codeUnit(str[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+template<typename Char>
+static inline bool nameEquals(const QString &name, const Char *str, int length) {
+    if (name.size() != length) {
+        return false;
+    }
+    const QChar *data = name.constData();
+    for (int i = 0; i < length; ++i) {
+        if (data[i].unicode() != codeUnit(str[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+AtomTable::AtomTable() {
+    static const char *const KNOWN_NAMES[] = {
+    #define SVGSCENE_ATOM_NAME(ident, name) name,
+        SVGSPEC_PRESENTATION_ATTRIBUTES(SVGSCENE_ATOM_NAME)
+        SVGSPEC_COMMON_ATTRIBUTES(SVGSCENE_ATOM_NAME)
+    #undef SVGSCENE_ATOM_NAME
+    };
+    static_assert(
+        sizeof(KNOWN_NAMES) / sizeof(KNOWN_NAMES[0]) == atoms::KNOWN_END,
+        "Atom enumeration out of sync with svgspec.h");
+
+    rehash(256);
+    m_names.reserve(atoms::KNOWN_END + 32);
+    m_hashes.reserve(atoms::KNOWN_END + 32);
+    for (const char *name : KNOWN_NAMES) {
+        const QString str = QLatin1String(name);
+        insert(str, hashName(str.constData(), str.size()));
+    }
+}
+
+template<typename Char>
+Atom AtomTable::lookup(const Char *str, int length, uint hash) const {
+    const uint mask = static_cast<uint>(m_slots.size() - 1);
+    for (uint i = hash & mask;; i = (i + 1) & mask) {
+        const Atom slot = m_slots.at(static_cast<int>(i));
+        if (slot == 0) {
+            return atoms::INVALID;
+        }
+        const Atom atom = slot - 1;
+        if (m_hashes.at(static_cast<int>(atom)) == hash
+            && nameEquals(m_names.at(static_cast<int>(atom)), str, length)) {
+            return atom;
+        }
+    }
+}
+
+Atom AtomTable::insert(const QString &name, uint hash) {
+    const auto atom = static_cast<Atom>(m_names.size());
+    m_names.append(name);
+    m_hashes.append(hash);
+    // Keep load factor under 1/2.
+    if (m_names.size() * 2 > m_slots.size()) {
+        rehash(m_slots.size() * 2);
+    } else {
+        const uint mask = static_cast<uint>(m_slots.size() - 1);
+        uint i = hash & mask;
+        while (m_slots.at(static_cast<int>(i)) != 0) {
+            i = (i + 1) & mask;
+        }
+        m_slots[static_cast<int>(i)] = atom + 1;
+    }
+    return atom;
+}
+
+void AtomTable::rehash(int capacity) {
+    m_slots.fill(0, capacity);
+    const uint mask = static_cast<uint>(capacity - 1);
+    for (int atom = 0; atom < m_names.size(); ++atom) {
+        uint i = m_hashes.at(atom) & mask;
+        while (m_slots.at(static_cast<int>(i)) != 0) {
+            i = (i + 1) & mask;
+        }
+        m_slots[static_cast<int>(i)] = static_cast<Atom>(atom) + 1;
+    }
+}
+
+Atom AtomTable::intern(const QStringRef &name) {
+    const uint hash = hashName(name.constData(), name.size());
+    Atom atom = lookup(name.constData(), name.size(), hash);
+    if (atom == atoms::INVALID) {
+        atom = insert(name.toString(), hash);
+    }
+    return atom;
+}
+
+Atom AtomTable::intern(const QString &name) {
+    const uint hash = hashName(name.constData(), name.size());
+    Atom atom = lookup(name.constData(), name.size(), hash);
+    if (atom == atoms::INVALID) {
+        atom = insert(name, hash);
+    }
+    return atom;
+}
+
+Atom AtomTable::intern(const char *name, int length) {
+    const uint hash = hashName(name, length);
+    Atom atom = lookup(name, length, hash);
+    if (atom == atoms::INVALID) {
+        atom = insert(QString::fromLatin1(name, length), hash);
+    }
+    return atom;
+}
+
+Atom AtomTable::find(const QString &name) const {
+    return lookup(name.constData(), name.size(), hashName(name.constData(), name.size()));
+}
+
+Atom AtomTable::find(const QStringRef &name) const {
+    return lookup(name.constData(), name.size(), hashName(name.constData(), name.size()));
+}
+
+const QString &AtomTable::name(Atom atom) const {
+    return m_names.at(static_cast<int>(atom));
+}
+
+int AtomTable::size() const {
+    return m_names.size();
+}
+
+static inline bool atomLess(const Attribute &attr, Atom name) {
+    return attr.name < name;
+}
+
+void AttributeList::insert(Atom name, const QString &value) {
+    auto it = std::lower_bound(m_items.begin(), m_items.end(), name, atomLess);
+    if (it != m_items.end() && it->name == name) {
+        it->value = value;
+    } else {
+        m_items.insert(it, Attribute { name, value });
+    }
+}
+
+void AttributeList::remove(Atom name) {
+    auto it = std::lower_bound(m_items.begin(), m_items.end(), name, atomLess);
+    if (it != m_items.end() && it->name == name) {
+        m_items.erase(it);
+    }
+}
+
+const QString *AttributeList::find(Atom name) const {
+    auto it = std::lower_bound(m_items.cbegin(), m_items.cend(), name, atomLess);
+    if (it != m_items.cend() && it->name == name) {
+        return &it->value;
+    }
+    return nullptr;
+}
+
+bool AttributeList::contains(Atom name) const {
+    return find(name) != nullptr;
+}
+
+QString AttributeList::value(Atom name, const QString &default_value) const {
+    const QString *value = find(name);
+    return value ? *value : default_value;
+}
+
+int AttributeList::size() const {
+    return m_items.size();
+}
+
+bool AttributeList::isEmpty() const {
+    return m_items.isEmpty();
+}
+
+AttributeList::const_iterator AttributeList::begin() const {
+    return m_items.cbegin();
+}
+
+AttributeList::const_iterator AttributeList::end() const {
+    return m_items.cend();
+}
+
+bool AttributeList::operator==(const AttributeList &other) const {
+    return m_items == other.m_items;
+}
+
+bool AttributeList::operator!=(const AttributeList &other) const {
+    return !(*this == other);
+}
+
+QMap<QString, QString> AttributeList::toMap(const AtomTable &table) const {
+    QMap<QString, QString> map;
+    for (const Attribute &attr : m_items) {
+        map.insert(table.name(attr.name), attr.value);
+    }
+    return map;
+}
+
+} // namespace svgscene
@@ -0,0 +1,138 @@
+/**
+ * Interned attribute names and compact per-element attribute storage.
+ *
+ * Attribute names repeat across the whole document (large diagrams contain tens of thousands of
+ * `id`, `style` and `d` attributes), so each distinct name is stored only once in an `AtomTable`
+ * and elements refer to it by a small integer (atom). Names known to the parser (see
+ * `svgspec.h`) have fixed atoms shared by all tables, presentation attributes are numbered first,
+ * so classification is a single comparison.
+ *
+ * @file
+ */
+#pragma once
+
+#include "svgspec.h"
+
+#include <QMap>
+#include <QString>
+#include <QStringRef>
+#include <QVector>
+
+namespace svgscene {
+
+/**
+ * Interned attribute name. Valid only together with the table it was obtained from, unless it is
+ * one of the predefined atoms below.
+ */
+using Atom = quint32;
+
+namespace atoms {
+    #define SVGSCENE_ATOM_ENUMERATOR(ident, name) ident,
+
+    /**
+     * Predefined atoms. Presentation attributes come first, in the order of `svgspec.h`.
+     */
+    enum KnownAtom : Atom {
+        SVGSPEC_PRESENTATION_ATTRIBUTES(SVGSCENE_ATOM_ENUMERATOR)
+        PRESENTATION_END,
+        LAST_PRESENTATION = PRESENTATION_END - 1,
+        SVGSPEC_COMMON_ATTRIBUTES(SVGSCENE_ATOM_ENUMERATOR)
+        KNOWN_END,
+    };
+
+    #undef SVGSCENE_ATOM_ENUMERATOR
+
+    /** Returned by lookups that did not find the name. */
+    constexpr Atom INVALID = ~Atom(0);
+} // namespace atoms
+
+/**
+ * Document-wide table of interned attribute names.
+ *
+ * Lookup does not allocate, it hashes the characters of the name directly (both UTF-16 and
+ * UTF-8/Latin-1 input is supported, the hash is defined on code units so that an ASCII name
+ * yields the same slot in either encoding).
+ */
+class AtomTable {
+public:
+    AtomTable();
+
+    /** Returns atom of the name, registering it, if it is not known yet. */
+    Atom intern(const QStringRef &name);
+    Atom intern(const QString &name);
+    /** Same as above for ASCII names given as raw bytes. */
+    Atom intern(const char *name, int length);
+
+    /** Returns atom of the name or `atoms::INVALID`, never modifies the table. */
+    Atom find(const QString &name) const;
+    Atom find(const QStringRef &name) const;
+
+    /** Name of an atom obtained from this table. */
+    const QString &name(Atom atom) const;
+
+    /** Number of interned names (including predefined ones). */
+    int size() const;
+
+    static inline bool isPresentation(Atom atom) {
+        return atom < atoms::PRESENTATION_END;
+    }
+
+private:
+    template<typename Char>
+    Atom lookup(const Char *str, int length, uint hash) const;
+    Atom insert(const QString &name, uint hash);
+    void rehash(int capacity);
+
+    QVector<QString> m_names;
+    QVector<uint> m_hashes;
+    /** Open addressing table of `atom + 1` (0 marks an empty slot). */
+    QVector<Atom> m_slots;
+};
+
+/**
+ * Single attribute of an element.
+ */
+struct Attribute {
+    Atom name;
+    QString value;
+};
+
+inline bool operator==(const Attribute &a, const Attribute &b) {
+    return a.name == b.name && a.value == b.value;
+}
+
+/**
+ * Attributes of a single element stored as a flat vector sorted by atom.
+ *
+ * Elements usually have only a handful of attributes, so a contiguous vector with binary search
+ * beats a map both in lookup speed and in number of allocations.
+ */
+class AttributeList {
+public:
+    using const_iterator = QVector<Attribute>::const_iterator;
+
+    /** Inserts the value or replaces an existing one. */
+    void insert(Atom name, const QString &value);
+    void remove(Atom name);
+
+    /** Pointer to the stored value or nullptr, when not present. */
+    const QString *find(Atom name) const;
+    bool contains(Atom name) const;
+    QString value(Atom name, const QString &default_value = QString()) const;
+
+    int size() const;
+    bool isEmpty() const;
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    bool operator==(const AttributeList &other) const;
+    bool operator!=(const AttributeList &other) const;
+
+    /** Compatibility conversion to the map based representation. */
+    QMap<QString, QString> toMap(const AtomTable &table) const;
+
+private:
+    QVector<Attribute> m_items;
+};
+
+} // namespace svgscene
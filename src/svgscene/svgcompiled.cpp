@@ -0,0 +1,335 @@
+#include "svgcompiled.h"
+
+#include "utils/logging.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QSaveFile>
+
+LOG_CATEGORY("svgscene.compiled");
+
+namespace svgscene {
+
+/** Magic number of the compiled tree ("SVGT"). */
+static const quint32 TREE_MAGIC = 0x53564754;
+/** Magic number of a cache entry ("SVGC"). */
+static const quint32 ENTRY_MAGIC = 0x53564743;
+/** Increment on every change of the tree, style or serialization. */
+static const quint32 FORMAT_VERSION = 1;
+/** Fixed serialization of Qt types, so that data do not depend on the Qt version in use. */
+static const QDataStream::Version STREAM_VERSION = QDataStream::Qt_5_6;
+
+static void writeAttributes(QDataStream &out, const AttributeList &attributes) {
+    out << quint32(attributes.size());
+    for (const Attribute &attr : attributes) {
+        out << quint32(attr.name) << attr.value;
+    }
+}
+
+static bool readAttributes(QDataStream &in, AttributeList &attributes, int atom_count) {
+    quint32 count;
+    in >> count;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        quint32 name;
+        QString value;
+        in >> name >> value;
+        if (name >= quint32(atom_count)) {
+            return false;
+        }
+        attributes.insert(name, value);
+    }
+    return in.status() == QDataStream::Ok;
+}
+
+static void writeStyle(QDataStream &out, const ComputedStyleData &d) {
+    writeAttributes(out, d.declared);
+    out << quint8(d.fill) << d.fillColor << d.hasFillOpacity << d.fillOpacity
+        << qint32(d.fillRule);
+    out << quint8(d.stroke) << d.strokeColor << d.hasStrokeOpacity << d.strokeOpacity
+        << d.strokeWidth << qint32(d.strokeLinecap) << qint32(d.strokeLinejoin)
+        << d.strokeDashArray << d.hasStrokeDashOffset << d.strokeDashOffset;
+    out << d.fontFamily << quint8(d.fontSizeUnit) << d.fontSize << qint32(d.fontWeight)
+        << qint32(d.fontStretch) << qint32(d.fontStyle) << qint32(d.textAnchor);
+}
+
+static bool readStyle(QDataStream &in, ComputedStyle &style, int atom_count) {
+    ComputedStyleData &d = style.edit();
+    if (!readAttributes(in, d.declared, atom_count)) {
+        return false;
+    }
+    quint8 fill, stroke, font_size_unit;
+    qint32 fill_rule, linecap, linejoin, weight, stretch, font_style, anchor;
+    in >> fill >> d.fillColor >> d.hasFillOpacity >> d.fillOpacity >> fill_rule;
+    in >> stroke >> d.strokeColor >> d.hasStrokeOpacity >> d.strokeOpacity >> d.strokeWidth
+        >> linecap >> linejoin >> d.strokeDashArray >> d.hasStrokeDashOffset
+        >> d.strokeDashOffset;
+    in >> d.fontFamily >> font_size_unit >> d.fontSize >> weight >> stretch >> font_style
+        >> anchor;
+    d.fill = static_cast<PaintType>(fill);
+    d.fillRule = static_cast<Qt::FillRule>(fill_rule);
+    d.stroke = static_cast<PaintType>(stroke);
+    d.strokeLinecap = static_cast<Qt::PenCapStyle>(linecap);
+    d.strokeLinejoin = static_cast<Qt::PenJoinStyle>(linejoin);
+    d.fontSizeUnit = static_cast<FontSizeUnit>(font_size_unit);
+    d.fontWeight = static_cast<QFont::Weight>(weight);
+    d.fontStretch = static_cast<QFont::Stretch>(stretch);
+    d.fontStyle = static_cast<QFont::Style>(font_style);
+    d.textAnchor = Qt::Alignment(QFlag(anchor));
+    return in.status() == QDataStream::Ok;
+}
+
+QDataStream &operator<<(QDataStream &out, const SvgTree &tree) {
+    out << TREE_MAGIC << FORMAT_VERSION;
+
+    const AtomTable &atoms = *tree.m_atoms;
+    out << quint32(atoms::KNOWN_END) << quint32(atoms.size());
+    for (int atom = atoms::KNOWN_END; atom < atoms.size(); ++atom) {
+        out << atoms.name(atom);
+    }
+
+    // Styles are shared by many nodes, each distinct one is written once.
+    QHash<const ComputedStyleData *, quint32> style_index;
+    QVector<const ComputedStyleData *> styles;
+    auto index_of = [&](const ComputedStyle &style) -> quint32 {
+        const ComputedStyleData *data = &style.get();
+        auto it = style_index.constFind(data);
+        if (it != style_index.constEnd()) {
+            return it.value();
+        }
+        const quint32 index = styles.size();
+        style_index.insert(data, index);
+        styles.append(data);
+        return index;
+    };
+    QVector<quint32> node_styles;
+    node_styles.reserve(tree.m_nodes.size() * 2);
+    for (const SvgNode &node : tree.m_nodes) {
+        node_styles.append(index_of(node.style));
+        node_styles.append(index_of(node.ownStyle));
+    }
+    out << quint32(styles.size());
+    for (const ComputedStyleData *style : styles) {
+        writeStyle(out, *style);
+    }
+
+    out << quint32(tree.m_nodes.size());
+    for (int i = 0; i < tree.m_nodes.size(); ++i) {
+        const SvgNode &node = tree.m_nodes.at(i);
+        out << quint8(node.kind) << node.closed << quint32(node.name) << qint32(node.parent)
+            << qint32(node.end) << node_styles.at(2 * i) << node_styles.at(2 * i + 1);
+        writeAttributes(out, node.attributes);
+        out << node.geometry << qint32(node.path) << qint32(node.transform)
+            << qint32(node.text);
+    }
+    out << tree.m_paths << tree.m_transforms << tree.m_texts;
+    return out;
+}
+
+static bool isValidIndex(qint32 index, int size) {
+    return index >= -1 && index < size;
+}
+
+QDataStream &operator>>(QDataStream &in, SvgTree &tree) {
+    tree = SvgTree();
+    auto corrupt = [&in]() -> QDataStream & {
+        in.setStatus(QDataStream::ReadCorruptData);
+        return in;
+    };
+
+    quint32 magic, version;
+    in >> magic >> version;
+    if (magic != TREE_MAGIC || version != FORMAT_VERSION) {
+        return corrupt();
+    }
+
+    quint32 known, atom_count;
+    in >> known >> atom_count;
+    if (known != atoms::KNOWN_END || atom_count < known) {
+        return corrupt();
+    }
+    for (quint32 atom = known; atom < atom_count && in.status() == QDataStream::Ok; ++atom) {
+        QString name;
+        in >> name;
+        // Names are written in the order of interning, so they get the same atoms.
+        if (tree.m_atoms->intern(name) != atom) {
+            return corrupt();
+        }
+    }
+
+    quint32 style_count;
+    in >> style_count;
+    QVector<ComputedStyle> styles;
+    for (quint32 i = 0; i < style_count && in.status() == QDataStream::Ok; ++i) {
+        ComputedStyle style;
+        if (!readStyle(in, style, atom_count)) {
+            return corrupt();
+        }
+        styles.append(style);
+    }
+
+    quint32 node_count;
+    in >> node_count;
+    for (quint32 i = 0; i < node_count && in.status() == QDataStream::Ok; ++i) {
+        SvgNode node;
+        quint8 kind;
+        quint32 name, style, own_style;
+        qint32 parent, end;
+        in >> kind >> node.closed >> name >> parent >> end >> style >> own_style;
+        const bool valid = kind <= quint8(SvgNodeKind::FlowRoot)
+                           && (name < atom_count || name == atoms::INVALID)
+                           && parent >= -1 && parent < qint32(i) && end > qint32(i)
+                           && end <= qint32(node_count) && style < quint32(styles.size())
+                           && own_style < quint32(styles.size());
+        if (!valid || !readAttributes(in, node.attributes, atom_count)) {
+            return corrupt();
+        }
+        node.kind = static_cast<SvgNodeKind>(kind);
+        node.name = name;
+        node.parent = parent;
+        node.end = end;
+        node.style = styles.at(style);
+        node.ownStyle = styles.at(own_style);
+        qint32 path, transform, text;
+        in >> node.geometry >> path >> transform >> text;
+        node.path = path;
+        node.transform = transform;
+        node.text = text;
+        tree.m_nodes.append(node);
+    }
+    in >> tree.m_paths >> tree.m_transforms >> tree.m_texts;
+    if (in.status() != QDataStream::Ok) {
+        return in;
+    }
+
+    for (const SvgNode &node : tree.m_nodes) {
+        if (!isValidIndex(node.path, tree.m_paths.size())
+            || !isValidIndex(node.transform, tree.m_transforms.size())
+            || !isValidIndex(node.text, tree.m_texts.size())) {
+            return corrupt();
+        }
+    }
+    return in;
+}
+
+QByteArray compileTree(const SvgTree &tree) {
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(STREAM_VERSION);
+    out << tree;
+    return data;
+}
+
+bool loadCompiledTree(const QByteArray &data, SvgTree &tree) {
+    QDataStream in(data);
+    in.setVersion(STREAM_VERSION);
+    SvgTree loaded;
+    in >> loaded;
+    if (in.status() != QDataStream::Ok) {
+        return false;
+    }
+    tree = loaded;
+    return true;
+}
+
+CompiledCache::CompiledCache(const QString &directory) : m_directory(directory) {}
+
+SvgTree CompiledCache::load(const QString &filename, const ParseOptions &options) {
+    ParseOptions parse_options = options;
+    parse_options.cacheDirectory.clear();
+
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        WARN() << "Cannot open" << filename;
+        return parseTreeFromFile(&file, parse_options);
+    }
+    const SourceKey key = sourceKey(&file);
+    SvgTree tree;
+    if (find(key, tree)) {
+        DEBUG() << "Using compiled" << filename;
+        return tree;
+    }
+    file.seek(0);
+    tree = parseTreeFromFile(&file, parse_options);
+    if (!options.isCanceled || !options.isCanceled()) {
+        store(key, tree);
+    }
+    return tree;
+}
+
+QString CompiledCache::entryPath(const QString &filename) const {
+    const QString source = QFileInfo(filename).absoluteFilePath();
+    const QByteArray name
+        = QCryptographicHash::hash(source.toUtf8(), QCryptographicHash::Sha1).toHex();
+    return QDir(m_directory).filePath(QString::fromLatin1(name) + QStringLiteral(".svgc"));
+}
+
+CompiledCache::SourceKey CompiledCache::sourceKey(QFile *file) {
+    const QFileInfo info(*file);
+    SourceKey key;
+    key.path = info.absoluteFilePath();
+    key.size = info.size();
+    key.modified = info.lastModified().toMSecsSinceEpoch();
+    SvgInput input(file);
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(input.begin(), static_cast<int>(input.size()));
+    key.hash = hash.result();
+    return key;
+}
+
+bool CompiledCache::find(const SourceKey &key, SvgTree &tree) const {
+    QFile entry(entryPath(key.path));
+    if (!entry.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QDataStream in(&entry);
+    in.setVersion(STREAM_VERSION);
+    quint32 magic, version;
+    SourceKey stored;
+    in >> magic >> version;
+    if (magic != ENTRY_MAGIC || version != FORMAT_VERSION) {
+        DEBUG() << "Compiled entry of other version" << entry.fileName();
+        return false;
+    }
+    in >> stored.path >> stored.size >> stored.modified >> stored.hash;
+    if (in.status() != QDataStream::Ok || stored.path != key.path || stored.size != key.size
+        || stored.modified != key.modified || stored.hash != key.hash) {
+        DEBUG() << "Compiled entry is stale" << entry.fileName();
+        return false;
+    }
+    SvgTree loaded;
+    in >> loaded;
+    if (in.status() != QDataStream::Ok) {
+        WARN() << "Compiled entry is corrupted" << entry.fileName();
+        return false;
+    }
+    tree = loaded;
+    return true;
+}
+
+void CompiledCache::store(const SourceKey &key, const SvgTree &tree) const {
+    if (!QDir().mkpath(m_directory)) {
+        WARN() << "Cannot create cache directory" << m_directory;
+        return;
+    }
+    // Written to a temporary file and renamed, readers never see a partial entry.
+    QSaveFile entry(entryPath(key.path));
+    if (!entry.open(QIODevice::WriteOnly)) {
+        WARN() << "Cannot write compiled entry" << entry.fileName();
+        return;
+    }
+    QDataStream out(&entry);
+    out.setVersion(STREAM_VERSION);
+    out << ENTRY_MAGIC << FORMAT_VERSION;
+    out << key.path << key.size << key.modified << key.hash;
+    out << tree;
+    if (!entry.commit()) {
+        WARN() << "Cannot write compiled entry" << entry.fileName();
+    }
+}
+
+} // namespace svgscene
@@ -0,0 +1,78 @@
+/**
+ * Compiled (binary) form of a parsed document and its on-disk cache.
+ *
+ * The compiled form contains everything the first parse phase produces (see `svgtree.h`): the
+ * element tree, interned names, attributes, computed styles and decoded geometry. Loading it
+ * skips XML, CSS and path parsing entirely, the scene is then created by `materialize`.
+ *
+ * The format is versioned, data of another version are rejected (and recompiled by the cache).
+ *
+ * ## Example
+ * ```
+ *  ParseOptions options;
+ *  options.cacheDirectory = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+ *  SvgDocument document = parseFromFileName(scene, path, options);
+ * ```
+ *
+ * @file
+ */
+#pragma once
+
+#include "svgtree.h"
+
+#include <QByteArray>
+#include <QString>
+
+namespace svgscene {
+
+/** Serializes the tree to the compiled form. */
+QByteArray compileTree(const SvgTree &tree);
+
+/**
+ * Restores a tree from the compiled form.
+ *
+ * @return  false, when the data are corrupted or of another format version
+ */
+bool loadCompiledTree(const QByteArray &data, SvgTree &tree);
+
+/**
+ * Directory of compiled documents.
+ *
+ * Entries are keyed by the absolute path of the source file. An entry is used only when the size,
+ * modification time and content hash of the source still match, otherwise the source is parsed
+ * and the entry replaced. Failures of the cache are logged and never prevent the parse.
+ */
+class CompiledCache {
+public:
+    /**
+     * @param directory     created when missing
+     */
+    explicit CompiledCache(const QString &directory);
+
+    /**
+     * Tree of the file, loaded from the cache when fresh, parsed (and stored) otherwise.
+     *
+     * @param filename  path to a SVG file
+     * @param options   parse options used when the cache entry is missing or stale
+     */
+    SvgTree load(const QString &filename, const ParseOptions &options = ParseOptions());
+
+    /** Path of the cache entry of a source file. */
+    QString entryPath(const QString &filename) const;
+
+private:
+    struct SourceKey {
+        QString path;
+        qint64 size = -1;
+        qint64 modified = 0;
+        QByteArray hash;
+    };
+
+    static SourceKey sourceKey(QFile *file);
+    bool find(const SourceKey &key, SvgTree &tree) const;
+    void store(const SourceKey &key, const SvgTree &tree) const;
+
+    QString m_directory;
+};
+
+} // namespace svgscene
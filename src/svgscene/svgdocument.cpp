@@ -1,11 +1,34 @@
 #include "svgdocument.h"
 
+#include "svghandler.h"
+
+#include <utility>
+
 namespace svgscene {
 
 SvgDomTree<QGraphicsItem> SvgDocument::getRoot() const {
     return root;
 }
 
-SvgDocument::SvgDocument(QGraphicsItem *root) : root(root) {}
+SvgDocument::SvgDocument(
+    QGraphicsItem *root,
+    QSharedPointer<SvgHandler> handler,
+    QSharedPointer<const SvgIndex> index)
+    : root(root, std::move(index))
+    , handler(std::move(handler)) {}
+
+QSharedPointer<SvgHandler> SvgDocument::getHandler() const {
+    return handler;
+}
+
+ParseStats SvgDocument::getStats() const {
+    return handler ? handler->getStats() : ParseStats();
+}
+
+void SvgDocument::rebuildIndex() const {
+    if (handler) {
+        handler->reindexItems();
+    }
+}
 
 } // namespace svgscene
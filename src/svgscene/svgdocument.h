@@ -1,10 +1,14 @@
 /**
  * Entrypoint to SVG dom.
  *
- * Basic implementation only contains only a root subtree of the DOM, however more advanced
- * implementations may contain extra functionalities, such as hashmaps by `id`, `class` or other
- * attributes to speedup the search. The document should then override the search functions (this
- * behavior is not implemented).
+ * The document contains a root subtree of the DOM. Documents parsed with
+ * `ParseOptions::indexedSearch` also have indexes of the elements by `id`, `class` and other
+ * configured attributes (see `svgindex.h`). Trees obtained from such a document carry the index,
+ * their searches by an indexed attribute look the value up instead of walking the tree. Searches
+ * for a class of items (e.g. `findAll<HyperlinkItem>()`) scan the items of the class listed by
+ * the index, see `svgitemtype.h`. The index refers to the created items: searches reject the
+ * entries of items deleted by the application, but they get slower until
+ * `SvgDocument::rebuildIndex` is called.
  *
  * ## Document traversing API
  * The key component of the API is SvgDomTree, which wraps the QGraphicsItems inSVG aware wrapper
@@ -16,16 +20,38 @@
  * optional. The default value for the template parameter is QGraphicsItem. The wrapped Qt object
  * can be obtained by a call to the getElement method.
  *
+ * ## Queries without exceptions for misses
+ * `find` throws, when nothing is found. `tryFind`, `findFirst` and `forEachMatch` report misses by
+ * their result instead and do not construct SvgDomTrees, which makes probing for optional
+ * elements cheap (and possible where exceptions are not, e.g. WASM). They are not `noexcept`:
+ * searching a lazily materialized subtree expands it, which allocates and calls the handler hooks.
+ *
+ * ## Selectors
+ * `select` and `selectAll` search by a compiled selector (see `svgselector.h`), e.g.
+ * `#cache > g text.value`. Compile the selector once and reuse it, candidates are taken from the
+ * index of the document when the last part of the selector has an indexed attribute.
+ *
  * @file
  */
 #pragma once
 
+#include "svgindex.h"
 #include "svgmetadata.h"
+#include "svgselector.h"
+#include "svgstats.h"
 
 #include <QGraphicsItem>
+#include <QSharedPointer>
+#include <QVector>
+#include <utility>
 
 namespace svgscene {
 
+class SvgHandler;
+
+template<typename T>
+class SvgDomMatch;
+
 /**
  * A tree of SVG DOM where each child node can form subtree. This allows chaining of traverse
  * operations.
@@ -34,7 +60,13 @@ namespace svgscene {
 template<typename TT>
 class SvgDomTree {
 public:
-    explicit SvgDomTree(QGraphicsItem *root);
+    /**
+     * @param index  index of the document the item belongs to, searches without it (or by
+     *               attributes it does not cover) walk the tree
+     */
+    explicit SvgDomTree(
+        QGraphicsItem *root,
+        QSharedPointer<const SvgIndex> index = QSharedPointer<const SvgIndex>());
 
     /**
      * Unwrap the element from tree. See `find` method example.
@@ -73,6 +105,10 @@ public:
      *
      * **IMPORTANT:** If attribute name is empty, attribute value is not evaluated at all.
      *
+     * **IMPORTANT:** After items of an indexed document (`ParseOptions::indexedSearch`) were
+     * deleted, its trees should not be searched before `SvgDocument::rebuildIndex`. Entries of the
+     * deleted items are rejected, at the cost of checking each found item.
+     *
      * @tparam T          type of element to search, QGraphicsItem corresponds to ANY
      * @param attr_name   required attribute name, empty string corresponds to ANT
      * @param attr_value  required attribute value, empty string corresponds to ANY
@@ -96,6 +132,8 @@ public:
      *
      * **IMPORTANT:** If attribute name is empty, attribute value is not evaluated at all.
      *
+     * **IMPORTANT:** Like `find`, indexed documents must be rebuilt after items were deleted.
+     *
      * @tparam T          type of element to search, QGraphicsItem corresponds to ANY
      * @param attr_name   required attribute name, empty string corresponds to ANT
      * @param attr_value  required attribute value, empty string corresponds to ANY
@@ -112,6 +150,59 @@ public:
     QList<SvgDomTree<T>>
     findAll(const QString &attr_name = QString(), const QString &attr_value = QString());
 
+    /**
+     * Variant of `find` reporting a missing element as nullptr instead of throwing, returns the
+     * first match in document order. Elements without svgscene metadata do not match (`find`
+     * throws on them). The search may still throw what the expansion of a lazily materialized
+     * subtree throws, e.g. `std::bad_alloc` or an exception of an overridden handler hook.
+     */
+    template<typename T = QGraphicsItem>
+    T *tryFind(const QString &attr_name = QString(), const QString &attr_value = QString())
+        const;
+
+    /**
+     * Like `tryFind`, the match keeps the index of the document and can be searched further.
+     * Searches of an empty match find nothing, so probes can be chained without checks.
+     *
+     * ## Example
+     * ```
+     *  auto label = document.getRoot().findFirst("id", "cache").findFirst<SimpleTextItem>();
+     *  if (label) {
+     *    label->setText("hit");
+     *  }
+     * ```
+     */
+    template<typename T = QGraphicsItem>
+    SvgDomMatch<T>
+    findFirst(const QString &attr_name = QString(), const QString &attr_value = QString())
+        const;
+
+    /**
+     * Calls `callback(T *)` for every match in document order. Does not throw by itself, elements
+     * without svgscene metadata do not match.
+     */
+    template<typename T = QGraphicsItem, typename F>
+    void forEachMatch(const QString &attr_name, const QString &attr_value, F callback) const;
+
+    /**
+     * All descendants matching the selector in document order. Like `querySelectorAll`, the
+     * ancestors in the selector may lie outside of the subtree. Nothing for an invalid selector.
+     *
+     * ## Example
+     * ```
+     *  static const SvgSelector VALUES = SvgSelector::compile("#registers text.value");
+     *  for (auto value : document.getRoot().selectAll<SimpleTextItem>(VALUES)) {
+     *    ...
+     *  }
+     * ```
+     */
+    template<typename T = QGraphicsItem>
+    QList<SvgDomTree<T>> selectAll(const SvgSelector &selector) const;
+
+    /** First match of `selectAll`, empty when there is none (does not throw for that). */
+    template<typename T = QGraphicsItem>
+    SvgDomMatch<T> select(const SvgSelector &selector) const;
+
 protected:
     /**
      * Alternative find method using `nullptr` as failure reporting mechanism and skips
@@ -131,22 +222,165 @@ protected:
         const QString &attr_name = QString(),
         const QString &attr_value = QString());
 
+    /**
+     * Variant of the above sharing one resolved query for the whole search.
+     */
+    template<typename T>
+    static T *findFromParentRaw(const QGraphicsItem *parent, const AttributeQuery &query);
+
+    /**
+     * Appends all matching descendants of parent (in depth-first order) to the list.
+     */
+    template<typename T>
+    static void findAllFromParentRaw(
+        const QGraphicsItem *parent,
+        const AttributeQuery &query,
+        QList<SvgDomTree<T>> &found);
+
+    /** Items with the attribute from the index, null when the search has to walk the tree. */
+    static const QVector<SvgIndex::Entry> *
+    indexed(const SvgIndex *index, const QString &attr_name, const QString &attr_value);
+
+    /**
+     * Items of class T from the index, false when the search has to walk the tree. Only the item
+     * classes of svgscene are taken from the index (see `SvgsceneItem`), items of Qt classes may
+     * have been added by the application and searches for them (or for any item) walk the tree.
+     */
+    template<typename T>
+    static bool indexedKind(const SvgIndex *index, QVector<SvgIndex::Entry> &entries);
+
+    /**
+     * Calls `visitor(T *)` for the matching descendants of root in document order, until it
+     * returns false. Uses the index (may be null) like `find`, never throws by itself.
+     *
+     * @return  false, when stopped by the visitor
+     */
+    template<typename T, typename F>
+    static bool visitMatches(
+        const QGraphicsItem *root,
+        const SvgIndex *index,
+        const QString &attr_name,
+        const QString &attr_value,
+        F &visitor);
+
+    /**
+     * Like `visitMatches`, for the descendants matching the selector. Candidates come from the
+     * selector, then from the items of class T, otherwise the tree is walked.
+     */
+    template<typename T, typename F>
+    static bool visitSelected(
+        const QGraphicsItem *root,
+        const SvgIndex *index,
+        const SvgSelector &selector,
+        F &visitor);
+
+    /** Tree walk of `visitMatches`, visits items of class T accepted by `predicate(item)`. */
+    template<typename T, typename P, typename F>
+    static bool visitChildren(const QGraphicsItem *parent, P &predicate, F &visitor);
+
+    /** First match of `visitMatches` or nullptr. */
+    template<typename T>
+    static T *firstMatch(
+        const QGraphicsItem *root,
+        const SvgIndex *index,
+        const QString &attr_name,
+        const QString &attr_value);
+
 protected:
+    template<typename>
+    friend class SvgDomTree;
+    template<typename>
+    friend class SvgDomMatch;
+
     TT *root;
+    QSharedPointer<const SvgIndex> index;
+};
+
+/**
+ * Result of `SvgDomTree::findFirst`, an element or nothing.
+ */
+template<typename T>
+class SvgDomMatch {
+public:
+    SvgDomMatch() = default;
+    SvgDomMatch(T *element, QSharedPointer<const SvgIndex> index);
+
+    explicit operator bool() const;
+    bool isEmpty() const;
+    /** The element or nullptr. */
+    T *getElement() const;
+    T *operator->() const;
+    /** Tree of the element, the match must not be empty. */
+    SvgDomTree<T> toTree() const;
+
+    /** See `SvgDomTree::tryFind`, nullptr for an empty match. */
+    template<typename U = QGraphicsItem>
+    U *tryFind(const QString &attr_name = QString(), const QString &attr_value = QString())
+        const;
+
+    /** See `SvgDomTree::findFirst`, empty for an empty match. */
+    template<typename U = QGraphicsItem>
+    SvgDomMatch<U>
+    findFirst(const QString &attr_name = QString(), const QString &attr_value = QString())
+        const;
+
+private:
+    T *element = nullptr;
+    QSharedPointer<const SvgIndex> index;
 };
 
 /**
  * Simplest implementation of an SVG document. See file description for more details.
+ *
+ * Documents parsed with `ParseOptions::indexedSearch` refer to their items from the index, the
+ * application should call `rebuildIndex` after deleting any of them.
  */
 class SvgDocument {
 public:
-    explicit SvgDocument(QGraphicsItem *root);
+    explicit SvgDocument(
+        QGraphicsItem *root,
+        QSharedPointer<SvgHandler> handler = QSharedPointer<SvgHandler>(),
+        QSharedPointer<const SvgIndex> index = QSharedPointer<const SvgIndex>());
     SvgDomTree<QGraphicsItem> getRoot() const;
 
+    /**
+     * Handler which created the items, null when it was not owned by a `QSharedPointer`. It keeps
+     * the parsed tree to allow `reloadFromFileName`.
+     */
+    QSharedPointer<SvgHandler> getHandler() const;
+
+    /**
+     * Statistics of the parse (see `svgstats.h`), including the profile when it was parsed with
+     * `ParseOptions::profile`. Empty without a handler.
+     *
+     * ## Example
+     * ```
+     *  ParseOptions options;
+     *  options.profile = true;
+     *  auto document = parseFromFileName(scene, filename, options);
+     *  telemetry.send(document.getStats().toJson(QJsonDocument::Compact));
+     * ```
+     */
+    ParseStats getStats() const;
+
+    /**
+     * Indexes the items present in the document again, so that searches do not have to reject
+     * deleted ones (see `ParseOptions::indexedSearch`). Items deleted since are also forgotten by
+     * `reloadFromFileName`. Does nothing without a handler.
+     */
+    void rebuildIndex() const;
+
 protected:
     SvgDomTree<QGraphicsItem> root;
+    QSharedPointer<SvgHandler> handler;
 };
 
+/**
+ * Creates children of the item deferred by lazy materialization (see `SvgHandler::setLazy`).
+ * Searches call it before descending into an item.
+ */
+void expandLazyChildren(const QGraphicsItem *parent);
+
 // IMPLEMENTATION OF TEMPLATE FUNCTIONS BELLOW
 
 template<typename T>
@@ -157,19 +391,13 @@ bool itemMatchesSelector(
     if (item == nullptr) {
         throw std::out_of_range("Supplied item is nullptr.");
     }
-    if (attr_name.isEmpty()) {
-        return true;
-    }
-
-    auto attrs = getXmlAttributes(item);
-    if (!attrs.contains(attr_name)) {
-        return false;
-    }
-    return attr_value.isEmpty() || attrs.value(attr_name) == attr_value;
+    return AttributeQuery(attr_name, attr_value).matches(item);
 }
 
 template<typename T>
-SvgDomTree<T>::SvgDomTree(QGraphicsItem *root) : root(dynamic_cast<T *>(root)) {
+SvgDomTree<T>::SvgDomTree(QGraphicsItem *root, QSharedPointer<const SvgIndex> index)
+    : root(itemCast<T>(root))
+    , index(std::move(index)) {
     if (this->root == nullptr) {
         throw std::out_of_range("Cannot build dom tree with nullptr item.");
     }
@@ -182,8 +410,7 @@ TT *SvgDomTree<TT>::getElement() const {
 
 template<typename T>
 QString SvgDomTree<T>::getAttrValueOr(const QString &attr_name, const QString &default_value) {
-    XmlAttributes attrs = getXmlAttributes(root);
-    return attrs.value(attr_name, default_value);
+    return getXmlAttributeOr(root, attr_name, default_value);
 }
 
 template<typename T>
@@ -199,20 +426,34 @@ SvgDomTree<T> SvgDomTree<TT>::find(const QString &attr_name, const QString &attr
         throw std::out_of_range("Current element is nullptr.");
     }
 
-    for (QGraphicsItem *_child : root->childItems()) {
-        if (T *child = dynamic_cast<T *>(_child)) {
-            if (itemMatchesSelector<T>(child, attr_name, attr_value)) {
-                return SvgDomTree<T>(child);
+    if (const QVector<SvgIndex::Entry> *entries = indexed(index.data(), attr_name, attr_value)) {
+        for (const SvgIndex::Entry &entry : *entries) {
+            T *found = index->isUnder(entry, root) ? itemCast<T>(entry.item) : nullptr;
+            if (found != nullptr) {
+                return SvgDomTree<T>(found, index);
             }
         }
+        throw std::out_of_range("Not found.");
+    }
 
-        T *found = findFromParentRaw<T>(_child, attr_name, attr_value);
-        if (found != nullptr) {
-            return SvgDomTree<T>(found);
+    QVector<SvgIndex::Entry> entries;
+    if (indexedKind<T>(index.data(), entries)) {
+        const AttributeQuery query(attr_name, attr_value);
+        for (const SvgIndex::Entry &entry : entries) {
+            if (index->isUnder(entry, root) && query.matches(entry.item)) {
+                return SvgDomTree<T>(entry.item, index);
+            }
         }
+        throw std::out_of_range("Not found.");
     }
-    throw std::out_of_range("Not found.");
+
+    T *found = findFromParentRaw<T>(root, AttributeQuery(attr_name, attr_value));
+    if (found == nullptr) {
+        throw std::out_of_range("Not found.");
+    }
+    return SvgDomTree<T>(found, index);
 }
+
 template<typename TT>
 template<typename T>
 QList<SvgDomTree<T>> SvgDomTree<TT>::findAll(const QString &attr_name, const QString &attr_value) {
@@ -222,34 +463,229 @@ QList<SvgDomTree<T>> SvgDomTree<TT>::findAll(const QString &attr_name, const QSt
         return ret;
     }
 
-    for (QGraphicsItem *_child : root->childItems()) {
-        if (T *child = dynamic_cast<T *>(_child)) {
-            if (itemMatchesSelector<T>(child, attr_name, attr_value)) {
-                ret.append(SvgDomTree(child));
+    if (const QVector<SvgIndex::Entry> *entries = indexed(index.data(), attr_name, attr_value)) {
+        for (const SvgIndex::Entry &entry : *entries) {
+            T *found = index->isUnder(entry, root) ? itemCast<T>(entry.item) : nullptr;
+            if (found != nullptr) {
+                ret.append(SvgDomTree<T>(found, index));
             }
         }
-        ret.append(SvgDomTree(_child).findAll(_child, attr_name, attr_value));
+        return ret;
+    }
+
+    QVector<SvgIndex::Entry> entries;
+    if (indexedKind<T>(index.data(), entries)) {
+        const AttributeQuery query(attr_name, attr_value);
+        for (const SvgIndex::Entry &entry : entries) {
+            if (index->isUnder(entry, root) && query.matches(entry.item)) {
+                ret.append(SvgDomTree<T>(entry.item, index));
+            }
+        }
+        return ret;
+    }
+
+    findAllFromParentRaw<T>(root, AttributeQuery(attr_name, attr_value), ret);
+    for (SvgDomTree<T> &tree : ret) {
+        tree.index = index;
     }
     return ret;
 }
 
+template<typename TT>
+template<typename T>
+T *SvgDomTree<TT>::tryFind(const QString &attr_name, const QString &attr_value) const {
+    return firstMatch<T>(root, index.data(), attr_name, attr_value);
+}
+
+template<typename TT>
+template<typename T>
+SvgDomMatch<T>
+SvgDomTree<TT>::findFirst(const QString &attr_name, const QString &attr_value) const {
+    return SvgDomMatch<T>(firstMatch<T>(root, index.data(), attr_name, attr_value), index);
+}
+
+template<typename TT>
+template<typename T, typename F>
+void SvgDomTree<TT>::forEachMatch(
+    const QString &attr_name,
+    const QString &attr_value,
+    F callback) const {
+    auto visitor = [&callback](T *item) -> bool {
+        callback(item);
+        return true;
+    };
+    visitMatches<T>(root, index.data(), attr_name, attr_value, visitor);
+}
+
+template<typename TT>
+template<typename T>
+QList<SvgDomTree<T>> SvgDomTree<TT>::selectAll(const SvgSelector &selector) const {
+    QList<SvgDomTree<T>> ret;
+    const QSharedPointer<const SvgIndex> &document_index = index;
+    auto collect = [&ret, &document_index](T *item) -> bool {
+        ret.append(SvgDomTree<T>(item, document_index));
+        return true;
+    };
+    visitSelected<T>(root, index.data(), selector, collect);
+    return ret;
+}
+
+template<typename TT>
+template<typename T>
+SvgDomMatch<T> SvgDomTree<TT>::select(const SvgSelector &selector) const {
+    T *found = nullptr;
+    auto first = [&found](T *item) -> bool {
+        found = item;
+        return false;
+    };
+    visitSelected<T>(root, index.data(), selector, first);
+    return SvgDomMatch<T>(found, index);
+}
+
+template<typename TT>
+const QVector<SvgIndex::Entry> *SvgDomTree<TT>::indexed(
+    const SvgIndex *index,
+    const QString &attr_name,
+    const QString &attr_value) {
+    if (!index || attr_name.isEmpty()) {
+        return nullptr;
+    }
+    return index->find(attr_name, attr_value);
+}
+
+template<typename TT>
+template<typename T>
+bool SvgDomTree<TT>::indexedKind(const SvgIndex *index, QVector<SvgIndex::Entry> &entries) {
+    if (!index || !SvgsceneItem<T>::value) {
+        return false;
+    }
+    return index->findKind<T>(entries);
+}
+
+template<typename TT>
+template<typename T, typename F>
+bool SvgDomTree<TT>::visitMatches(
+    const QGraphicsItem *root,
+    const SvgIndex *index,
+    const QString &attr_name,
+    const QString &attr_value,
+    F &visitor) {
+    if (const QVector<SvgIndex::Entry> *entries = indexed(index, attr_name, attr_value)) {
+        for (const SvgIndex::Entry &entry : *entries) {
+            T *found = index->isUnder(entry, root) ? itemCast<T>(entry.item) : nullptr;
+            if (found != nullptr && !visitor(found)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const AttributeQuery query(attr_name, attr_value);
+    QVector<SvgIndex::Entry> entries;
+    if (indexedKind<T>(index, entries)) {
+        for (const SvgIndex::Entry &entry : entries) {
+            if (index->isUnder(entry, root) && query.tryMatches(entry.item)
+                && !visitor(itemCast<T>(entry.item))) {
+                return false;
+            }
+        }
+        return true;
+    }
+    auto matches = [&query](const QGraphicsItem *item) { return query.tryMatches(item); };
+    return visitChildren<T>(root, matches, visitor);
+}
+
+template<typename TT>
+template<typename T, typename F>
+bool SvgDomTree<TT>::visitSelected(
+    const QGraphicsItem *root,
+    const SvgIndex *index,
+    const SvgSelector &selector,
+    F &visitor) {
+    if (!selector.isValid()) {
+        return true;
+    }
+
+    if (const QVector<SvgIndex::Entry> *entries = selector.candidates(index)) {
+        for (const SvgIndex::Entry &entry : *entries) {
+            T *found = index->isUnder(entry, root) ? itemCast<T>(entry.item) : nullptr;
+            if (found != nullptr && selector.matches(entry.item) && !visitor(found)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    QVector<SvgIndex::Entry> entries;
+    if (indexedKind<T>(index, entries)) {
+        for (const SvgIndex::Entry &entry : entries) {
+            if (index->isUnder(entry, root) && selector.matches(entry.item)
+                && !visitor(itemCast<T>(entry.item))) {
+                return false;
+            }
+        }
+        return true;
+    }
+    auto matches = [&selector](const QGraphicsItem *item) { return selector.matches(item); };
+    return visitChildren<T>(root, matches, visitor);
+}
+
+template<typename TT>
+template<typename T, typename P, typename F>
+bool SvgDomTree<TT>::visitChildren(const QGraphicsItem *parent, P &predicate, F &visitor) {
+    expandLazyChildren(parent);
+    for (QGraphicsItem *_child : parent->childItems()) {
+        T *child = itemCast<T>(_child);
+        if (child != nullptr && predicate(_child) && !visitor(child)) {
+            return false;
+        }
+        if (!visitChildren<T>(_child, predicate, visitor)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename TT>
+template<typename T>
+T *SvgDomTree<TT>::firstMatch(
+    const QGraphicsItem *root,
+    const SvgIndex *index,
+    const QString &attr_name,
+    const QString &attr_value) {
+    T *found = nullptr;
+    auto first = [&found](T *item) -> bool {
+        found = item;
+        return false;
+    };
+    visitMatches<T>(root, index, attr_name, attr_value, first);
+    return found;
+}
+
 template<typename TT>
 template<typename T>
 T *SvgDomTree<TT>::findFromParentRaw(
     const QGraphicsItem *parent,
     const QString &attr_name,
     const QString &attr_value) {
+    return findFromParentRaw<T>(parent, AttributeQuery(attr_name, attr_value));
+}
+
+template<typename TT>
+template<typename T>
+T *SvgDomTree<TT>::findFromParentRaw(const QGraphicsItem *parent, const AttributeQuery &query) {
     if (!parent) {
         return nullptr;
     }
 
+    expandLazyChildren(parent);
     for (QGraphicsItem *_child : parent->childItems()) {
-        if (T *child = dynamic_cast<T *>(_child)) {
-            if (itemMatchesSelector(child, attr_name, attr_value)) {
+        if (T *child = itemCast<T>(_child)) {
+            if (query.matches(child)) {
                 return child;
             }
         }
-        T *found = findFromParentRaw(_child, attr_name, attr_value);
+        T *found = findFromParentRaw<T>(_child, query);
         if (found != nullptr) {
             return found;
         }
@@ -257,4 +693,67 @@ T *SvgDomTree<TT>::findFromParentRaw(
     return nullptr;
 }
 
+template<typename TT>
+template<typename T>
+void SvgDomTree<TT>::findAllFromParentRaw(
+    const QGraphicsItem *parent,
+    const AttributeQuery &query,
+    QList<SvgDomTree<T>> &found) {
+    expandLazyChildren(parent);
+    for (QGraphicsItem *_child : parent->childItems()) {
+        if (T *child = itemCast<T>(_child)) {
+            if (query.matches(child)) {
+                found.append(SvgDomTree<T>(child));
+            }
+        }
+        findAllFromParentRaw<T>(_child, query, found);
+    }
+}
+
+template<typename T>
+SvgDomMatch<T>::SvgDomMatch(T *element, QSharedPointer<const SvgIndex> index)
+    : element(element)
+    , index(std::move(index)) {}
+
+template<typename T>
+SvgDomMatch<T>::operator bool() const {
+    return element != nullptr;
+}
+
+template<typename T>
+bool SvgDomMatch<T>::isEmpty() const {
+    return element == nullptr;
+}
+
+template<typename T>
+T *SvgDomMatch<T>::getElement() const {
+    return element;
+}
+
+template<typename T>
+T *SvgDomMatch<T>::operator->() const {
+    return element;
+}
+
+template<typename T>
+SvgDomTree<T> SvgDomMatch<T>::toTree() const {
+    return SvgDomTree<T>(element, index);
+}
+
+template<typename T>
+template<typename U>
+U *SvgDomMatch<T>::tryFind(const QString &attr_name, const QString &attr_value) const {
+    if (element == nullptr) {
+        return nullptr;
+    }
+    return SvgDomTree<QGraphicsItem>::firstMatch<U>(element, index.data(), attr_name, attr_value);
+}
+
+template<typename T>
+template<typename U>
+SvgDomMatch<U>
+SvgDomMatch<T>::findFirst(const QString &attr_name, const QString &attr_value) const {
+    return SvgDomMatch<U>(tryFind<U>(attr_name, attr_value), index);
+}
+
 } // namespace svgscene
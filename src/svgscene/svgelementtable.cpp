@@ -0,0 +1,56 @@
+#include "svgelementtable.h"
+
+#include <utility>
+
+namespace svgscene {
+
+ElementTable::ElementTable(QSharedPointer<const AtomTable> atoms) : m_atoms(std::move(atoms)) {}
+
+int ElementTable::append(Atom name, const AttributeList &attributes, const ComputedStyle &style) {
+    if (!m_free.isEmpty()) {
+        const int index = m_free.takeLast();
+        set(index, name, attributes, style);
+        return index;
+    }
+    m_records.append(Record { name, attributes, style });
+    return m_records.size() - 1;
+}
+
+void ElementTable::set(
+    int index,
+    Atom name,
+    const AttributeList &attributes,
+    const ComputedStyle &style) {
+    m_records[index] = Record { name, attributes, style };
+}
+
+void ElementTable::release(int index) {
+    m_records[index] = Record { atoms::INVALID, AttributeList(), ComputedStyle() };
+    m_free.append(index);
+}
+
+const QSharedPointer<const AtomTable> &ElementTable::atoms() const {
+    return m_atoms;
+}
+
+void ElementTable::setAtoms(QSharedPointer<const AtomTable> atoms) {
+    m_atoms = std::move(atoms);
+}
+
+Atom ElementTable::name(int index) const {
+    return m_records.at(index).name;
+}
+
+const AttributeList &ElementTable::attributes(int index) const {
+    return m_records.at(index).attributes;
+}
+
+const ComputedStyle &ElementTable::style(int index) const {
+    return m_records.at(index).style;
+}
+
+int ElementTable::size() const {
+    return m_records.size();
+}
+
+} // namespace svgscene
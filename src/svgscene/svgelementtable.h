@@ -0,0 +1,80 @@
+/**
+ * Metadata of the elements of a document in a side table.
+ *
+ * Name, XML attributes and the computed style of all elements with an item are kept in one
+ * contiguous table owned by the handler of the document. An item only stores the position of its
+ * record, a `quint32` held inline by the QVariant, under `MetadataType::XmlAttributes`. The root
+ * item of the document holds the table under `MetadataType::CssAttributes`, the accessors in
+ * `svgmetadata.h` find it through the nearest ancestor holding one and read single values from
+ * it, without copying the attributes.
+ *
+ * The metadata of an item is therefore available only while the item is under the root item of
+ * its document. The table lives as long as the root item or the handler. `SvgHandler::reload`
+ * keeps the table, it replaces the records of updated elements, appends the records of created
+ * ones and releases the records of removed ones for reuse.
+ *
+ * @file
+ */
+#pragma once
+
+#include "svgattributes.h"
+#include "svgstyle.h"
+
+#include <QMetaType>
+#include <QSharedPointer>
+#include <QVector>
+
+namespace svgscene {
+
+class ElementTable {
+public:
+    /** Names of attributes of all elements are resolved by the atom table. */
+    explicit ElementTable(QSharedPointer<const AtomTable> atoms);
+
+    /**
+     * Adds metadata of an element, returns its position used by `ElementHandle`. Positions of
+     * released records are used first.
+     */
+    int append(Atom name, const AttributeList &attributes, const ComputedStyle &style);
+    /** Replaces metadata of the element at the position. */
+    void set(int index, Atom name, const AttributeList &attributes, const ComputedStyle &style);
+    /** Drops metadata of a removed element, its position is free for `append`. */
+    void release(int index);
+
+    const QSharedPointer<const AtomTable> &atoms() const;
+    /** Replaces the atom table by a copy extended by new names, the records stay valid. */
+    void setAtoms(QSharedPointer<const AtomTable> atoms);
+    /** Element name, interned in the same table as the attribute names. */
+    Atom name(int index) const;
+    const AttributeList &attributes(int index) const;
+    const ComputedStyle &style(int index) const;
+    /** Number of records, including the released ones. */
+    int size() const;
+
+private:
+    struct Record {
+        Atom name;
+        AttributeList attributes;
+        ComputedStyle style;
+    };
+
+    QSharedPointer<const AtomTable> m_atoms;
+    QVector<Record> m_records;
+    /** Positions of the released records. */
+    QVector<int> m_free;
+};
+
+/**
+ * Element of an item resolved in the table of its document, see `getElementHandle`. It does not
+ * own the table, it is valid as long as the root item of the document exists.
+ */
+struct ElementHandle {
+    const ElementTable *table = nullptr;
+    int index = -1;
+
+    bool isValid() const { return table && index >= 0; }
+};
+
+} // namespace svgscene
+
+Q_DECLARE_METATYPE(QSharedPointer<const svgscene::ElementTable>)
@@ -0,0 +1,75 @@
+#include "svgfontcache.h"
+
+#include "utils/logging.h"
+
+#include <QFontMetrics>
+
+LOG_CATEGORY("svgscene.parsing");
+
+namespace svgscene {
+
+FontKey::FontKey(const ComputedStyle &style)
+    : sizeUnit(style->fontSizeUnit)
+    , family(style->fontFamily)
+    , weight(style->fontWeight)
+    , stretch(style->fontStretch)
+    , fontStyle(style->fontStyle) {
+    if (sizeUnit == FontSizeUnit::Px) {
+        // Sizes truncated to the same pixel size give the same font.
+        size = int(style->fontSize);
+    } else if (sizeUnit == FontSizeUnit::Pt) {
+        size = style->fontSize;
+    }
+}
+
+bool operator==(const FontKey &a, const FontKey &b) {
+    return a.sizeUnit == b.sizeUnit && a.size == b.size && a.family == b.family
+           && a.weight == b.weight && a.stretch == b.stretch && a.fontStyle == b.fontStyle;
+}
+
+uint qHash(const FontKey &key, uint seed) {
+    // Text of a diagram mostly shares one family and differs in size and weight. Stretch and
+    // style rarely change, they are left to the comparison.
+    uint hash = seed ^ uint(key.sizeUnit) ^ (uint(key.weight) << 4);
+    hash ^= qHash(key.size, seed) * 31;
+    hash ^= qHash(key.family, seed) * 131;
+    return hash;
+}
+
+/**
+ * Creates the font and measures it. Measuring loads the font engine, the most expensive part of
+ * creating a text item.
+ */
+static ResolvedFont resolveFont(const ComputedStyle &style) {
+    ResolvedFont resolved;
+    QFont &font = resolved.font;
+    font.setStyleName(QStringLiteral("Normal"));
+    if (style->fontSizeUnit == FontSizeUnit::Px) {
+        font.setPixelSize((int)style->fontSize);
+    } else if (style->fontSizeUnit == FontSizeUnit::Pt) {
+        font.setPointSizeF(style->fontSize);
+    }
+    if (!style->fontFamily.isEmpty()) {
+        font.setFamily(style->fontFamily);
+    }
+    font.setWeight(style->fontWeight);
+    font.setStretch(style->fontStretch);
+    font.setStyle(style->fontStyle);
+    DEBUG() << "new font" << font.toString();
+
+    const QFontMetricsF metrics(font);
+    resolved.ascent = metrics.ascent();
+    resolved.descent = metrics.descent();
+#if QT_VERSION < QT_VERSION_CHECK(5, 11, 0)
+    resolved.digitWidth = metrics.width(QStringLiteral("0123456789")) / 10;
+#else
+    resolved.digitWidth = metrics.horizontalAdvance(QStringLiteral("0123456789")) / 10;
+#endif
+    return resolved;
+}
+
+const ResolvedFont &FontCache::get(const ComputedStyle &style) {
+    return ResolvedCache::get(style, resolveFont);
+}
+
+} // namespace svgscene
@@ -0,0 +1,64 @@
+/**
+ * Sharing of fonts and font metrics of text items.
+ *
+ * Resolving a font and creating its metrics are among the most expensive calls of the item
+ * creation, yet text heavy diagrams use only a handful of distinct fonts. Each combination of
+ * font properties is resolved once, all text items with the same font share the implicitly
+ * shared `QFont` and the metrics are read from the cache.
+ *
+ * @file
+ */
+#pragma once
+
+#include "svgresolvedcache.h"
+#include "svgstyle.h"
+
+#include <QFont>
+
+namespace svgscene {
+
+/**
+ * Font resolved from the computed style of a text element, with the metrics the handler needs.
+ */
+struct ResolvedFont {
+    QFont font;
+    qreal ascent = 0;
+    qreal descent = 0;
+    /** Average advance of the digits 0-9. */
+    qreal digitWidth = 0;
+};
+
+/**
+ * Properties of the computed style which determine `ResolvedFont`.
+ */
+struct FontKey {
+    FontSizeUnit sizeUnit = FontSizeUnit::None;
+    qreal size = 0;
+    QString family;
+    QFont::Weight weight = QFont::Normal;
+    QFont::Stretch stretch = QFont::Unstretched;
+    QFont::Style fontStyle = QFont::StyleNormal;
+
+    /**
+     * Only px and pt sizes are applied to the font, a size in another unit is left 0. Pixel
+     * sizes are truncated, `QFont::setPixelSize` takes whole pixels.
+     */
+    explicit FontKey(const ComputedStyle &style);
+};
+
+bool operator==(const FontKey &a, const FontKey &b);
+uint qHash(const FontKey &key, uint seed = 0);
+
+/**
+ * Fonts of the text items of a document, `size` is the number of distinct fonts.
+ */
+class FontCache : public ResolvedCache<FontKey, ResolvedFont> {
+public:
+    /**
+     * Font of the style with its metrics, resolved on the first use. Properties not declared by
+     * the style are taken from the default font of the application.
+     */
+    const ResolvedFont &get(const ComputedStyle &style);
+};
+
+} // namespace svgscene
@@ -14,7 +14,7 @@ void SvgGraphicsScene::mouseDoubleClickEvent(QGraphicsSceneMouseEvent *event) {
     // Hyperlink will usually be obscured, but we need to propagate the click.
     QGraphicsItem *item = this->itemAt(event->pos(), {});
     while (item != nullptr) {
-        if (auto hyperlink = dynamic_cast<HyperlinkItem *>(item)) {
+        if (auto hyperlink = itemCast<HyperlinkItem>(item)) {
             hyperlink->mouseDoubleClickEvent(event);
             break;
         }
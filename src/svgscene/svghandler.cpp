@@ -1,35 +1,49 @@
 ﻿#include "svghandler.h"
 
 #include "components/groupitem.h"
+#include "components/lazysubtreeitem.h"
 #include "components/simpletextitem.h"
 #include "svgmetadata.h"
 #include "svgspec.h"
 #include "utils/logging.h"
 
-#include <QFontMetrics>
+#include <QElapsedTimer>
+#include <QFontInfo>
 #include <QGraphicsItem>
 #include <QGraphicsScene>
+#include <QHash>
 #include <QSet>
 #include <QStack>
-#include <QXmlStreamReader>
-#include <QtMath>
 #include <components/hyperlinkitem.h>
+#include <utility>
 
 LOG_CATEGORY("svgscene.parsing");
 
 namespace svgscene {
 
-SvgDocument parseFromFileName(QGraphicsScene *scene, const QString &filename) {
-    QFile file(filename);
-    file.open(QIODevice::ReadOnly);
-    return parseFromFile(scene, &file);
+SvgDocument
+parseFromFileName(QGraphicsScene *scene, const QString &filename, const ParseOptions &options) {
+    return materialize(scene, parseTreeFromFileName(filename, options), options);
 }
 
-SvgDocument parseFromFile(QGraphicsScene *scene, QFile *file) {
-    QXmlStreamReader xml(file);
-    SvgHandler handler(scene);
-    handler.load(&xml);
-    return handler.getDocument();
+SvgDocument parseFromFile(QGraphicsScene *scene, QFile *file, const ParseOptions &options) {
+    return materialize(scene, parseTreeFromFile(file, options), options);
+}
+
+SvgDocument materialize(QGraphicsScene *scene, const SvgTree &tree, bool lazy) {
+    ParseOptions options;
+    options.lazy = lazy;
+    return materialize(scene, tree, options);
+}
+
+SvgDocument materialize(QGraphicsScene *scene, const SvgTree &tree, const ParseOptions &options) {
+    // Shared, placeholders of lazy groups keep the handler alive.
+    QSharedPointer<SvgHandler> handler(new SvgHandler(scene));
+    handler->setLazy(options.lazy);
+    handler->setIndexedAttributes(options.indexedAttributes);
+    handler->setIndexedSearch(options.indexedSearch);
+    handler->load(tree);
+    return handler->getDocument();
 }
 
 static QString transform_to_string(const QTransform &t) {
@@ -55,949 +69,741 @@ public:
     QPointF svgPosition;
 };
 
-// see: https://www.w3.org/TR/SVG11/
+SvgHandler::SvgHandler(QGraphicsScene *scene)
+    : m_scene(scene)
+    , m_atoms(new AtomTable())
+    , m_elements(new ElementTable(m_atoms))
+    , m_index(new SvgIndex()) {}
+
+SvgHandler::~SvgHandler() = default;
 
-// '0' is 0x30 and '9' is 0x39
-static inline bool isDigit(ushort ch) {
-    static quint16 magic = 0x3ff;
-    return ((ch >> 4) == 3) && (magic >> (ch & 15));
+void SvgHandler::load(QXmlStreamReader *data, bool skip_definitions) {
+    load(parseTree(data, skip_definitions));
 }
 
-static qreal toDouble(const QChar *&str) {
-    const int maxLen = 255; // technically doubles can go til 308+ but whatever
-    char temp[maxLen + 1];
-    int pos = 0;
-    if (*str == QLatin1Char('-')) {
-        temp[pos++] = '-';
-        ++str;
-    } else if (*str == QLatin1Char('+')) {
-        ++str;
+void SvgHandler::load(SvgReader *reader, bool skip_definitions) {
+    SvgTreeBuilder builder(skip_definitions);
+    builder.read(reader);
+    load(builder.take());
+}
+
+void SvgHandler::load(const SvgTree &tree) {
+    m_tree = tree;
+    m_nodeItems = QVector<QGraphicsItem *>(tree.nodes().size(), nullptr);
+    startLoad(tree);
+
+    if (m_lazy && sharedFromThis().isNull()) {
+        WARN() << "lazy materialization needs a handler owned by QSharedPointer, loading eagerly";
+        m_lazy = false;
     }
-    while (isDigit(str->unicode()) && pos < maxLen) {
-        temp[pos++] = str->toLatin1();
-        ++str;
+    QStack<int> open;
+    replay(tree, 0, tree.nodes().size(), open);
+    /*
+    QGraphicsRectItem *it = new QGraphicsRectItem();
+    it->setRect(m_scene->sceneRect());
+    it->setPen(QPen(Qt::blue));
+    m_scene->addItem(it);
+    */
+}
+
+void SvgHandler::loadIncrement(const SvgTree &tree, int count, bool complete) {
+    if (!m_incremental) {
+        m_incremental = true;
+        m_replayed = 0;
+        m_replayOpen.clear();
+        startLoad(tree);
+        // Ends of elements are not known in advance.
+        m_lazy = false;
     }
-    if (*str == QLatin1Char('.') && pos < maxLen) {
-        temp[pos++] = '.';
-        ++str;
+    m_nodeItems.resize(tree.nodes().size());
+    replay(tree, m_replayed, count, m_replayOpen);
+    m_replayed = count;
+    if (complete) {
+        m_incremental = false;
+        m_tree = tree;
     }
-    while (isDigit(str->unicode()) && pos < maxLen) {
-        temp[pos++] = str->toLatin1();
-        ++str;
+}
+
+void SvgHandler::startLoad(const SvgTree &tree) {
+    m_atoms = tree.atoms();
+    m_elements.reset(new ElementTable(m_atoms));
+    m_elementAtoms.clear();
+    m_index->clear();
+    if (tree.stats().profiled) {
+        m_profiling = true;
     }
-    bool exponent = false;
-    if ((*str == QLatin1Char('e') || *str == QLatin1Char('E')) && pos < maxLen) {
-        exponent = true;
-        temp[pos++] = 'e';
-        ++str;
-        if ((*str == QLatin1Char('-') || *str == QLatin1Char('+')) && pos < maxLen) {
-            temp[pos++] = str->toLatin1();
-            ++str;
+    m_defaultPen = QPen(Qt::black, 1, Qt::SolidLine, Qt::FlatCap, Qt::SvgMiterJoin);
+    m_defaultPen.setMiterLimit(4);
+
+    m_elementStack.push(SvgElement::initial_element());
+}
+
+void SvgHandler::setLazy(bool lazy) {
+    m_lazy = lazy;
+}
+
+void SvgHandler::setIndexedAttributes(const QStringList &names) {
+    m_index->setAttributeNames(names);
+}
+
+void SvgHandler::setIndexedSearch(bool indexed) {
+    m_indexedSearch = indexed;
+}
+
+QSharedPointer<const SvgIndex> SvgHandler::getIndex() const {
+    return m_index;
+}
+
+void SvgHandler::setProfiling(bool profiling) {
+    m_profiling = profiling;
+}
+
+ParseProfile *SvgHandler::profile() {
+    return m_profiling ? &m_profile : nullptr;
+}
+
+void SvgHandler::replay(const SvgTree &tree, int begin, int end, QStack<int> &open) {
+    // Replays the document in reading order, end of an element is reached at the index behind
+    // its last descendant. Elements still being read have no end yet and stay open.
+    const QVector<SvgNode> &nodes = tree.nodes();
+    for (int i = begin; i <= end; ++i) {
+        while (!open.isEmpty() && nodes.at(open.top()).end == i) {
+            if (nodes.at(open.pop()).closed) {
+                endElement();
+            }
         }
-        while (isDigit(str->unicode()) && pos < maxLen) {
-            temp[pos++] = str->toLatin1();
-            ++str;
+        if (i == end) {
+            break;
         }
-    }
-    temp[pos] = '\0';
-    qreal val;
-    if (!exponent && pos < 10) {
-        int ival = 0;
-        const char *t = temp;
-        bool neg = false;
-        if (*t == '-') {
-            neg = true;
-            ++t;
+        const SvgNode &node = nodes.at(i);
+        if (node.kind == SvgNodeKind::Text) {
+            characters(tree.text(node));
+            continue;
+        }
+        // Frames only share the node's data, they are moved in and out of the stack.
+        SvgElement el(m_atoms->name(node.name));
+        el.atom = node.name;
+        el.xmlAttributes = node.attributes;
+        el.style = node.style;
+        m_elementStack.append(std::move(el));
+        ParseProfile *profile = this->profile();
+        QElapsedTimer timer;
+        if (profile != nullptr) {
+            timer.start();
         }
-        while (*t && *t != '.') {
-            ival *= 10;
-            ival += (*t) - '0';
-            ++t;
+        bool is_item_created = startElement(tree, node);
+        if (profile != nullptr) {
+            profile->elements[m_elementStack.last().name].nanoseconds
+                += quint64(timer.nsecsElapsed());
         }
-        if (*t == '.') {
-            ++t;
-            int div = 1;
-            while (*t) {
-                ival *= 10;
-                ival += (*t) - '0';
-                div *= 10;
-                ++t;
+        m_elementStack.last().itemCreated = is_item_created;
+        if (is_item_created) {
+            m_nodeItems[i] = m_topLevelItem;
+            if (m_indexedSearch && !m_reloading) {
+                const int parent = parentNode(nodes, i);
+                m_index->insert(i, parent, m_topLevelItem, node.attributes, *m_atoms);
             }
-            val = ((qreal)ival) / ((qreal)div);
-        } else {
-            val = ival;
         }
-        if (neg)
-            val = -val;
-    } else {
-        val = QByteArray::fromRawData(temp, pos).toDouble();
+        open.push(i);
+        if (is_item_created && m_lazy && deferSubtree(tree, i)) {
+            // Continues with the end of the element.
+            i = node.end - 1;
+        }
     }
-    return val;
 }
 
-static qreal toDouble(const QString &str, bool *ok = nullptr) {
-    const QChar *c = str.constData();
-    qreal res = toDouble(c);
-    if (ok) {
-        *ok = ((*c) == QLatin1Char('\0'));
+int SvgHandler::parentNode(const QVector<SvgNode> &nodes, int index) const {
+    int parent = nodes.at(index).parent;
+    while (parent >= 0 && m_nodeItems.value(parent) == nullptr) {
+        parent = nodes.at(parent).parent;
     }
-    return res;
+    return parent;
 }
 
-/*
-static qreal toDouble(const QStringRef &str, bool *ok = nullptr)
-{
-    const QChar *c = str.constData();
-    qreal res = toDouble(c);
-    if (ok) {
-        *ok = (c == (str.constData() + str.length()));
-    }
-    return res;
-}
-*/
-static inline void parseNumbersArray(const QChar *&str, QVarLengthArray<qreal, 8> &points) {
-    while (str->isSpace())
-        ++str;
-    while (isDigit(str->unicode()) || *str == QLatin1Char('-') || *str == QLatin1Char('+')
-           || *str == QLatin1Char('.')) {
-        points.append(toDouble(str));
-        while (str->isSpace())
-            ++str;
-        if (*str == QLatin1Char(','))
-            ++str;
-        // eat the rest of space
-        while (str->isSpace())
-            ++str;
-    }
+void SvgHandler::loadSubtree(const SvgTree &tree, int index, QGraphicsItem *item) {
+    replayUnder(tree, index + 1, tree.nodes().at(index).end, item);
+    m_index->subtreeCreated();
 }
 
-static QVector<qreal> parseNumbersList(const QChar *&str) {
-    QVector<qreal> points;
-    if (!str)
-        return points;
-    points.reserve(32);
-    while (str->isSpace())
-        ++str;
-    while (isDigit(str->unicode()) || *str == QLatin1Char('-') || *str == QLatin1Char('+')
-           || *str == QLatin1Char('.')) {
-        points.append(toDouble(str));
-        while (str->isSpace())
-            ++str;
-        if (*str == QLatin1Char(','))
-            ++str;
-        // eat the rest of space
-        while (str->isSpace())
-            ++str;
-    }
-    return points;
+void SvgHandler::replayUnder(const SvgTree &tree, int begin, int end, QGraphicsItem *item) {
+    // The handler is idle, its state is only saved for consistency.
+    QStack<SvgElement> element_stack;
+    element_stack.swap(m_elementStack);
+    QGraphicsItem *top_level_item = m_topLevelItem;
+
+    // Stands for the parent, which is not created here and never ended by the replay.
+    m_elementStack.push(SvgElement());
+    m_topLevelItem = item;
+    QStack<int> open;
+    replay(tree, begin, end, open);
+
+    m_elementStack.swap(element_stack);
+    m_topLevelItem = top_level_item;
 }
 
-static QVector<qreal> parsePercentageList(const QChar *&str) {
-    QVector<qreal> points;
-    if (!str)
-        return points;
-    while (str->isSpace())
-        ++str;
-    while ((*str >= QLatin1Char('0') && *str <= QLatin1Char('9')) || *str == QLatin1Char('-')
-           || *str == QLatin1Char('+') || *str == QLatin1Char('.')) {
-        points.append(toDouble(str));
-        while (str->isSpace())
-            ++str;
-        if (*str == QLatin1Char('%'))
-            ++str;
-        while (str->isSpace())
-            ++str;
-        if (*str == QLatin1Char(','))
-            ++str;
-        // eat the rest of space
-        while (str->isSpace())
-            ++str;
+/**
+ * Nodes below this count are created immediately, the placeholder would not save anything.
+ */
+static const int LAZY_MIN_DESCENDANTS = 32;
+
+/**
+ * Pixel size of the font of text elements, including the default font.
+ */
+static qreal estimateFontSize(const ComputedStyle &style) {
+    if (style->fontSizeUnit == FontSizeUnit::Px) {
+        return style->fontSize;
+    } else if (style->fontSizeUnit == FontSizeUnit::Pt) {
+        return style->fontSize * 96 / 72;
     }
-    return points;
+    return QFontInfo(QFont()).pixelSize();
 }
 
-static inline int qsvg_h2i(char hex) {
-    if (hex >= '0' && hex <= '9')
-        return hex - '0';
-    if (hex >= 'a' && hex <= 'f')
-        return hex - 'a' + 10;
-    if (hex >= 'A' && hex <= 'F')
-        return hex - 'A' + 10;
-    return -1;
-}
-static inline int qsvg_hex2int(const char *s) {
-    return (qsvg_h2i(s[0]) << 4) | qsvg_h2i(s[1]);
-}
-static inline int qsvg_hex2int(char s) {
-    int h = qsvg_h2i(s);
-    return (h << 4) | h;
+/**
+ * Conservative bounds of descendants of the node in its coordinates, estimated without creating
+ * any item. Returns false, when that is not possible (positioned spans, flowed text).
+ */
+static bool estimateSubtreeBounds(const SvgTree &tree, int index, QRectF &bounds) {
+    const QVector<SvgNode> &nodes = tree.nodes();
+    const int first = index + 1;
+    const int end = nodes.at(index).end;
+    // Maps content of each node to coordinates of the subtree root.
+    QVector<QTransform> mapping(end - first);
+    for (int i = first; i < end; ++i) {
+        const SvgNode &node = nodes.at(i);
+        const QTransform parent_mapping
+            = (node.parent > index) ? mapping.at(node.parent - first) : QTransform();
+        QTransform &node_mapping = mapping[i - first];
+        QRectF rect;
+        switch (node.kind) {
+        case SvgNodeKind::Tspan:
+        case SvgNodeKind::FlowRoot: return false;
+        case SvgNodeKind::Text:
+        case SvgNodeKind::Unknown:
+        case SvgNodeKind::Svg:
+        case SvgNodeKind::Defs:
+            // No item, children are placed into the parent.
+            node_mapping = parent_mapping;
+            continue;
+        case SvgNodeKind::Group:
+        case SvgNodeKind::Hyperlink:
+            node_mapping = tree.transform(node) * parent_mapping;
+            continue;
+        case SvgNodeKind::Rect:
+        case SvgNodeKind::Circle:
+        case SvgNodeKind::Ellipse: rect = node.geometry; break;
+        case SvgNodeKind::Path: rect = tree.path(node).controlPointRect(); break;
+        case SvgNodeKind::TextElement: {
+            // Lines are joined character data, glyphs are assumed to be at most as wide as the
+            // font size. Any anchor is covered.
+            int lines = 0;
+            int length = 0;
+            for (int j = i + 1; j < node.end; ++j) {
+                if (nodes.at(j).kind == SvgNodeKind::Text) {
+                    ++lines;
+                    length = qMax(length, tree.text(nodes.at(j)).size());
+                }
+            }
+            const qreal size = estimateFontSize(node.style);
+            const qreal width = length * size;
+            rect = QRectF(
+                node.geometry.x() - width, node.geometry.y() - 2 * size, 2 * width + size,
+                (lines + 1) * 2 * size);
+            break;
+        }
+        }
+        node_mapping = tree.transform(node) * parent_mapping;
+        if (node.style->stroke == PaintType::Color) {
+            // Covers miter joins up to the default limit.
+            const qreal margin = 2 * node.style->strokeWidth;
+            rect.adjust(-margin, -margin, margin, margin);
+        }
+        bounds |= node_mapping.mapRect(rect);
+    }
+    return true;
 }
 
-bool qsvg_get_hex_rgb(const char *name, QRgb *rgb) {
-    if (name[0] != '#')
+bool SvgHandler::deferSubtree(const SvgTree &tree, int index) {
+    const SvgNode &node = tree.nodes().at(index);
+    auto *group = itemCast<GroupItem>(m_topLevelItem);
+    if (!group || node.end - index - 1 < LAZY_MIN_DESCENDANTS) {
         return false;
-    name++;
-    int len = static_cast<int>(qstrlen(name));
-    int r, g, b;
-    if (len == 12) {
-        r = qsvg_hex2int(name);
-        g = qsvg_hex2int(name + 4);
-        b = qsvg_hex2int(name + 8);
-    } else if (len == 9) {
-        r = qsvg_hex2int(name);
-        g = qsvg_hex2int(name + 3);
-        b = qsvg_hex2int(name + 6);
-    } else if (len == 6) {
-        r = qsvg_hex2int(name);
-        g = qsvg_hex2int(name + 2);
-        b = qsvg_hex2int(name + 4);
-    } else if (len == 3) {
-        r = qsvg_hex2int(name[0]);
-        g = qsvg_hex2int(name[1]);
-        b = qsvg_hex2int(name[2]);
-    } else {
-        r = g = b = -1;
     }
-    if ((uint)r > 255 || (uint)g > 255 || (uint)b > 255) {
-        *rgb = 0;
+    QRectF bounds;
+    if (!estimateSubtreeBounds(tree, index, bounds)) {
         return false;
     }
-    *rgb = qRgb(r, g, b);
+    new LazySubtreeItem(sharedFromThis(), tree, index, bounds, group);
+    m_index->subtreeDeferred();
     return true;
 }
 
-bool qsvg_get_hex_rgb(const QChar *str, int len, QRgb *rgb) {
-    if (len > 13)
-        return false;
-    char tmp[16];
-    for (int i = 0; i < len; ++i)
-        tmp[i] = str[i].toLatin1();
-    tmp[len] = 0;
-    return qsvg_get_hex_rgb(tmp, rgb);
-}
+/**
+ * Matching of two versions of the document and update of the items of the old one.
+ *
+ * Only elements creating items directly (not inside text) are matched one by one, text elements
+ * are compared as a whole.
+ */
+class SvgHandler::Reload {
+public:
+    Reload(SvgHandler *handler, const SvgTree &tree)
+        : m_handler(handler)
+        , m_old(handler->m_tree)
+        , m_new(tree)
+        , m_oldNodes(m_old.nodes())
+        , m_newNodes(m_new.nodes())
+        , m_oldItems(handler->m_nodeItems)
+        , m_items(handler->m_nodeItems)
+        , m_match(m_oldNodes.size(), -1) {}
 
-static QColor parseColor(const QString &color, const QString &opacity) {
-    QColor ret;
-    {
-        QStringRef color_str = QStringRef(&color).trimmed();
-        if (color_str.isEmpty())
-            return ret;
-        switch (color_str.at(0).unicode()) {
-        case '#': {
-            // #rrggbb is very very common, so let's tackle it here
-            // rather than falling back to QColor
-            QRgb rgb;
-            bool ok = qsvg_get_hex_rgb(color_str.unicode(), color_str.length(), &rgb);
-            if (ok)
-                ret.setRgb(rgb);
-            break;
+    bool run() {
+        const int old_root = rootOf(m_oldNodes);
+        const int new_root = rootOf(m_newNodes);
+        if (old_root < 0 || new_root < 0 || !m_oldItems.value(old_root)) {
+            return false;
         }
-        case 'r': {
-            // starts with "rgb(", ends with ")" and consists of at least 7
-            // characters "rgb(,,)"
-            if (color_str.length() >= 7 && color_str.at(color_str.length() - 1) == QLatin1Char(')')
-                && QStringRef(color_str.string(), color_str.position(), 4)
-                       == QLatin1String("rgb(")) {
-                const QChar *s = color_str.constData() + 4;
-                QVector<qreal> compo = parseNumbersList(s);
-                // 1 means that it failed after reaching non-parsable
-                // character which is going to be "%"
-                if (compo.size() == 1) {
-                    s = color_str.constData() + 4;
-                    compo = parsePercentageList(s);
-                    for (double &i : compo)
-                        i *= (qreal)2.55;
-                }
-                if (compo.size() == 3) {
-                    ret = QColor(int(compo[0]), int(compo[1]), int(compo[2]));
-                }
+        mapAtoms();
+        for (int i = 0; i < m_oldNodes.size(); ++i) {
+            const QString *id = m_oldNodes.at(i).attributes.find(atoms::Id);
+            if (id && !m_oldIds.contains(*id)) {
+                m_oldIds.insert(*id, i);
             }
-            break;
         }
-        case 'c':
-            if (color_str == QLatin1String("currentColor")) {
-                // color = handler->currentColor();
-                return ret;
+        for (const SvgNode &node : m_newNodes) {
+            if (const QString *id = node.attributes.find(atoms::Id)) {
+                m_newIds.insert(*id);
             }
-            break;
-        case 'i':
-            if (color_str == QLatin1String("inherit"))
-                return ret;
-            break;
-        default: ret = QColor(color_str.toString()); break;
         }
+
+        m_handler->m_atoms = m_new.atoms();
+        m_handler->mapElementAtoms();
+        m_items = QVector<QGraphicsItem *>(m_newNodes.size(), nullptr);
+        m_match[old_root] = new_root;
+        m_items[new_root] = m_oldItems.at(old_root);
+        // Until the end, the index has the old node numbers.
+        m_handler->m_reloading = true;
+        matchChildren(old_root, new_root);
+        m_handler->m_reloading = false;
+        removeUnmatched();
+        for (int node : m_restack) {
+            restack(node);
+        }
+        m_handler->m_tree = m_new;
+        reindex();
+        LOG() << "reload: updated" << m_updated << "created" << m_created << "removed"
+              << m_removed;
+        return true;
     }
-    if (!opacity.isEmpty() && ret.isValid()) {
-        bool ok = true;
-        qreal op = qMin(qreal(1.0), qMax(qreal(0.0), toDouble(opacity, &ok)));
-        if (!ok)
-            op = 1.0;
-        ret.setAlphaF(op);
+
+private:
+    static int rootOf(const QVector<SvgNode> &nodes) {
+        for (int i = 0; i < nodes.size(); i = nodes.at(i).end) {
+            if (nodes.at(i).kind == SvgNodeKind::Svg) {
+                return i;
+            }
+        }
+        return -1;
     }
-    return ret;
-}
 
-static QMatrix parseTransformationMatrix(const QStringRef &value) {
-    if (value.isEmpty())
-        return {};
-    QMatrix matrix;
-    const QChar *str = value.constData();
-    const QChar *end = str + value.length();
-    while (str < end) {
-        if (str->isSpace() || *str == QLatin1Char(',')) {
-            ++str;
-            continue;
+    static bool isText(SvgNodeKind kind) {
+        return kind == SvgNodeKind::TextElement || kind == SvgNodeKind::Tspan
+               || kind == SvgNodeKind::FlowRoot;
+    }
+
+    /** Atoms of the new tree translated to the old one, they are not comparable otherwise. */
+    void mapAtoms() {
+        const AtomTable &old_atoms = *m_old.atoms();
+        const AtomTable &new_atoms = *m_new.atoms();
+        m_atomMap.resize(new_atoms.size());
+        for (int atom = 0; atom < new_atoms.size(); ++atom) {
+            const bool known = Atom(atom) < atoms::KNOWN_END;
+            m_atomMap[atom] = known ? Atom(atom) : old_atoms.find(new_atoms.name(atom));
         }
-        enum State { Matrix, Translate, Rotate, Scale, SkewX, SkewY };
-        State state = Matrix;
-        if (*str == QLatin1Char('m')) { // matrix
-            const char *ident = "atrix";
-            for (int i = 0; i < 5; ++i)
-                if (*(++str) != QLatin1Char(ident[i]))
-                    goto error;
-            ++str;
-            state = Matrix;
-        } else if (*str == QLatin1Char('t')) { // translate
-            const char *ident = "ranslate";
-            for (int i = 0; i < 8; ++i)
-                if (*(++str) != QLatin1Char(ident[i]))
-                    goto error;
-            ++str;
-            state = Translate;
-        } else if (*str == QLatin1Char('r')) { // rotate
-            const char *ident = "otate";
-            for (int i = 0; i < 5; ++i)
-                if (*(++str) != QLatin1Char(ident[i]))
-                    goto error;
-            ++str;
-            state = Rotate;
-        } else if (*str == QLatin1Char('s')) { // scale, skewX, skewY
-            ++str;
-            if (*str == QLatin1Char('c')) {
-                const char *ident = "ale";
-                for (int i = 0; i < 3; ++i)
-                    if (*(++str) != QLatin1Char(ident[i]))
-                        goto error;
-                ++str;
-                state = Scale;
-            } else if (*str == QLatin1Char('k')) {
-                if (*(++str) != QLatin1Char('e'))
-                    goto error;
-                if (*(++str) != QLatin1Char('w'))
-                    goto error;
-                ++str;
-                if (*str == QLatin1Char('X'))
-                    state = SkewX;
-                else if (*str == QLatin1Char('Y'))
-                    state = SkewY;
-                else
-                    goto error;
-                ++str;
-            } else {
-                goto error;
-            }
-        } else {
-            goto error;
+    }
+
+    Atom oldAtom(Atom atom) const {
+        return (atom < Atom(m_atomMap.size())) ? m_atomMap.at(atom) : atoms::INVALID;
+    }
+
+    bool sameAttributes(const AttributeList &old_list, const AttributeList &new_list) const {
+        if (old_list.size() != new_list.size()) {
+            return false;
         }
-        while (str < end && str->isSpace())
-            ++str;
-        if (*str != QLatin1Char('('))
-            goto error;
-        ++str;
-        QVarLengthArray<qreal, 8> points;
-        parseNumbersArray(str, points);
-        if (*str != QLatin1Char(')'))
-            goto error;
-        ++str;
-        if (state == Matrix) {
-            if (points.count() != 6)
-                goto error;
-            matrix = QMatrix(points[0], points[1], points[2], points[3], points[4], points[5])
-                     * matrix;
-        } else if (state == Translate) {
-            if (points.count() == 1)
-                matrix.translate(points[0], 0);
-            else if (points.count() == 2)
-                matrix.translate(points[0], points[1]);
-            else
-                goto error;
-        } else if (state == Rotate) {
-            if (points.count() == 1) {
-                matrix.rotate(points[0]);
-            } else if (points.count() == 3) {
-                matrix.translate(points[1], points[2]);
-                matrix.rotate(points[0]);
-                matrix.translate(-points[1], -points[2]);
-            } else {
-                goto error;
+        for (const Attribute &attr : new_list) {
+            const QString *value = old_list.find(oldAtom(attr.name));
+            if (!value || *value != attr.value) {
+                return false;
             }
-        } else if (state == Scale) {
-            if (points.count() < 1 || points.count() > 2)
-                goto error;
-            qreal sx = points[0];
-            qreal sy = sx;
-            if (points.count() == 2)
-                sy = points[1];
-            matrix.scale(sx, sy);
-        } else if (state == SkewX) {
-            if (points.count() != 1)
-                goto error;
-            const auto deg2rad = qreal(0.017453292519943295769);
-            matrix.shear(qTan(points[0] * deg2rad), 0);
-        } else if (state == SkewY) {
-            if (points.count() != 1)
-                goto error;
-            const auto deg2rad = qreal(0.017453292519943295769);
-            matrix.shear(0, qTan(points[0] * deg2rad));
         }
+        return true;
     }
-error:
-    return matrix;
-}
 
-// the arc handling code underneath is from XSVG (BSD license)
-/*
- * Copyright  2002 USC/Information Sciences Institute
- *
- * Permission to use, copy, modify, distribute, and sell this software
- * and its documentation for any purpose is hereby granted without
- * fee, provided that the above copyright notice appear in all copies
- * and that both that copyright notice and this permission notice
- * appear in supporting documentation, and that the name of
- * Information Sciences Institute not be used in advertising or
- * publicity pertaining to distribution of the software without
- * specific, written prior permission.  Information Sciences Institute
- * makes no representations about the suitability of this software for
- * any purpose.  It is provided "as is" without express or implied
- * warranty.
- *
- * INFORMATION SCIENCES INSTITUTE DISCLAIMS ALL WARRANTIES WITH REGARD
- * TO THIS SOFTWARE, INCLUDING ALL IMPLIED WARRANTIES OF
- * MERCHANTABILITY AND FITNESS, IN NO EVENT SHALL INFORMATION SCIENCES
- * INSTITUTE BE LIABLE FOR ANY SPECIAL, INDIRECT OR CONSEQUENTIAL
- * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA
- * OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
- * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
- * PERFORMANCE OF THIS SOFTWARE.
- *
- */
-static void pathArcSegment(
-    QPainterPath &path,
-    qreal xc,
-    qreal yc,
-    qreal th0,
-    qreal th1,
-    qreal rx,
-    qreal ry,
-    qreal xAxisRotation) {
-    qreal sinTh, cosTh;
-    qreal a00, a01, a10, a11;
-    qreal x1, y1, x2, y2, x3, y3;
-    qreal t;
-    qreal thHalf;
-    sinTh = qSin(xAxisRotation * (M_PI / 180.0));
-    cosTh = qCos(xAxisRotation * (M_PI / 180.0));
-    a00 = cosTh * rx;
-    a01 = -sinTh * ry;
-    a10 = sinTh * rx;
-    a11 = cosTh * ry;
-    thHalf = 0.5 * (th1 - th0);
-    t = (8.0 / 3.0) * qSin(thHalf * 0.5) * qSin(thHalf * 0.5) / qSin(thHalf);
-    x1 = xc + qCos(th0) - t * qSin(th0);
-    y1 = yc + qSin(th0) + t * qCos(th0);
-    x3 = xc + qCos(th1);
-    y3 = yc + qSin(th1);
-    x2 = x3 + t * qSin(th1);
-    y2 = y3 - t * qCos(th1);
-    path.cubicTo(
-        a00 * x1 + a01 * y1, a10 * x1 + a11 * y1, a00 * x2 + a01 * y2, a10 * x2 + a11 * y2,
-        a00 * x3 + a01 * y3, a10 * x3 + a11 * y3);
-}
+    bool sameStyle(const ComputedStyle &old_style, const ComputedStyle &new_style) const {
+        // Typed values are computed from the declarations.
+        return sameAttributes(old_style->declared, new_style->declared);
+    }
 
-static void pathArc(
-    QPainterPath &path,
-    qreal rx,
-    qreal ry,
-    qreal x_axis_rotation,
-    int large_arc_flag,
-    int sweep_flag,
-    qreal x,
-    qreal y,
-    qreal curx,
-    qreal cury) {
-    qreal sin_th, cos_th;
-    qreal a00, a01, a10, a11;
-    qreal x0, y0, x1, y1, xc, yc;
-    qreal d, sfactor, sfactor_sq;
-    qreal th0, th1, th_arc;
-    int i, n_segs;
-    qreal dx, dy, dx1, dy1, Pr1, Pr2, Px, Py, check;
-    rx = qAbs(rx);
-    ry = qAbs(ry);
-    sin_th = qSin(x_axis_rotation * (M_PI / 180.0));
-    cos_th = qCos(x_axis_rotation * (M_PI / 180.0));
-    dx = (curx - x) / 2.0;
-    dy = (cury - y) / 2.0;
-    dx1 = cos_th * dx + sin_th * dy;
-    dy1 = -sin_th * dx + cos_th * dy;
-    Pr1 = rx * rx;
-    Pr2 = ry * ry;
-    Px = dx1 * dx1;
-    Py = dy1 * dy1;
-    /* Spec : check if radii are large enough */
-    check = Px / Pr1 + Py / Pr2;
-    if (check > 1) {
-        rx = rx * qSqrt(check);
-        ry = ry * qSqrt(check);
+    bool sameName(int old_index, int new_index) const {
+        const SvgNode &old_node = m_oldNodes.at(old_index);
+        const SvgNode &new_node = m_newNodes.at(new_index);
+        return old_node.kind == new_node.kind
+               && (old_node.kind == SvgNodeKind::Text || old_node.name == oldAtom(new_node.name));
     }
-    a00 = cos_th / rx;
-    a01 = sin_th / rx;
-    a10 = -sin_th / ry;
-    a11 = cos_th / ry;
-    x0 = a00 * curx + a01 * cury;
-    y0 = a10 * curx + a11 * cury;
-    x1 = a00 * x + a01 * y;
-    y1 = a10 * x + a11 * y;
-    /* (x0, y0) is current point in transformed coordinate space.
-       (x1, y1) is new point in transformed coordinate space.
-       The arc fits a unit-radius circle in this space.
-    */
-    d = (x1 - x0) * (x1 - x0) + (y1 - y0) * (y1 - y0);
-    sfactor_sq = 1.0 / d - 0.25;
-    if (sfactor_sq < 0)
-        sfactor_sq = 0;
-    sfactor = qSqrt(sfactor_sq);
-    if (sweep_flag == large_arc_flag)
-        sfactor = -sfactor;
-    xc = 0.5 * (x0 + x1) - sfactor * (y1 - y0);
-    yc = 0.5 * (y0 + y1) + sfactor * (x1 - x0);
-    /* (xc, yc) is center of the circle. */
-    th0 = qAtan2(y0 - yc, x0 - xc);
-    th1 = qAtan2(y1 - yc, x1 - xc);
-    th_arc = th1 - th0;
-    if (th_arc < 0 && sweep_flag)
-        th_arc += 2 * M_PI;
-    else if (th_arc > 0 && !sweep_flag)
-        th_arc -= 2 * M_PI;
-    n_segs = qCeil(qAbs(th_arc / (M_PI * 0.5 + 0.001)));
-    for (i = 0; i < n_segs; i++) {
-        pathArcSegment(
-            path, xc, yc, th0 + i * th_arc / n_segs, th0 + (i + 1) * th_arc / n_segs, rx, ry,
-            x_axis_rotation);
+
+    /** Compares only the node itself, everything decoded is derived from what is compared. */
+    bool sameNode(int old_index, int new_index) const {
+        const SvgNode &old_node = m_oldNodes.at(old_index);
+        const SvgNode &new_node = m_newNodes.at(new_index);
+        if (!sameName(old_index, new_index)) {
+            return false;
+        }
+        if (old_node.kind == SvgNodeKind::Text) {
+            return m_old.text(old_node) == m_new.text(new_node);
+        }
+        return sameAttributes(old_node.attributes, new_node.attributes)
+               && sameStyle(old_node.style, new_node.style);
     }
-}
 
-static bool parsePathDataFast(const QStringRef &dataStr, QPainterPath &path) {
-    qreal x0 = 0, y0 = 0; // starting point
-    qreal x = 0, y = 0;   // current point
-    char lastMode = 0;
-    QPointF ctrlPt;
-    const QChar *str = dataStr.constData();
-    const QChar *end = str + dataStr.size();
-    while (str != end) {
-        while (str->isSpace())
-            ++str;
-        QChar pathElem = *str;
-        ++str;
-        QChar endc = *end;
-        *const_cast<QChar *>(end) = 0; // parseNumbersArray requires
-                                       // 0-termination that QStringRef cannot
-                                       // guarantee
-        QVarLengthArray<qreal, 8> arg;
-        parseNumbersArray(str, arg);
-        *const_cast<QChar *>(end) = endc;
-        if (pathElem == QLatin1Char('z') || pathElem == QLatin1Char('Z'))
-            arg.append(0); // dummy
-        const qreal *num = arg.constData();
-        int count = arg.count();
-        while (count > 0) {
-            qreal offsetX = x; // correction offsets
-            qreal offsetY = y; // for relative commands
-            switch (pathElem.unicode()) {
-            case 'm': {
-                if (count < 2) {
-                    num++;
-                    count--;
-                    break;
-                }
-                x = x0 = num[0] + offsetX;
-                y = y0 = num[1] + offsetY;
-                num += 2;
-                count -= 2;
-                path.moveTo(x0, y0);
-                // As per 1.2  spec 8.3.2 The "moveto" commands
-                // If a 'moveto' is followed by multiple pairs of coordinates
-                // without explicit commands, the subsequent pairs shall be
-                // treated as implicit 'lineto' commands.
-                pathElem = QLatin1Char('l');
-            } break;
-            case 'M': {
-                if (count < 2) {
-                    num++;
-                    count--;
-                    break;
-                }
-                x = x0 = num[0];
-                y = y0 = num[1];
-                num += 2;
-                count -= 2;
-                path.moveTo(x0, y0);
-                // As per 1.2  spec 8.3.2 The "moveto" commands
-                // If a 'moveto' is followed by multiple pairs of coordinates
-                // without explicit commands, the subsequent pairs shall be
-                // treated as implicit 'lineto' commands.
-                pathElem = QLatin1Char('L');
-            } break;
-            case 'z':
-            case 'Z': {
-                x = x0;
-                y = y0;
-                count--; // skip dummy
-                num++;
-                path.closeSubpath();
-            } break;
-            case 'l': {
-                if (count < 2) {
-                    num++;
-                    count--;
-                    break;
-                }
-                x = num[0] + offsetX;
-                y = num[1] + offsetY;
-                num += 2;
-                count -= 2;
-                path.lineTo(x, y);
-            } break;
-            case 'L': {
-                if (count < 2) {
-                    num++;
-                    count--;
-                    break;
-                }
-                x = num[0];
-                y = num[1];
-                num += 2;
-                count -= 2;
-                path.lineTo(x, y);
-            } break;
-            case 'h': {
-                x = num[0] + offsetX;
-                num++;
-                count--;
-                path.lineTo(x, y);
-            } break;
-            case 'H': {
-                x = num[0];
-                num++;
-                count--;
-                path.lineTo(x, y);
-            } break;
-            case 'v': {
-                y = num[0] + offsetY;
-                num++;
-                count--;
-                path.lineTo(x, y);
-            } break;
-            case 'V': {
-                y = num[0];
-                num++;
-                count--;
-                path.lineTo(x, y);
-            } break;
-            case 'c': {
-                if (count < 6) {
-                    num += count;
-                    count = 0;
-                    break;
-                }
-                QPointF c1(num[0] + offsetX, num[1] + offsetY);
-                QPointF c2(num[2] + offsetX, num[3] + offsetY);
-                QPointF e(num[4] + offsetX, num[5] + offsetY);
-                num += 6;
-                count -= 6;
-                path.cubicTo(c1, c2, e);
-                ctrlPt = c2;
-                x = e.x();
-                y = e.y();
-                break;
+    bool sameSubtree(int old_index, int new_index) const {
+        const int size = m_oldNodes.at(old_index).end - old_index;
+        if (size != m_newNodes.at(new_index).end - new_index) {
+            return false;
+        }
+        for (int i = 0; i < size; ++i) {
+            if (!sameNode(old_index + i, new_index + i)
+                || m_oldNodes.at(old_index + i).end - old_index
+                       != m_newNodes.at(new_index + i).end - new_index) {
+                return false;
             }
-            case 'C': {
-                if (count < 6) {
-                    num += count;
-                    count = 0;
-                    break;
-                }
-                QPointF c1(num[0], num[1]);
-                QPointF c2(num[2], num[3]);
-                QPointF e(num[4], num[5]);
-                num += 6;
-                count -= 6;
-                path.cubicTo(c1, c2, e);
-                ctrlPt = c2;
-                x = e.x();
-                y = e.y();
-                break;
+        }
+        return true;
+    }
+
+    static QVector<int> elementChildren(const QVector<SvgNode> &nodes, int parent) {
+        QVector<int> children;
+        for (int i = parent + 1; i < nodes.at(parent).end; i = nodes.at(i).end) {
+            if (nodes.at(i).kind != SvgNodeKind::Text) {
+                children.append(i);
             }
-            case 's': {
-                if (count < 4) {
-                    num += count;
-                    count = 0;
-                    break;
+        }
+        return children;
+    }
+
+    /** Old element may be matched by position, unless its id is still used. */
+    bool isPositional(int old_index) const {
+        const QString *id = m_oldNodes.at(old_index).attributes.find(atoms::Id);
+        return !id || !m_newIds.contains(*id);
+    }
+
+    void matchChildren(int old_parent, int new_parent) {
+        const QVector<int> old_children = elementChildren(m_oldNodes, old_parent);
+        const QVector<int> new_children = elementChildren(m_newNodes, new_parent);
+        QVector<int> pairs(new_children.size(), -1);
+
+        for (int k = 0; k < new_children.size(); ++k) {
+            const int n = new_children.at(k);
+            const QString *id = m_newNodes.at(n).attributes.find(atoms::Id);
+            if (id) {
+                const int o = m_oldIds.value(*id, -1);
+                if (o >= 0 && m_match.at(o) < 0 && sameName(o, n)) {
+                    pairs[k] = o;
+                    m_match[o] = n;
                 }
-                QPointF c1;
-                if (lastMode == 'c' || lastMode == 'C' || lastMode == 's' || lastMode == 'S')
-                    c1 = QPointF(2 * x - ctrlPt.x(), 2 * y - ctrlPt.y());
-                else
-                    c1 = QPointF(x, y);
-                QPointF c2(num[0] + offsetX, num[1] + offsetY);
-                QPointF e(num[2] + offsetX, num[3] + offsetY);
-                num += 4;
-                count -= 4;
-                path.cubicTo(c1, c2, e);
-                ctrlPt = c2;
-                x = e.x();
-                y = e.y();
-                break;
             }
-            case 'S': {
-                if (count < 4) {
-                    num += count;
-                    count = 0;
-                    break;
-                }
-                QPointF c1;
-                if (lastMode == 'c' || lastMode == 'C' || lastMode == 's' || lastMode == 'S')
-                    c1 = QPointF(2 * x - ctrlPt.x(), 2 * y - ctrlPt.y());
-                else
-                    c1 = QPointF(x, y);
-                QPointF c2(num[0], num[1]);
-                QPointF e(num[2], num[3]);
-                num += 4;
-                count -= 4;
-                path.cubicTo(c1, c2, e);
-                ctrlPt = c2;
-                x = e.x();
-                y = e.y();
-                break;
+        }
+        int next = 0;
+        for (int k = 0; k < new_children.size(); ++k) {
+            if (pairs.at(k) >= 0) {
+                continue;
             }
-            case 'q': {
-                if (count < 4) {
-                    num += count;
-                    count = 0;
+            const int n = new_children.at(k);
+            for (int j = next; j < old_children.size(); ++j) {
+                const int o = old_children.at(j);
+                if (m_match.at(o) < 0 && isPositional(o) && sameName(o, n)) {
+                    pairs[k] = o;
+                    m_match[o] = n;
+                    next = j + 1;
                     break;
                 }
-                QPointF c(num[0] + offsetX, num[1] + offsetY);
-                QPointF e(num[2] + offsetX, num[3] + offsetY);
-                num += 4;
-                count -= 4;
-                path.quadTo(c, e);
-                ctrlPt = c;
-                x = e.x();
-                y = e.y();
-                break;
             }
-            case 'Q': {
-                if (count < 4) {
-                    num += count;
-                    count = 0;
-                    break;
-                }
-                QPointF c(num[0], num[1]);
-                QPointF e(num[2], num[3]);
-                num += 4;
-                count -= 4;
-                path.quadTo(c, e);
-                ctrlPt = c;
-                x = e.x();
-                y = e.y();
-                break;
+        }
+
+        int previous = -1;
+        for (int k = 0; k < new_children.size(); ++k) {
+            const int o = pairs.at(k);
+            const int n = new_children.at(k);
+            if (o < 0 || !update(o, n)) {
+                create(n);
+            } else if (o < previous) {
+                // Reordered by id.
+                m_restack.insert(parentNode(n));
             }
-            case 't': {
-                if (count < 2) {
-                    num += count;
-                    count = 0;
-                    break;
-                }
-                QPointF e(num[0] + offsetX, num[1] + offsetY);
-                num += 2;
-                count -= 2;
-                QPointF c;
-                if (lastMode == 'q' || lastMode == 'Q' || lastMode == 't' || lastMode == 'T')
-                    c = QPointF(2 * x - ctrlPt.x(), 2 * y - ctrlPt.y());
-                else
-                    c = QPointF(x, y);
-                path.quadTo(c, e);
-                ctrlPt = c;
-                x = e.x();
-                y = e.y();
-                break;
+            previous = qMax(previous, o);
+        }
+    }
+
+    /** Updates the item of the matched element, false when it has to be recreated. */
+    bool update(int old_index, int new_index) {
+        const SvgNode &node = m_newNodes.at(new_index);
+        if (isText(node.kind)) {
+            if (!sameSubtree(old_index, new_index)) {
+                m_match[old_index] = -1;
+                return false;
             }
-            case 'T': {
-                if (count < 2) {
-                    num += count;
-                    count = 0;
-                    break;
-                }
-                QPointF e(num[0], num[1]);
-                num += 2;
-                count -= 2;
-                QPointF c;
-                if (lastMode == 'q' || lastMode == 'Q' || lastMode == 't' || lastMode == 'T')
-                    c = QPointF(2 * x - ctrlPt.x(), 2 * y - ctrlPt.y());
-                else
-                    c = QPointF(x, y);
-                path.quadTo(c, e);
-                ctrlPt = c;
-                x = e.x();
-                y = e.y();
-                break;
+            for (int i = 0; i < node.end - new_index; ++i) {
+                m_match[old_index + i] = new_index + i;
+                m_items[new_index + i] = m_oldItems.at(old_index + i);
             }
-            case 'a': {
-                if (count < 7) {
-                    num += count;
-                    count = 0;
-                    break;
-                }
-                qreal rx = (*num++);
-                qreal ry = (*num++);
-                qreal xAxisRotation = (*num++);
-                qreal largeArcFlag = (*num++);
-                qreal sweepFlag = (*num++);
-                qreal ex = (*num++) + offsetX;
-                qreal ey = (*num++) + offsetY;
-                count -= 7;
-                qreal curx = x;
-                qreal cury = y;
-                pathArc(
-                    path, rx, ry, xAxisRotation, int(largeArcFlag), int(sweepFlag), ex, ey, curx,
-                    cury);
-                x = ex;
-                y = ey;
-            } break;
-            case 'A': {
-                if (count < 7) {
-                    num += count;
-                    count = 0;
-                    break;
-                }
-                qreal rx = (*num++);
-                qreal ry = (*num++);
-                qreal xAxisRotation = (*num++);
-                qreal largeArcFlag = (*num++);
-                qreal sweepFlag = (*num++);
-                qreal ex = (*num++);
-                qreal ey = (*num++);
-                count -= 7;
-                qreal curx = x;
-                qreal cury = y;
-                pathArc(
-                    path, rx, ry, xAxisRotation, int(largeArcFlag), int(sweepFlag), ex, ey, curx,
-                    cury);
-                x = ex;
-                y = ey;
-            } break;
-            default: return false;
+        } else {
+            m_items[new_index] = m_oldItems.at(old_index);
+        }
+
+        QGraphicsItem *item = m_items.at(new_index);
+        if (item) {
+            QGraphicsItem *parent = parentItem(new_index);
+            const bool moved = item->parentItem() != parent;
+            const bool changed = !sameNode(old_index, new_index);
+            if ((moved || changed) && m_handler->m_indexedSearch) {
+                // Indexed again at the end, by the new attributes under the new parent.
+                m_handler->m_index->remove(
+                    old_index, item, m_oldNodes.at(old_index).attributes, *m_old.atoms());
+                m_updatedNodes.append(new_index);
+            }
+            if (moved) {
+                item->setParentItem(parent);
+                m_restack.insert(parentNode(new_index));
             }
-            lastMode = pathElem.toLatin1();
+            if (changed) {
+                // Replaces the record of the item in the table.
+                apply(item, new_index);
+                ++m_updated;
+            }
+        }
+        if (!isText(node.kind)) {
+            matchChildren(old_index, new_index);
         }
+        return true;
     }
-    return true;
-}
 
-SvgHandler::SvgHandler(QGraphicsScene *scene) : m_scene(scene) {}
+    /** Sets everything the handler derives from the element to the item. */
+    void apply(QGraphicsItem *item, int index) {
+        const SvgNode &node = m_newNodes.at(index);
+        SvgElement el(m_new.atoms()->name(node.name));
+        el.atom = node.name;
+        el.xmlAttributes = node.attributes;
+        el.style = node.style;
+        m_handler->setElementMetadata(item, el);
 
-SvgHandler::~SvgHandler() = default;
+        QAbstractGraphicsShapeItem *shape = itemCast<QAbstractGraphicsShapeItem>(item);
+        const bool is_group = node.kind == SvgNodeKind::Group
+                              || node.kind == SvgNodeKind::Hyperlink;
+        if (shape) {
+            // New items start with the defaults, which the style only overrides.
+            shape->setBrush(QBrush());
+            shape->setPen(QPen());
+            m_handler->setStyle(shape, is_group ? node.ownStyle : node.style);
+        }
+        if (node.kind == SvgNodeKind::Rect) {
+            if (auto *rect = itemCast<QGraphicsRectItem>(item)) {
+                rect->setRect(node.geometry);
+            }
+        } else if (node.kind == SvgNodeKind::Circle || node.kind == SvgNodeKind::Ellipse) {
+            if (auto *ellipse = itemCast<QGraphicsEllipseItem>(item)) {
+                ellipse->setRect(node.geometry);
+            }
+        } else if (node.kind == SvgNodeKind::Path) {
+            if (auto *path = itemCast<QGraphicsPathItem>(item)) {
+                path->setPath(m_new.path(node));
+            }
+        }
+        item->setTransform(m_new.transform(node));
+    }
 
-void SvgHandler::load(QXmlStreamReader *data, bool skip_definitions) {
-    m_skipDefinitions = skip_definitions;
-    m_xml = data;
-    m_defaultPen = QPen(Qt::black, 1, Qt::SolidLine, Qt::FlatCap, Qt::SvgMiterJoin);
-    m_defaultPen.setMiterLimit(4);
-    parse();
-    /*
-    QGraphicsRectItem *it = new QGraphicsRectItem();
-    it->setRect(m_scene->sceneRect());
-    it->setPen(QPen(Qt::blue));
-    m_scene->addItem(it);
-    */
-}
+    void create(int index) {
+        m_handler->replayUnder(m_new, index, m_newNodes.at(index).end, parentItem(index));
+        m_restack.insert(parentNode(index));
+        m_createdNodes.append(index);
+        ++m_created;
+    }
 
-void SvgHandler::parse() {
-    m_xml->setNamespaceProcessing(false);
-    bool done = false;
+    /** Nearest ancestor with an item. */
+    int parentNode(int index) const {
+        int parent = m_newNodes.at(index).parent;
+        while (parent >= 0 && !m_items.at(parent)) {
+            parent = m_newNodes.at(parent).parent;
+        }
+        return parent;
+    }
 
-    m_elementStack.push(SvgElement::initial_element());
+    QGraphicsItem *parentItem(int index) const {
+        const int parent = parentNode(index);
+        return (parent >= 0) ? m_items.at(parent) : nullptr;
+    }
 
-    while (!m_xml->atEnd() && !done) {
-        switch (m_xml->readNext()) {
-        case QXmlStreamReader::StartElement: {
-            SvgElement el(m_xml->name().toString());
-            if (el.name == QLatin1String("defs")) {
-                if (m_skipDefinitions) {
-                    m_xml->skipCurrentElement();
-                }
+    void removeUnmatched() {
+        for (int i = 0; i < m_oldNodes.size(); ++i) {
+            if (m_match.at(i) < 0 && m_oldItems.at(i)) {
+                // Matched descendants were moved to their new parents already.
+                release(i);
+                delete m_oldItems.at(i);
+                ++m_removed;
+                i = m_oldNodes.at(i).end - 1;
             }
-            el.styleAttributes = m_elementStack.last().styleAttributes;
-            el.xmlAttributes = parseXmlAttributes(m_xml->attributes(), el.styleAttributes);
-            DEBUG() << QString(m_elementStack.count(), '-') << ">"
-                    << "+ start element:" << el.name << "id:" << el.xmlAttributes.value("id");
-            mergeCSSAttributes(el.styleAttributes, QStringLiteral("style"), el.xmlAttributes);
-            m_elementStack.push(el);
-            bool is_item_created = startElement();
-            m_elementStack.last().itemCreated = is_item_created;
-            break;
         }
-        case QXmlStreamReader::EndElement: {
-            SvgElement svg_element = m_elementStack.pop();
-            DEBUG() << QString(m_elementStack.count(), '-') << ">"
-                    << "- end element:" << m_xml->name()
-                    << "item created:" << svg_element.itemCreated;
-            if (svg_element.itemCreated && m_topLevelItem) {
-                // logSvgI() << "m_topLevelItem:" << m_topLevelItem << typeid
-                // (*m_topLevelItem).name() << svg_element.name;
-                installVisuController(m_topLevelItem, svg_element);
-                m_topLevelItem = m_topLevelItem->parentItem();
+    }
+
+    /** Drops the records and index entries of the items deleted with the item of the node. */
+    void release(int index) {
+        ElementTable &elements = *m_handler->m_elements;
+        for (int i = index; i < m_oldNodes.at(index).end; ++i) {
+            QGraphicsItem *item = m_oldItems.at(i);
+            if (m_match.at(i) >= 0 || item == nullptr) {
+                continue;
+            }
+            if (m_handler->m_indexedSearch) {
+                m_handler->m_index->remove(i, item, m_oldNodes.at(i).attributes, *m_old.atoms());
+            }
+            const int element = getElementIndex(item);
+            if (element >= 0) {
+                elements.release(element);
             }
-            break;
         }
-        case QXmlStreamReader::Characters: {
-            DEBUG() << "characters element:" << m_xml->text(); // << typeid
-                                                               // (*m_topLevelItem).name();
-            if (auto *text_item = dynamic_cast<SimpleTextItem *>(m_topLevelItem)) {
-                QString text = text_item->text();
-                if (!text.isEmpty())
-                    text += '\n';
-                DEBUG() << text_item->text() << "+" << m_xml->text().toString();
-                text_item->setText(text + m_xml->text().toString());
-            } else if (auto *text_item = dynamic_cast<QGraphicsTextItem *>(m_topLevelItem)) {
-                QString text = text_item->toPlainText();
-                if (!text.isEmpty())
-                    text += '\n';
-                text_item->setPlainText(text + m_xml->text());
-                // nInfo() << text_item->toPlainText();
-            } else {
-                DEBUG() << "characters are not part of text item, will be ignored";
-                // nWarning() << "top:" << m_topLevelItem << (m_topLevelItem?
-                // typeid (*m_topLevelItem).name(): "NULL");
+    }
+
+    /**
+     * Moves the index to the new node numbers and indexes the updated and created elements.
+     * Entries of the other elements are only renumbered, if elements were added or removed
+     * before them.
+     */
+    void reindex() {
+        if (!m_handler->m_indexedSearch) {
+            return;
+        }
+        SvgIndex &index = *m_handler->m_index;
+        for (int i = 0; i < m_match.size(); ++i) {
+            if (m_match.at(i) >= 0 && m_match.at(i) != i) {
+                index.renumber(m_match);
+                break;
             }
-            break;
         }
-        case QXmlStreamReader::ProcessingInstruction:
-            DEBUG() << "ProcessingInstruction:" << m_xml->processingInstructionTarget()
-                    << m_xml->processingInstructionData();
-            // processingInstruction(xml->processingInstructionTarget().toString(),
-            // xml->processingInstructionData().toString());
-            break;
-        default: break;
+        const AtomTable &atoms = *m_new.atoms();
+        for (int node : m_updatedNodes) {
+            const SvgNode &updated = m_newNodes.at(node);
+            index.insert(node, parentNode(node), m_items.at(node), updated.attributes, atoms);
+        }
+        for (int node : m_createdNodes) {
+            for (int i = node; i < m_newNodes.at(node).end; ++i) {
+                if (m_items.at(i) != nullptr) {
+                    const SvgNode &created = m_newNodes.at(i);
+                    index.insert(i, parentNode(i), m_items.at(i), created.attributes, atoms);
+                }
+            }
+        }
+    }
+
+    /** Puts children of the node's item into document order. */
+    void restack(int parent) {
+        if (parent < 0) {
+            return;
+        }
+        QGraphicsItem *parent_item = m_items.at(parent);
+        QVector<QGraphicsItem *> children;
+        for (int i = parent + 1; i < m_newNodes.at(parent).end; ++i) {
+            QGraphicsItem *item = m_items.at(i);
+            if (item && item->parentItem() == parent_item) {
+                children.append(item);
+                i = m_newNodes.at(i).end - 1;
+            }
+        }
+        for (int i = children.size() - 2; i >= 0; --i) {
+            children.at(i)->stackBefore(children.at(i + 1));
         }
     }
+
+    SvgHandler *m_handler;
+    const SvgTree m_old;
+    const SvgTree &m_new;
+    const QVector<SvgNode> &m_oldNodes;
+    const QVector<SvgNode> &m_newNodes;
+    const QVector<QGraphicsItem *> m_oldItems;
+    /** Items of the new nodes, filled by the matching and by the replay of created elements. */
+    QVector<QGraphicsItem *> &m_items;
+    /** Index of the new node matched to each old node, or -1. */
+    QVector<int> m_match;
+    QVector<Atom> m_atomMap;
+    QHash<QString, int> m_oldIds;
+    QSet<QString> m_newIds;
+    /** New nodes whose item has children out of document order. */
+    QSet<int> m_restack;
+    /** New nodes of items updated or moved, and the first nodes of the created subtrees. */
+    QVector<int> m_updatedNodes;
+    QVector<int> m_createdNodes;
+    int m_updated = 0;
+    int m_created = 0;
+    int m_removed = 0;
+};
+
+bool SvgHandler::reload(const SvgTree &tree) {
+    if (root) {
+        LazySubtreeItem::expandAll(root);
+    }
+    Reload state(this, tree);
+    return state.run();
 }
 
-bool SvgHandler::startElement() {
+bool reloadFromFileName(
+    const SvgDocument &document,
+    const QString &filename,
+    const ParseOptions &options) {
+    const QSharedPointer<SvgHandler> handler = document.getHandler();
+    if (!handler) {
+        WARN() << "document was not created by a shared handler, cannot reload";
+        return false;
+    }
+    return handler->reload(parseTreeFromFileName(filename, options));
+}
+
+void SvgHandler::endElement() {
+    const SvgElement svg_element = m_elementStack.takeLast();
+    DEBUG() << QString(m_elementStack.count(), '-') << ">"
+            << "- end element:" << svg_element.name << "item created:" << svg_element.itemCreated;
+    if (svg_element.itemCreated && m_topLevelItem) {
+        // logSvgI() << "m_topLevelItem:" << m_topLevelItem << typeid
+        // (*m_topLevelItem).name() << svg_element.name;
+        installVisuController(m_topLevelItem, svg_element);
+        m_topLevelItem = m_topLevelItem->parentItem();
+    }
+}
+
+void SvgHandler::characters(const QString &characters) {
+    PhaseTimer timer(profile(), ParsePhase::Text);
+    if (auto *text_item = itemCast<SimpleTextItem>(m_topLevelItem)) {
+        QString text = text_item->text();
+        if (!text.isEmpty())
+            text += '\n';
+        DEBUG() << text_item->text() << "+" << characters;
+        text_item->setText(text + characters);
+    } else if (auto *text_item = itemCast<QGraphicsTextItem>(m_topLevelItem)) {
+        QString text = text_item->toPlainText();
+        if (!text.isEmpty())
+            text += '\n';
+        text_item->setPlainText(text + characters);
+        // nInfo() << text_item->toPlainText();
+    } else {
+        DEBUG() << "characters are not part of text item, will be ignored";
+        // nWarning() << "top:" << m_topLevelItem << (m_topLevelItem?
+        // typeid (*m_topLevelItem).name(): "NULL");
+    }
+}
+
+bool SvgHandler::startElement(const SvgTree &tree, const SvgNode &node) {
     const SvgElement &el = m_elementStack.last();
     if (!m_topLevelItem) {
-        if (el.name == QLatin1String("svg")) {
+        if (node.kind == SvgNodeKind::Svg) {
             m_topLevelItem = new QGraphicsRectItem();
+            // Only the metadata, so that selectors can refer to the root element.
+            storeElement(m_topLevelItem, node.name, el.xmlAttributes, el.style);
+            attachElements();
+            PhaseTimer timer(profile(), ParsePhase::SceneInsertion);
             m_scene->addItem(m_topLevelItem);
             root = m_topLevelItem;
             return true;
@@ -1006,117 +812,84 @@ bool SvgHandler::startElement() {
         }
         return false;
     } else {
-        if (el.name == QLatin1String("g")) {
+        if (node.kind == SvgNodeKind::Group) {
             QGraphicsItem *item = createGroupItem(el);
             if (item) {
                 setElementMetadata(item, el);
-                if (auto *rect_item = dynamic_cast<QGraphicsRectItem *>(item)) {
-                    setStyle(rect_item, el.xmlAttributes);
+                if (auto *rect_item = itemCast<QGraphicsRectItem>(item)) {
+                    setStyle(rect_item, node.ownStyle);
                 }
-                setTransform(item, el.xmlAttributes.value(QStringLiteral("transform")));
+                setTransform(item, tree, node);
                 addItem(item);
                 return true;
             }
             return false;
-        } else if (el.name == QLatin1String("a")) {
+        } else if (node.kind == SvgNodeKind::Hyperlink) {
             QGraphicsItem *item = createHyperlinkItem(el);
             if (item) {
                 setElementMetadata(item, el);
-                if (auto *rect_item = dynamic_cast<QGraphicsRectItem *>(item)) {
-                    setStyle(rect_item, el.xmlAttributes);
+                if (auto *rect_item = itemCast<QGraphicsRectItem>(item)) {
+                    setStyle(rect_item, node.ownStyle);
                 }
-                setTransform(item, el.xmlAttributes.value(QStringLiteral("transform")));
+                setTransform(item, tree, node);
                 addItem(item);
                 return true;
             }
             return false;
-        } else if (el.name == QLatin1String("rect")) {
-            qreal x = el.xmlAttributes.value(QStringLiteral("x")).toDouble();
-            qreal y = el.xmlAttributes.value(QStringLiteral("y")).toDouble();
-            qreal w = el.xmlAttributes.value(QStringLiteral("width")).toDouble();
-            qreal h = el.xmlAttributes.value(QStringLiteral("height")).toDouble();
-            if (auto *text_item = dynamic_cast<QGraphicsTextItem *>(m_topLevelItem)) {
+        } else if (node.kind == SvgNodeKind::Rect) {
+            if (auto *text_item = itemCast<QGraphicsTextItem>(m_topLevelItem)) {
                 QTransform t;
-                t.translate(x, y);
+                t.translate(node.geometry.x(), node.geometry.y());
                 text_item->setTransform(t, true);
-                text_item->setTextWidth(w);
+                text_item->setTextWidth(node.geometry.width());
                 return false;
             } else {
                 auto *item = new QGraphicsRectItem();
                 setElementMetadata(item, el);
-                item->setRect(QRectF(x, y, w, h));
-                setStyle(item, el.styleAttributes);
-                setTransform(item, el.xmlAttributes.value(QStringLiteral("transform")));
+                item->setRect(node.geometry);
+                setStyle(item, el.style);
+                setTransform(item, tree, node);
                 addItem(item);
                 return true;
             }
-        } else if (el.name == QLatin1String("circle")) {
+        } else if (node.kind == SvgNodeKind::Circle || node.kind == SvgNodeKind::Ellipse) {
             auto *item = new QGraphicsEllipseItem();
             setElementMetadata(item, el);
-            qreal cx = toDouble(el.xmlAttributes.value(QStringLiteral("cx")));
-            qreal cy = toDouble(el.xmlAttributes.value(QStringLiteral("cy")));
-            qreal rx = toDouble(el.xmlAttributes.value(QStringLiteral("r")));
-            QRectF r(0, 0, 2 * rx, 2 * rx);
-            r.translate(cx - rx, cy - rx);
-            item->setRect(r);
-            setStyle(item, el.styleAttributes);
-            setTransform(item, el.xmlAttributes.value(QStringLiteral("transform")));
+            item->setRect(node.geometry);
+            setStyle(item, el.style);
+            setTransform(item, tree, node);
             addItem(item);
             return true;
-        } else if (el.name == QLatin1String("ellipse")) {
-            auto *item = new QGraphicsEllipseItem();
-            setElementMetadata(item, el);
-            qreal cx = toDouble(el.xmlAttributes.value(QStringLiteral("cx")));
-            qreal cy = toDouble(el.xmlAttributes.value(QStringLiteral("cy")));
-            qreal rx = toDouble(el.xmlAttributes.value(QStringLiteral("rx")));
-            qreal ry = toDouble(el.xmlAttributes.value(QStringLiteral("ry")));
-            QRectF r(0, 0, 2 * rx, 2 * ry);
-            r.translate(cx - rx, cy - ry);
-            item->setRect(r);
-            setStyle(item, el.styleAttributes);
-            setTransform(item, el.xmlAttributes.value(QStringLiteral("transform")));
-            addItem(item);
-            return true;
-        } else if (el.name == QLatin1String("path")) {
+        } else if (node.kind == SvgNodeKind::Path) {
             auto *item = new QGraphicsPathItem();
             setElementMetadata(item, el);
-            QString data = el.xmlAttributes.value(QStringLiteral("d"));
-            QPainterPath p;
-            parsePathDataFast(QStringRef(&data), p);
-            setStyle(item, el.styleAttributes);
-            static auto FILL_RULE = QStringLiteral("fill-rule");
-            if (el.styleAttributes.value(FILL_RULE) == QLatin1String("evenodd"))
-                p.setFillRule(Qt::OddEvenFill);
-            else
-                p.setFillRule(Qt::WindingFill);
-            item->setPath(p);
-            setTransform(item, el.xmlAttributes.value(QStringLiteral("transform")));
+            setStyle(item, el.style);
+            item->setPath(tree.path(node));
+            setTransform(item, tree, node);
             addItem(item);
             return true;
-        } else if (el.name == QLatin1String("text")) {
-            auto *item = new SimpleTextItem(el.styleAttributes);
+        } else if (node.kind == SvgNodeKind::TextElement) {
+            auto *item = new SimpleTextItem(el.style);
             setElementMetadata(item, el);
-            qreal x = toDouble(el.xmlAttributes.value(QStringLiteral("x")));
-            qreal y = toDouble(el.xmlAttributes.value(QStringLiteral("y")));
-            setStyle(item, el.styleAttributes);
-            setTextStyle(item, el.styleAttributes);
-            setTransform(item, el.xmlAttributes.value(QStringLiteral("transform")));
-            QFontMetricsF fm(item->font());
+            qreal x = node.geometry.x();
+            qreal y = node.geometry.y();
+            setStyle(item, el.style);
+            const qreal ascent = setTextStyle(item, el.style);
+            setTransform(item, tree, node);
             QTransform t;
-            t.translate(x, y - fm.ascent());
+            t.translate(x, y - ascent);
             item->setTransform(t, true);
             addItem(item);
             return true;
-        } else if (el.name == QLatin1String("tspan")) {
-            auto *item = new SimpleTextItem(el.styleAttributes);
+        } else if (node.kind == SvgNodeKind::Tspan) {
+            auto *item = new SimpleTextItem(el.style);
             setElementMetadata(item, el);
-            setStyle(item, el.styleAttributes);
-            setTextStyle(item, el.styleAttributes);
-            setTransform(item, el.xmlAttributes.value(QStringLiteral("transform")));
-            QFontMetricsF fm(item->font());
+            setStyle(item, el.style);
+            const qreal ascent = setTextStyle(item, el.style);
+            setTransform(item, tree, node);
             QTransform t;
-            qreal x = toDouble(el.xmlAttributes.value(QStringLiteral("x")));
-			qreal y = toDouble(el.xmlAttributes.value(QStringLiteral("y")));
+            qreal x = node.geometry.x();
+			qreal y = node.geometry.y();
 			if(x != 0 && y != 0 && m_topLevelItem) {
 				// https://www.w3.org/TR/SVG11/text.html#TSpanElement
 				QPointF p(x, y);
@@ -1124,16 +897,16 @@ bool SvgHandler::startElement() {
 				//p = item->mapToParent(p);
 				t.translate(p.x(), p.y());
 			}
-            t.translate(x, y - fm.ascent());
+            t.translate(x, y - ascent);
             item->setTransform(t, true);
             addItem(item);
             return true;
-        } else if (el.name == QLatin1String("flowRoot")) {
+        } else if (node.kind == SvgNodeKind::FlowRoot) {
             auto *item = new QGraphicsTextItem();
             setElementMetadata(item, el);
             // nWarning() << "FlowRoot:" << (QGraphicsItem*)item;
-            setTextStyle(item, el.styleAttributes);
-            setTransform(item, el.xmlAttributes.value(QStringLiteral("transform")));
+            setTextStyle(item, el.style);
+            setTransform(item, tree, node);
             addItem(item);
             return true;
         } else {
@@ -1161,229 +934,139 @@ void SvgHandler::installVisuController(QGraphicsItem *it, const SvgHandler::SvgE
 }
 
 void SvgHandler::setElementMetadata(QGraphicsItem *item, const SvgElement &svg_element) {
-    item->setData(
-        static_cast<int>(MetadataType::XmlAttributes),
-        QVariant::fromValue(svg_element.xmlAttributes));
-    item->setData(
-        static_cast<int>(MetadataType::CssAttributes),
-        QVariant::fromValue(svg_element.styleAttributes));
+    // Elements made up by subclasses may have only the name.
+    const Atom name = (svg_element.atom != atoms::INVALID) ? svg_element.atom
+                                                           : m_atoms->find(svg_element.name);
+    storeElement(item, name, svg_element.xmlAttributes, svg_element.style);
     setCustomElementMetadata(item, svg_element);
 }
 
-void SvgHandler::setCustomElementMetadata(
-    QGraphicsItem *item,
-    const SvgElement &svg_element) {
-    // NOP - child class may set extra behavior.
+static Atom mapAtom(Atom atom, const QVector<Atom> &map) {
+    return (atom < Atom(map.size())) ? map.at(atom) : atoms::INVALID;
 }
 
-void SvgHandler::setTransform(QGraphicsItem *it, const QString &str_val) {
-    QStringRef transform(&str_val);
-    QMatrix mx = parseTransformationMatrix(transform.trimmed());
-    if (!mx.isIdentity()) {
-        QTransform t(mx);
-        // logSvgI() << typeid (*it).name() << "setting matrix:" << t.dx() <<
-        // t.dy();
-        it->setTransform(t);
+/** Translates the names of the attributes by the map in place, false if none changes. */
+static bool mapAttributes(AttributeList &attributes, const QVector<Atom> &map) {
+    bool changed = false;
+    for (const Attribute &attr : attributes) {
+        if (mapAtom(attr.name, map) != attr.name) {
+            changed = true;
+            break;
+        }
     }
-}
-
-CssAttributes
-SvgHandler::parseXmlAttributes(const QXmlStreamAttributes &attributes, CssAttributes &css) {
-    XmlAttributes xml;
-    for (const QXmlStreamAttribute &attr : attributes) {
-        const auto name = attr.name().toString();
-        const auto value = attr.value().toString();
-        xml[name] = value;
-
-        /*
-         * """
-         * The presentation attributes thus will participate in the CSS2 cascade
-         * as if they were replaced by corresponding CSS style rules placed at
-         * the start of the author style sheet with a specificity of zero. In
-         * general, this means that the presentation attributes have lower
-         * priority than other CSS style rules specified in author style sheets
-         * or ‘style’ attributes.
-         * """
-         * https://www.w3.org/TR/SVG/styling.html#UsingPresentationAttributes
-         */
-        if (svgspec::presentation_attributes.contains(name)) {
-            css[name] = value;
+    if (changed) {
+        AttributeList mapped;
+        for (const Attribute &attr : attributes) {
+            mapped.insert(mapAtom(attr.name, map), attr.value);
         }
+        attributes = mapped;
     }
-    return xml;
+    return changed;
 }
 
-void SvgHandler::mergeCSSAttributes(
-    CssAttributes &css_attributes,
-    const QString &attr_name,
-    const XmlAttributes &xml_attributes) {
-#if QT_VERSION < QT_VERSION_CHECK(5, 15, 0)
-    QStringList css = xml_attributes.value(attr_name).split(';', QString::SkipEmptyParts);
-#else
-    QStringList css = xml_attributes.value(attr_name).split(';', Qt::SkipEmptyParts);
-#endif
-    for (const QString &ss : css) {
-        int ix = ss.indexOf(':');
-        if (ix > 0) {
-            css_attributes[ss.mid(0, ix).trimmed()] = ss.mid(ix + 1).trimmed();
+void SvgHandler::storeElement(
+    QGraphicsItem *item,
+    Atom name,
+    const AttributeList &attributes,
+    const ComputedStyle &style) {
+    Atom element_name = name;
+    AttributeList element_attributes = attributes;
+    ComputedStyle element_style = style;
+    if (!m_elementAtoms.isEmpty()) {
+        // Element of a reloaded tree, the table keeps the atoms of the first one.
+        element_name = mapAtom(name, m_elementAtoms);
+        mapAttributes(element_attributes, m_elementAtoms);
+        AttributeList declared = style->declared;
+        if (mapAttributes(declared, m_elementAtoms)) {
+            element_style.edit().declared = declared;
         }
     }
+    const int index = getElementIndex(item);
+    if (index >= 0 && index < m_elements->size()) {
+        // Item updated by `reload`, it keeps its record.
+        m_elements->set(index, element_name, element_attributes, element_style);
+        return;
+    }
+    const quint32 appended
+        = quint32(m_elements->append(element_name, element_attributes, element_style));
+    item->setData(static_cast<int>(MetadataType::XmlAttributes), QVariant::fromValue(appended));
 }
 
-void SvgHandler::setStyle(QAbstractGraphicsShapeItem *it, const CssAttributes &attributes) {
-    QString fill = attributes.value(QStringLiteral("fill"));
-    if (fill.isEmpty()) {
-        // default fill
-    } else if (fill == QLatin1String("none")) {
-        it->setBrush(Qt::NoBrush);
-    } else {
-        QString opacity = attributes.value(QStringLiteral("fill-opacity"));
-        it->setBrush(parseColor(fill, opacity));
+void SvgHandler::mapElementAtoms() {
+    m_elementAtoms.clear();
+    const QSharedPointer<const AtomTable> table = m_elements->atoms();
+    if (table == m_atoms) {
+        return;
     }
-    QString stroke = attributes.value(QStringLiteral("stroke"));
-    if (stroke.isEmpty() || stroke == QLatin1String("none")) {
-        it->setPen(Qt::NoPen);
-    } else {
-        QString opacity = attributes.value(QStringLiteral("stroke-opacity"));
-        QPen pen(parseColor(stroke, opacity));
-        pen.setWidthF(toDouble(attributes.value(QStringLiteral("stroke-width"))));
-        QString linecap = attributes.value(QStringLiteral("stroke-linecap"));
-        if (linecap == QLatin1String("round"))
-            pen.setCapStyle(Qt::RoundCap);
-        else if (linecap == QLatin1String("square"))
-            pen.setCapStyle(Qt::SquareCap);
-        else // if(linecap == QLatin1String("butt"))
-            pen.setCapStyle(Qt::FlatCap);
-        QString join = attributes.value(QStringLiteral("stroke-linejoin"));
-        if (join == QLatin1String("round"))
-            pen.setJoinStyle(Qt::RoundJoin);
-        else if (join == QLatin1String("bevel"))
-            pen.setJoinStyle(Qt::BevelJoin);
-        else // if( join == QLatin1String("miter"))
-            pen.setJoinStyle(Qt::MiterJoin);
-        QString dash_pattern = attributes.value(QStringLiteral("stroke-dasharray"));
-        if (!(dash_pattern.isEmpty() || dash_pattern == QLatin1String("none"))) {
-            QStringList array = dash_pattern.split(',');
-            QVector<qreal> arr;
-            for (const auto &s : array) {
-                bool ok;
-                double d = s.toDouble(&ok);
-                if (!ok) {
-                    LOG() << "Invalid stroke dash definition:" << dash_pattern;
-                    arr.clear();
-                    break;
+    QSharedPointer<AtomTable> extended;
+    bool identity = true;
+    m_elementAtoms.resize(m_atoms->size());
+    for (int atom = 0; atom < m_atoms->size(); ++atom) {
+        Atom mapped = Atom(atom);
+        if (mapped >= atoms::KNOWN_END) {
+            const QString &name = m_atoms->name(Atom(atom));
+            mapped = extended ? extended->find(name) : table->find(name);
+            if (mapped == atoms::INVALID) {
+                // Records refer to the current table, it is extended by a copy.
+                if (!extended) {
+                    extended.reset(new AtomTable(*table));
                 }
-                arr << d;
-            }
-            if (!arr.isEmpty()) {
-                pen.setDashPattern(arr);
-            }
-        }
-        QString dash_offset = attributes.value(QStringLiteral("stroke-dashoffset"));
-        if (!(dash_offset.isEmpty() || dash_offset == QLatin1String("none"))) {
-            bool ok;
-            double d = dash_offset.toDouble(&ok);
-            if (ok) {
-                pen.setDashOffset(d);
-            } else {
-                LOG() << "Invalid stroke dash offset:" << dash_offset;
+                mapped = extended->intern(name);
             }
         }
-        it->setPen(pen);
+        identity = identity && mapped == Atom(atom);
+        m_elementAtoms[atom] = mapped;
     }
-}
-
-void SvgHandler::setTextStyle(QFont &font, const CssAttributes &attributes) {
-    DEBUG() << "orig font" << font.toString();
-    // font.setStyleName(QString());
-    font.setStyleName(QStringLiteral("Normal"));
-    QString font_size = attributes.value(QStringLiteral("font-size"));
-    if (!font_size.isEmpty()) {
-        DEBUG() << "font_size:" << font_size;
-        if (font_size.endsWith(QLatin1String("px")))
-            font.setPixelSize((int)toDouble(font_size.mid(0, font_size.size() - 2)));
-        else if (font_size.endsWith(QLatin1String("pt")))
-            font.setPointSizeF(toDouble(font_size.mid(0, font_size.size() - 2)));
+    if (extended) {
+        m_elements->setAtoms(extended);
     }
-    QString font_family = attributes.value(QStringLiteral("font-family"));
-    if (!font_family.isEmpty()) {
-        DEBUG() << "font_family:" << font_family;
-        font.setFamily(font_family);
+    if (identity) {
+        m_elementAtoms.clear();
     }
-    font.setWeight(QFont::Normal);
-    QString font_weight = attributes.value(QStringLiteral("font-weight"));
-    if (!font_weight.isEmpty()) {
-        DEBUG() << "font_weight:" << font_weight;
-        if (font_weight == QLatin1String("thin"))
-            font.setWeight(QFont::Thin);
-        else if (font_weight == QLatin1String("light"))
-            font.setWeight(QFont::Light);
-        else if (font_weight == QLatin1String("normal"))
-            font.setWeight(QFont::Normal);
-        else if (font_weight == QLatin1String("medium"))
-            font.setWeight(QFont::Medium);
-        else if (font_weight == QLatin1String("bold"))
-            font.setWeight(QFont::Bold);
-        else if (font_weight == QLatin1String("black"))
-            font.setWeight(QFont::Black);
-    }
-    font.setStretch(QFont::Unstretched);
-    QString font_stretch = attributes.value(QStringLiteral("font-stretch"));
-    if (!font_stretch.isEmpty()) {
-        DEBUG() << "font_stretch:" << font_stretch;
-        if (font_stretch == QLatin1String("ultra-condensed"))
-            font.setStretch(QFont::UltraCondensed);
-        else if (font_stretch == QLatin1String("extra-condensed"))
-            font.setStretch(QFont::ExtraCondensed);
-        else if (font_stretch == QLatin1String("condensed"))
-            font.setStretch(QFont::Condensed);
-        else if (font_stretch == QLatin1String("semi-condensed"))
-            font.setStretch(QFont::SemiCondensed);
-        else if (font_stretch == QLatin1String("semi-expanded"))
-            font.setStretch(QFont::SemiExpanded);
-        else if (font_stretch == QLatin1String("expanded"))
-            font.setStretch(QFont::Expanded);
-        else if (font_stretch == QLatin1String("extra-expanded"))
-            font.setStretch(QFont::ExtraExpanded);
-        else if (font_stretch == QLatin1String("ultra-expanded"))
-            font.setStretch(QFont::UltraExpanded);
-        else // if(font_stretch == QLatin1String("normal"))
-            font.setStretch(QFont::Unstretched);
+}
+
+void SvgHandler::attachElements() {
+    const QSharedPointer<const ElementTable> elements = m_elements;
+    root->setData(static_cast<int>(MetadataType::CssAttributes), QVariant::fromValue(elements));
+}
+
+void SvgHandler::setCustomElementMetadata(
+    QGraphicsItem *item,
+    const SvgElement &svg_element) {
+    // NOP - child class may set extra behavior.
+}
+
+void SvgHandler::setTransform(QGraphicsItem *it, const SvgTree &tree, const SvgNode &node) {
+    if (tree.hasTransform(node)) {
+        // logSvgI() << typeid (*it).name() << "setting matrix:" << t.dx() <<
+        // t.dy();
+        it->setTransform(tree.transform(node));
     }
-    font.setStyle(QFont::StyleNormal);
-    QString font_style = attributes.value(QStringLiteral("font-style"));
-    if (!font_style.isEmpty()) {
-        if (font_style == QLatin1String("normal"))
-            font.setStyle(QFont::StyleNormal);
-        else if (font_style == QLatin1String("italic"))
-            font.setStyle(QFont::StyleItalic);
-        else if (font_style == QLatin1String("oblique"))
-            font.setStyle(QFont::StyleOblique);
+}
+
+void SvgHandler::setStyle(QAbstractGraphicsShapeItem *it, const ComputedStyle &style) {
+    PhaseTimer timer(profile(), ParsePhase::Style);
+    // Items with the same paint share the pen and brush data.
+    const Paint &paint = m_paints.get(style);
+    if (paint.hasBrush) {
+        it->setBrush(paint.brush);
     }
-    DEBUG() << "font"
-            << "px size:" << font.pixelSize() << "pt size:" << font.pointSize()
-            << "stretch:" << font.stretch() << "weight:" << font.weight();
-    DEBUG() << "new font" << font.toString();
+    it->setPen(paint.pen);
 }
 
-void SvgHandler::setTextStyle(QGraphicsSimpleTextItem *text, const CssAttributes &attributes) {
-    QFont f = text->font();
-    setTextStyle(f, attributes);
-    text->setFont(f);
+qreal SvgHandler::setTextStyle(QGraphicsSimpleTextItem *text, const ComputedStyle &style) {
+    PhaseTimer timer(profile(), ParsePhase::Text);
+    // Items with the same font share the font data and its metrics.
+    const ResolvedFont &font = m_fonts.get(style);
+    text->setFont(font.font);
+    return font.ascent;
 }
 
-void SvgHandler::setTextStyle(QGraphicsTextItem *text, const CssAttributes &attributes) {
-    QFont f = text->font();
-    setTextStyle(f, attributes);
-    text->setFont(f);
-    static auto FILL = QStringLiteral("fill");
-    QString fill = attributes.value(FILL);
-    if (fill.isEmpty() || fill == QLatin1String("none")) {
-        // it->setBrush(Qt::NoBrush);
-    } else {
-        static auto FILL_OPACITY = QStringLiteral("fill-opacity");
-        QString opacity = attributes.value(FILL_OPACITY);
-        text->setDefaultTextColor(parseColor(fill, opacity));
+void SvgHandler::setTextStyle(QGraphicsTextItem *text, const ComputedStyle &style) {
+    PhaseTimer timer(profile(), ParsePhase::Text);
+    text->setFont(m_fonts.get(style).font);
+    if (style->fill == PaintType::Color) {
+        text->setDefaultTextColor(style->effectiveFillColor());
     }
 }
 
@@ -1400,9 +1083,10 @@ QString SvgHandler::rect2str(QRectF r) {
 void SvgHandler::addItem(QGraphicsItem *it) {
     if (!m_topLevelItem)
         return;
+    PhaseTimer timer(profile(), ParsePhase::SceneInsertion);
     DEBUG() << "adding item:" << typeid(*it).name() << "pos:" << point2str(it->pos())
             << "bounding rect:" << rect2str(it->boundingRect());
-    if (auto *grp = dynamic_cast<QGraphicsItemGroup *>(m_topLevelItem)) {
+    if (auto *grp = itemCast<QGraphicsItemGroup>(m_topLevelItem)) {
         grp->addToGroup(it);
     } else {
         it->setParentItem(m_topLevelItem);
@@ -1411,15 +1095,84 @@ void SvgHandler::addItem(QGraphicsItem *it) {
 }
 
 SvgDocument SvgHandler::getDocument() const {
-    return SvgDocument(root);
+    QSharedPointer<const SvgIndex> index;
+    if (m_indexedSearch) {
+        index = m_index;
+    }
+    return SvgDocument(root, qSharedPointerConstCast<SvgHandler>(sharedFromThis()), index);
+}
+
+void SvgHandler::reindexItems() {
+    QHash<const QGraphicsItem *, int> nodes;
+    for (int i = 0; i < m_nodeItems.size(); ++i) {
+        // Deleted items are only compared, never dereferenced.
+        if (m_nodeItems.at(i) != nullptr) {
+            nodes.insert(m_nodeItems.at(i), i);
+        }
+    }
+    m_nodeItems.fill(nullptr);
+    m_index->clear();
+    if (root != nullptr) {
+        reindexSubtree(root, nodes, -1);
+    }
+}
+
+void SvgHandler::reindexSubtree(
+    QGraphicsItem *item,
+    const QHash<const QGraphicsItem *, int> &nodes,
+    int parent) {
+    auto it = nodes.constFind(item);
+    const int element = getElementIndex(item);
+    // A new item of the application may have the address of a deleted one, it has no metadata.
+    if (it != nodes.constEnd() && element >= 0) {
+        m_nodeItems[it.value()] = item;
+        if (m_indexedSearch) {
+            const ElementTable &elements = *m_elements;
+            const AttributeList &attributes = elements.attributes(element);
+            m_index->insert(it.value(), parent, item, attributes, *elements.atoms());
+        }
+        parent = it.value();
+    }
+    if (itemCast<LazySubtreeItem>(item) != nullptr) {
+        // Its items are indexed by `loadSubtree`.
+        m_index->subtreeDeferred();
+        return;
+    }
+    for (QGraphicsItem *child : item->childItems()) {
+        reindexSubtree(child, nodes, parent);
+    }
+}
+
+QGraphicsItem *SvgHandler::getRootItem() const {
+    return root;
+}
+
+ParseStats SvgHandler::getStats() const {
+    ParseStats stats = m_tree.stats();
+    stats.paintCacheSize = m_paints.size();
+    stats.paintCacheHits = m_paints.hits();
+    stats.paintCacheMisses = m_paints.misses();
+    stats.fontCacheSize = m_fonts.size();
+    stats.fontCacheHits = m_fonts.hits();
+    stats.fontCacheMisses = m_fonts.misses();
+    if (m_profiling) {
+        stats.profiled = true;
+        stats.profile.add(m_profile);
+    }
+    return stats;
+}
+
+QSharedPointer<const AtomTable> SvgHandler::getAtoms() const {
+    return m_atoms;
+}
+
+QSharedPointer<const ElementTable> SvgHandler::getElements() const {
+    return m_elements;
 }
 
 SvgHandler::SvgElement SvgHandler::SvgElement::initial_element() {
     auto el = SvgHandler::SvgElement();
-    el.styleAttributes = {
-        // TODO Choose some reasonable set.
-        { "stroke-width", "1" },
-    };
+    el.style = SvgTreeBuilder::initialStyle();
     return el;
 }
 } // namespace svgscene
\ No newline at end of file
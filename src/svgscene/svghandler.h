@@ -4,17 +4,26 @@
 
 #pragma once
 
+#include "svgattributes.h"
 #include "svgdocument.h"
+#include "svgfontcache.h"
+#include "svgindex.h"
+#include "svginput.h"
 #include "svgmetadata.h"
+#include "svgpaintcache.h"
+#include "svgreader.h"
+#include "svgstyle.h"
+#include "svgtree.h"
 
 #include <QFile>
+#include <QHash>
 #include <QMap>
 #include <QPen>
+#include <QSharedPointer>
 #include <QStack>
 #include <utility>
 
 class QXmlStreamReader;
-class QXmlStreamAttributes;
 class QGraphicsScene;
 class QGraphicsItem;
 class QGraphicsSimpleTextItem;
@@ -28,27 +37,69 @@ namespace svgscene {
  *
  * @param scene     scene where produced elements will be placed
  * @param filename  path to a SVG file
+ * @param options   see `ParseOptions`
  * @return          an svg document, see `svgdocument.h`
  */
-SvgDocument parseFromFileName(QGraphicsScene *scene, const QString &filename);
+SvgDocument parseFromFileName(
+    QGraphicsScene *scene,
+    const QString &filename,
+    const ParseOptions &options = ParseOptions());
 
 /**
  * Entrypoint for svgscene usage taking QFile handle.
  *
  * @param scene     scene where produced elements will be placed
  * @param filename  path to a SVG file
+ * @param options   see `ParseOptions`, input mode defaults to `InputMode::Device` here
  * @return          an svg document, see `svgdocument.h`
  */
-SvgDocument parseFromFile(QGraphicsScene *scene, QFile *file);
+SvgDocument parseFromFile(
+    QGraphicsScene *scene,
+    QFile *file,
+    const ParseOptions &options = ParseOptions(InputMode::Device));
+
+/**
+ * Second phase of the parse, creates graphics items of a tree produced by `parseTreeFromFile`.
+ * Must be called from the thread owning the scene.
+ *
+ * @param scene     scene where produced elements will be placed
+ * @param tree      see `svgtree.h`
+ * @param lazy      groups create their children on demand, see `SvgHandler::setLazy`
+ * @return          an svg document, see `svgdocument.h`
+ */
+SvgDocument materialize(QGraphicsScene *scene, const SvgTree &tree, bool lazy = false);
+
+/**
+ * Variant of the above using the options of item creation (`lazy`, `indexedAttributes`).
+ */
+SvgDocument materialize(QGraphicsScene *scene, const SvgTree &tree, const ParseOptions &options);
+
+/**
+ * Hot reload, updates items of the document in place to match a modified SVG file. See
+ * `SvgHandler::reload` for details.
+ *
+ * @param document  document created by one of the entrypoints above
+ * @param filename  path to the modified SVG file
+ * @param options   see `ParseOptions`
+ * @return          false, when the document could not be updated, it should be parsed anew
+ */
+bool reloadFromFileName(
+    const SvgDocument &document,
+    const QString &filename,
+    const ParseOptions &options = ParseOptions());
 
 // TODO: make the handler private, i.e. not exposed a in header file.
 //      The above entrypoint makes it uninteresting for library users.
-class SvgHandler {
+class SvgHandler : public QEnableSharedFromThis<SvgHandler> {
 public:
     struct SvgElement {
         QString name;
-        XmlAttributes xmlAttributes;
-        CssAttributes styleAttributes;
+        /** Name in the `AtomTable` of the handler, `atoms::INVALID` when not known. */
+        Atom atom = atoms::INVALID;
+        /** Use `AtomTable` of the handler to resolve names, see `getAtoms()`. */
+        AttributeList xmlAttributes;
+        /** Shared with the parent element unless some property is overridden. */
+        ComputedStyle style;
         bool itemCreated = false;
 
         SvgElement() = default;
@@ -64,11 +115,94 @@ public:
     virtual ~SvgHandler();
 
     void load(QXmlStreamReader *data, bool is_skip_definitions = false);
+    void load(SvgReader *reader, bool is_skip_definitions = false);
+    /** Creates items of an already parsed document. */
+    void load(const SvgTree &tree);
+    /**
+     * Creates items of the first `count` nodes of a tree in steps, the tree may be still being
+     * read (see `SvgStreamLoader`). Each call creates items of the nodes up to `count` not created
+     * yet and ends elements closed meanwhile. The tree must be the same (possibly grown) one in all
+     * calls, the last call passes the complete tree with `complete` set. Lazy materialization is
+     * not used.
+     */
+    void loadIncrement(const SvgTree &tree, int count, bool complete);
+
+    /**
+     * Lazy materialization of large groups. Descendants of a group item are not created by `load`,
+     * the group gets a placeholder child knowing only their bounds instead (see
+     * `LazySubtreeItem`). The descendants are created, when the placeholder is painted by a view
+     * or when a `SvgDomTree` query descends into the group. Nested groups are deferred again.
+     *
+     * The handler creates the deferred items, it has to be owned by a `QSharedPointer` (the
+     * placeholders keep it alive), otherwise the document is loaded eagerly. Note that
+     * `installVisuController` of a deferred group is called before its children exist.
+     */
+    void setLazy(bool lazy);
+
+    /**
+     * Attributes indexed in addition to `id` and `class`, see `svgindex.h`. Must be set before
+     * the load.
+     */
+    void setIndexedAttributes(const QStringList &names);
+    /**
+     * Documents use the index for searches, see `ParseOptions::indexedSearch`. The items are not
+     * indexed otherwise. Must be set before the load.
+     */
+    void setIndexedSearch(bool indexed);
+    /** Index of the created items, shared with the documents. */
+    QSharedPointer<const SvgIndex> getIndex() const;
+    /**
+     * Indexes the items present under the root item again. Items deleted by the application are
+     * dropped from the index and from the items known to `reload`.
+     */
+    void reindexItems();
+
+    /**
+     * Updates items of the loaded document to match a modified version of it.
+     *
+     * Elements are matched by `id` first, then by position among siblings with the same name.
+     * Matched elements keep their items (and thus connections and cached `SvgDomTree`s), only
+     * changed attributes, style, geometry and transform are applied to them. Items are created
+     * and deleted only for elements added and removed. Text elements are compared as a whole and
+     * recreated when anything inside them changes. Deferred subtrees of a lazy document are
+     * expanded first.
+     *
+     * The metadata table and the index of the document are kept, only the entries of updated,
+     * created and removed elements change.
+     *
+     * Items must not have been deleted by the application since the load.
+     *
+     * @return  false, when the document cannot be updated (the tree has no `svg` root or nothing
+     *          was loaded), items are left untouched then
+     */
+    bool reload(const SvgTree &tree);
 
     static QString point2str(QPointF r);
     static QString rect2str(QRectF r);
 
     SvgDocument getDocument() const;
+    /** Item of the root element, null until it is created. */
+    QGraphicsItem *getRootItem() const;
+
+    /**
+     * Statistics of the tree phase and of the item creation (paint and font sharing). When
+     * profiling, the profile of the tree is extended by the phases of the item creation.
+     */
+    ParseStats getStats() const;
+
+    /**
+     * Measures the phases of the item creation, see `svgstats.h`. Enabled by loading a tree
+     * parsed with `ParseOptions::profile`.
+     */
+    void setProfiling(bool profiling);
+
+    /**
+     * Attribute names interned during the parse of the loaded tree. Records of the items use the
+     * atoms of `getElements()`, which differ after `reload` of a tree with other names.
+     */
+    QSharedPointer<const AtomTable> getAtoms() const;
+    /** Metadata of the created items, see `svgelementtable.h`. */
+    QSharedPointer<const ElementTable> getElements() const;
 
 protected:
     virtual QGraphicsItem *createGroupItem(const SvgElement &el);
@@ -79,30 +213,94 @@ protected:
     QGraphicsScene *m_scene;
 
 private:
-    void parse();
-    static CssAttributes
-    parseXmlAttributes(const QXmlStreamAttributes &attributes, CssAttributes &css);
-    static void mergeCSSAttributes(
-        CssAttributes &css_attributes,
-        const QString &attr_name,
-        const XmlAttributes &xml_attributes);
-
-    static void setTransform(QGraphicsItem *it, const QString &str_val);
-    static void setStyle(QAbstractGraphicsShapeItem *it, const CssAttributes &attributes);
-    static void setTextStyle(QFont &font, const CssAttributes &attributes);
-    static void setTextStyle(QGraphicsSimpleTextItem *text, const CssAttributes &attributes);
-    static void setTextStyle(QGraphicsTextItem *text, const CssAttributes &attributes);
-
-    bool startElement();
+    friend class LazySubtreeItem;
+    /** State of a single `reload`. */
+    class Reload;
+
+    /** Initial state of the replay. */
+    void startLoad(const SvgTree &tree);
+    /**
+     * Creates the items of nodes in range [begin, end) of the tree.
+     *
+     * @param open  indices of elements started but not ended yet, kept between calls
+     */
+    void replay(const SvgTree &tree, int begin, int end, QStack<int> &open);
+    /** Nearest ancestor of the node with an item, -1 if there is none. */
+    int parentNode(const QVector<SvgNode> &nodes, int index) const;
+    /** Creates descendants of the node deferred by lazy materialization under its item. */
+    void loadSubtree(const SvgTree &tree, int index, QGraphicsItem *item);
+    /** Creates the items of nodes in range [begin, end) as children of the item. */
+    void replayUnder(const SvgTree &tree, int begin, int end, QGraphicsItem *item);
+    /** Replaces descendants of the node by a placeholder, false if they must be created now. */
+    bool deferSubtree(const SvgTree &tree, int index);
+
+    void endElement();
+    void characters(const QString &characters);
+
+    static void setTransform(QGraphicsItem *it, const SvgTree &tree, const SvgNode &node);
+    void setStyle(QAbstractGraphicsShapeItem *it, const ComputedStyle &style);
+    /** Returns ascent of the font, text elements are positioned by their baseline. */
+    qreal setTextStyle(QGraphicsSimpleTextItem *text, const ComputedStyle &style);
+    void setTextStyle(QGraphicsTextItem *text, const ComputedStyle &style);
+
+    bool startElement(const SvgTree &tree, const SvgNode &node);
     void addItem(QGraphicsItem *it);
+    /** Profile of the item creation, null when not profiling. */
+    ParseProfile *profile();
+    /**
+     * Step of `reindexItems`, `nodes` maps the previously created items to their nodes. `parent`
+     * is the node of the nearest indexed ancestor.
+     */
+    void reindexSubtree(
+        QGraphicsItem *item,
+        const QHash<const QGraphicsItem *, int> &nodes,
+        int parent);
+    /**
+     * Adds the metadata to the table and stores its position to the item, replaces the record,
+     * when the item has one already.
+     */
+    void storeElement(
+        QGraphicsItem *item,
+        Atom name,
+        const AttributeList &attributes,
+        const ComputedStyle &style);
+    /** Hands the table to the root item, accessors of the metadata find it there. */
+    void attachElements();
+    /** Maps atoms of the loaded tree to the table of `m_elements`, which keeps its atoms. */
+    void mapElementAtoms();
 
 private:
     QGraphicsItem *root = nullptr;
     QStack<SvgElement> m_elementStack;
     QGraphicsItem *m_topLevelItem = nullptr;
-    QXmlStreamReader *m_xml = nullptr;
     QPen m_defaultPen;
-    bool m_skipDefinitions = false;
+    QSharedPointer<const AtomTable> m_atoms;
+    /** Metadata of the items, replaced by each load (not by reload), held by the root item too. */
+    QSharedPointer<ElementTable> m_elements;
+    /**
+     * Atoms of `m_atoms` in the table of `m_elements`, after a reload brought a tree with other
+     * atoms. Empty, when they are the same.
+     */
+    QVector<Atom> m_elementAtoms;
+    bool m_lazy = false;
+    /** Pens and brushes shared by the items of the document. */
+    PaintCache m_paints;
+    /** Fonts and metrics shared by the text items of the document. */
+    FontCache m_fonts;
+    bool m_profiling = false;
+    ParseProfile m_profile;
+    /** Items by attribute values, filled as the items are created. */
+    QSharedPointer<SvgIndex> m_index;
+    bool m_indexedSearch = false;
+    /** The replay does not index the created items, `reload` indexes them at its end. */
+    bool m_reloading = false;
+    /** Loaded document and the item created for each of its nodes, used by `reload`. */
+    SvgTree m_tree;
+    QVector<QGraphicsItem *> m_nodeItems;
+    /** State of `loadIncrement` between calls. */
+    bool m_incremental = false;
+    int m_replayed = 0;
+    QStack<int> m_replayOpen;
 
 protected:
     /**
@@ -0,0 +1,327 @@
+#include "svgindex.h"
+
+#include <QVarLengthArray>
+#include <algorithm>
+
+namespace svgscene {
+
+SvgIndex::SvgIndex(const QStringList &attribute_names) {
+    setAttributeNames(attribute_names);
+}
+
+void SvgIndex::setAttributeNames(const QStringList &attribute_names) {
+    QStringList names { QStringLiteral("id"), QStringLiteral("class") };
+    for (const QString &name : attribute_names) {
+        if (!names.contains(name)) {
+            names.append(name);
+        }
+    }
+    m_attributes.clear();
+    for (const QString &name : names) {
+        AttributeIndex index;
+        index.name = name;
+        m_attributes.append(index);
+    }
+    m_types.clear();
+    m_classes.clear();
+    m_items.clear();
+    m_parents.clear();
+    m_table = nullptr;
+    m_deferred = 0;
+}
+
+bool SvgIndex::isIndexed(const QString &name) const {
+    for (const AttributeIndex &index : m_attributes) {
+        if (index.name == name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void SvgIndex::insertEntry(QVector<Entry> &entries, const Entry &entry) {
+    // Items are created in document order, except for the deferred subtrees.
+    if (entries.isEmpty() || entries.last().node < entry.node) {
+        entries.append(entry);
+        return;
+    }
+    auto position = std::lower_bound(
+        entries.begin(), entries.end(), entry,
+        [](const Entry &a, const Entry &b) { return a.node < b.node; });
+    entries.insert(position, entry);
+}
+
+void SvgIndex::removeEntry(QVector<Entry> &entries, int node) {
+    auto position = std::lower_bound(
+        entries.begin(), entries.end(), node,
+        [](const Entry &a, int node) { return a.node < node; });
+    if (position != entries.end() && position->node == node) {
+        entries.erase(position);
+    }
+}
+
+/** Calls `f` with each of the whitespace separated names. */
+template<typename F>
+static void forEachName(const QString &names, F f) {
+    const int size = names.size();
+    int start = 0;
+    while (start < size) {
+        while (start < size && names.at(start).isSpace()) {
+            ++start;
+        }
+        int end = start;
+        while (end < size && !names.at(end).isSpace()) {
+            ++end;
+        }
+        if (end > start) {
+            f(names.mid(start, end - start));
+        }
+        start = end;
+    }
+}
+
+void SvgIndex::insertClasses(const QString &classes, const Entry &entry) {
+    forEachName(classes, [this, &entry](const QString &name) {
+        QVector<Entry> &entries = m_classes[name];
+        auto position = std::lower_bound(
+            entries.begin(), entries.end(), entry,
+            [](const Entry &a, const Entry &b) { return a.node < b.node; });
+        // The same name may be listed twice.
+        if (position == entries.end() || position->node != entry.node) {
+            entries.insert(position, entry);
+        }
+    });
+}
+
+void SvgIndex::resolve(const AtomTable &atoms) {
+    if (m_table != &atoms) {
+        // Names are resolved once per table, then the attributes are found by atom.
+        m_table = &atoms;
+        for (AttributeIndex &index : m_attributes) {
+            index.atom = atoms.find(index.name);
+        }
+    }
+}
+
+void SvgIndex::insert(
+    int node,
+    int parent,
+    QGraphicsItem *item,
+    const AttributeList &attributes,
+    const AtomTable &atoms) {
+    resolve(atoms);
+    if (node >= m_items.size()) {
+        m_items.resize(node + 1);
+        m_parents.resize(node + 1);
+    }
+    m_items[node] = item;
+    m_parents[node] = parent;
+    const Entry entry { node, item };
+    insertEntry(m_types[item->type()], entry);
+    if (const QString *classes = attributes.find(atoms::Class)) {
+        insertClasses(*classes, entry);
+    }
+    for (AttributeIndex &index : m_attributes) {
+        const QString *value = (index.atom == atoms::INVALID) ? nullptr
+                                                                : attributes.find(index.atom);
+        if (value != nullptr) {
+            insertEntry(index.all, entry);
+            insertEntry(index.byValue[*value], entry);
+        }
+    }
+}
+
+void SvgIndex::remove(
+    int node,
+    const QGraphicsItem *item,
+    const AttributeList &attributes,
+    const AtomTable &atoms) {
+    resolve(atoms);
+    if (node < m_items.size()) {
+        m_items[node] = nullptr;
+    }
+    auto type = m_types.find(item->type());
+    if (type != m_types.end()) {
+        removeEntry(type.value(), node);
+    }
+    if (const QString *classes = attributes.find(atoms::Class)) {
+        forEachName(*classes, [this, node](const QString &name) {
+            auto it = m_classes.find(name);
+            if (it != m_classes.end()) {
+                removeEntry(it.value(), node);
+            }
+        });
+    }
+    for (AttributeIndex &index : m_attributes) {
+        const QString *value = (index.atom == atoms::INVALID) ? nullptr
+                                                                : attributes.find(index.atom);
+        if (value != nullptr) {
+            removeEntry(index.all, node);
+            auto it = index.byValue.find(*value);
+            if (it != index.byValue.end()) {
+                removeEntry(it.value(), node);
+            }
+        }
+    }
+}
+
+/** Maps nodes of the entries, drops the unmapped ones and restores document order. */
+static void renumberEntries(QVector<SvgIndex::Entry> &entries, const QVector<int> &nodes) {
+    int kept = 0;
+    bool sorted = true;
+    for (int i = 0; i < entries.size(); ++i) {
+        const int node = nodes.value(entries.at(i).node, -1);
+        if (node < 0) {
+            continue;
+        }
+        if (kept > 0 && entries.at(kept - 1).node > node) {
+            sorted = false;
+        }
+        entries[kept++] = SvgIndex::Entry { node, entries.at(i).item };
+    }
+    entries.resize(kept);
+    if (!sorted) {
+        using Entry = SvgIndex::Entry;
+        std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+            return a.node < b.node;
+        });
+    }
+}
+
+void SvgIndex::renumber(const QVector<int> &nodes) {
+    QVector<QGraphicsItem *> items;
+    QVector<int> parents;
+    for (int node = 0; node < m_items.size(); ++node) {
+        const int renumbered = nodes.value(node, -1);
+        if (m_items.at(node) == nullptr || renumbered < 0) {
+            continue;
+        }
+        if (renumbered >= items.size()) {
+            items.resize(renumbered + 1);
+            parents.resize(renumbered + 1);
+        }
+        items[renumbered] = m_items.at(node);
+        const int parent = m_parents.at(node);
+        parents[renumbered] = (parent < 0) ? -1 : nodes.value(parent, -1);
+    }
+    m_items.swap(items);
+    m_parents.swap(parents);
+    for (QVector<Entry> &entries : m_types) {
+        renumberEntries(entries, nodes);
+    }
+    for (QVector<Entry> &entries : m_classes) {
+        renumberEntries(entries, nodes);
+    }
+    for (AttributeIndex &index : m_attributes) {
+        renumberEntries(index.all, nodes);
+        for (QVector<Entry> &entries : index.byValue) {
+            renumberEntries(entries, nodes);
+        }
+    }
+}
+
+void SvgIndex::clear() {
+    for (AttributeIndex &index : m_attributes) {
+        index.all.clear();
+        index.byValue.clear();
+    }
+    m_types.clear();
+    m_classes.clear();
+    m_items.clear();
+    m_parents.clear();
+    m_table = nullptr;
+    m_deferred = 0;
+}
+
+void SvgIndex::subtreeDeferred() {
+    ++m_deferred;
+}
+
+void SvgIndex::subtreeCreated() {
+    --m_deferred;
+}
+
+void SvgIndex::subtreeDropped() {
+    // The index may have been cleared since the subtree was deferred.
+    if (m_deferred > 0) {
+        --m_deferred;
+    }
+}
+
+bool SvgIndex::isComplete() const {
+    return m_deferred == 0;
+}
+
+const QVector<SvgIndex::Entry> *SvgIndex::find(const QString &name, const QString &value) const {
+    if (!isComplete()) {
+        return nullptr;
+    }
+    for (const AttributeIndex &index : m_attributes) {
+        if (index.name != name) {
+            continue;
+        }
+        if (value.isEmpty()) {
+            return &index.all;
+        }
+        static const QVector<Entry> none;
+        auto it = index.byValue.constFind(value);
+        return (it == index.byValue.constEnd()) ? &none : &it.value();
+    }
+    return nullptr;
+}
+
+const QVector<SvgIndex::Entry> *SvgIndex::findClass(const QString &name) const {
+    if (!isComplete()) {
+        return nullptr;
+    }
+    static const QVector<Entry> none;
+    auto it = m_classes.constFind(name);
+    return (it == m_classes.constEnd()) ? &none : &it.value();
+}
+
+bool SvgIndex::isUnder(const Entry &entry, const QGraphicsItem *ancestor) const {
+    // Nodes from the entry up, found only by the recorded parents. Any of their items may be
+    // deleted, so the items are compared, not accessed.
+    QVarLengthArray<int, 32> chain;
+    int node = entry.node;
+    if (node >= m_items.size() || m_items.at(node) != entry.item) {
+        return false;
+    }
+    chain.append(node);
+    int top = -1;
+    for (node = m_parents.at(node); node >= 0; node = m_parents.at(node)) {
+        if (m_items.at(node) == nullptr) {
+            return false;
+        }
+        if (m_items.at(node) == ancestor) {
+            top = node;
+            break;
+        }
+        chain.append(node);
+    }
+    if (top < 0) {
+        // The ancestor is not an item of an element (or null), the check starts at the root item.
+        top = chain.last();
+        chain.removeLast();
+    }
+    const QGraphicsItem *parent = m_items.at(top);
+    for (int i = chain.size() - 1; i >= 0; --i) {
+        QGraphicsItem *item = m_items.at(chain.at(i));
+        if (!parent->childItems().contains(item)) {
+            return false;
+        }
+        parent = item;
+    }
+    return ancestor == nullptr || m_items.at(top) == ancestor || isDescendant(entry.item, ancestor);
+}
+
+bool isDescendant(const QGraphicsItem *item, const QGraphicsItem *ancestor) {
+    for (const QGraphicsItem *parent = item->parentItem(); parent; parent = parent->parentItem()) {
+        if (parent == ancestor) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace svgscene
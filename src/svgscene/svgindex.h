@@ -0,0 +1,175 @@
+/**
+ * Indexes of the items of a document by attribute value.
+ *
+ * With `ParseOptions::indexedSearch`, `SvgHandler` adds every item it creates to the index of the
+ * document, `SvgDomTree::find` and `findAll` then look the attribute up and keep only the items
+ * inside the searched subtree, instead of visiting the whole subtree. `id` and `class` are always
+ * indexed, further attribute names are set by `ParseOptions::indexedAttributes`. Searches by other
+ * attributes (or without one) walk the tree as before.
+ *
+ * Values are compared as a whole, like the tree search does: an element of class `a b` is found
+ * by `a b`, not by `a`. Class names are indexed separately as well (`findClass`), for selectors.
+ *
+ * Items are also listed by their `QGraphicsItem::type()`, searches for an item class of svgscene
+ * (see `svgitemtype.h`) scan the lists of the types of the class only.
+ *
+ * The index refers to the items, so it must not outlive them. `SvgHandler::reload` updates the
+ * entries of the elements it changes. Items added or deleted by the application are not
+ * reflected, `SvgDocument::rebuildIndex` indexes the present items again. Until then, searches
+ * reject entries of deleted items: `isUnder` follows the nodes of the entry from the searched
+ * item down to the entry and requires each item to still be a child of the previous one, without
+ * touching the items that may have been deleted. The check costs a scan of the children on each
+ * level, so the index should be rebuilt after deleting items anyway.
+ *
+ * @file
+ */
+#pragma once
+
+#include "svgattributes.h"
+#include "svgitemtype.h"
+
+#include <QGraphicsItem>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <algorithm>
+
+namespace svgscene {
+
+class SvgIndex {
+public:
+    /** Item of an element, `node` is its index in the tree (document order). */
+    struct Entry {
+        int node;
+        QGraphicsItem *item;
+    };
+
+    /** Indexes `id`, `class` and the given attribute names. */
+    explicit SvgIndex(const QStringList &attribute_names = QStringList());
+
+    /** Replaces the additional attribute names, the index is cleared. */
+    void setAttributeNames(const QStringList &attribute_names);
+    bool isIndexed(const QString &name) const;
+
+    /**
+     * Adds the item created for the node, items may come in any order.
+     *
+     * @param parent  nearest ancestor node with an item (the parent of the item), -1 for the root
+     */
+    void insert(
+        int node,
+        int parent,
+        QGraphicsItem *item,
+        const AttributeList &attributes,
+        const AtomTable &atoms);
+    /** Removes the item of the node, indexed by `insert` with the same attributes. */
+    void remove(
+        int node,
+        const QGraphicsItem *item,
+        const AttributeList &attributes,
+        const AtomTable &atoms);
+    /**
+     * Moves the entries to new node numbers, `nodes` maps the old ones to the new ones (-1 drops
+     * the entry). Used when elements were added or removed before them.
+     */
+    void renumber(const QVector<int> &nodes);
+    void clear();
+
+    /** A subtree was deferred by lazy materialization, its items are not indexed yet. */
+    void subtreeDeferred();
+    /** A deferred subtree was created (and indexed). */
+    void subtreeCreated();
+    /** A deferred subtree was deleted without being created, its items will never be indexed. */
+    void subtreeDropped();
+    /** Whether all elements are indexed, false while some subtrees are deferred. */
+    bool isComplete() const;
+
+    /**
+     * Items having the attribute (of the value, unless it is empty) in document order, null when
+     * the attribute is not indexed or the index is not complete.
+     */
+    const QVector<Entry> *find(const QString &name, const QString &value) const;
+
+    /**
+     * Items having the name among the (whitespace separated) names of their `class` in document
+     * order, null when the index is not complete.
+     */
+    const QVector<Entry> *findClass(const QString &name) const;
+
+    /**
+     * Appends items of class T (including subclasses) in document order, false when the index is
+     * not complete.
+     */
+    template<typename T>
+    bool findKind(QVector<Entry> &entries) const;
+
+    /**
+     * Whether the item of the entry still exists and is a descendant of the ancestor (not the
+     * ancestor itself). The ancestor must exist. With null, only the existence is checked, from
+     * the root item of the document.
+     */
+    bool isUnder(const Entry &entry, const QGraphicsItem *ancestor) const;
+
+private:
+    struct AttributeIndex {
+        QString name;
+        /** Atom of the name in the table of the last insert. */
+        Atom atom = atoms::INVALID;
+        /** All items having the attribute. */
+        QVector<Entry> all;
+        QHash<QString, QVector<Entry>> byValue;
+    };
+
+    static void insertEntry(QVector<Entry> &entries, const Entry &entry);
+    static void removeEntry(QVector<Entry> &entries, int node);
+    /** Resolves the indexed names in the table, unless it was the last one. */
+    void resolve(const AtomTable &atoms);
+    void insertClasses(const QString &classes, const Entry &entry);
+
+    QVector<AttributeIndex> m_attributes;
+    /** Items by `QGraphicsItem::type()`. */
+    QHash<int, QVector<Entry>> m_types;
+    /** Items by each of their class names. */
+    QHash<QString, QVector<Entry>> m_classes;
+    /** Item and parent node of each indexed node, for `isUnder`. */
+    QVector<QGraphicsItem *> m_items;
+    QVector<int> m_parents;
+    const AtomTable *m_table = nullptr;
+    int m_deferred = 0;
+};
+
+/** Whether the item is a descendant of the ancestor (not the ancestor itself). */
+bool isDescendant(const QGraphicsItem *item, const QGraphicsItem *ancestor);
+
+template<typename T>
+bool SvgIndex::findKind(QVector<Entry> &entries) const {
+    if (!isComplete()) {
+        return false;
+    }
+    int lists = 0;
+    for (auto it = m_types.constBegin(); it != m_types.constEnd(); ++it) {
+        if (isKnownItemType(it.key())) {
+            if (ItemKind<T>::matches(it.key())) {
+                entries += it.value();
+                ++lists;
+            }
+        } else {
+            // Classes of the application, the type does not tell.
+            for (const Entry &entry : it.value()) {
+                if (isUnder(entry, nullptr) && itemCast<T>(entry.item) != nullptr) {
+                    entries.append(entry);
+                }
+            }
+            ++lists;
+        }
+    }
+    if (lists > 1) {
+        std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+            return a.node < b.node;
+        });
+    }
+    return true;
+}
+
+} // namespace svgscene
@@ -0,0 +1,51 @@
+#include "svginput.h"
+
+#include "utils/logging.h"
+
+LOG_CATEGORY("svgscene.input");
+
+namespace svgscene {
+
+SvgInput::SvgInput(QFile *file) : m_file(file) {
+    const qint64 size = file->size();
+    if (size > 0 && !file->isSequential()) {
+        m_map = file->map(0, size);
+    }
+    if (m_map != nullptr) {
+        m_begin = reinterpret_cast<const char *>(m_map);
+        m_size = size;
+    } else {
+        DEBUG() << "Cannot map" << file->fileName() << "reading it instead.";
+        m_buffer = file->readAll();
+        m_begin = m_buffer.constData();
+        m_size = m_buffer.size();
+    }
+}
+
+SvgInput::~SvgInput() {
+    if (m_map != nullptr) {
+        m_file->unmap(m_map);
+    }
+}
+
+bool SvgInput::isMapped() const {
+    return m_map != nullptr;
+}
+
+const char *SvgInput::begin() const {
+    return m_begin;
+}
+
+const char *SvgInput::end() const {
+    return m_begin + m_size;
+}
+
+qint64 SvgInput::size() const {
+    return m_size;
+}
+
+QByteArray SvgInput::bytes() const {
+    return QByteArray::fromRawData(m_begin, static_cast<int>(m_size));
+}
+
+} // namespace svgscene
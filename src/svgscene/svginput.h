@@ -0,0 +1,60 @@
+/**
+ * Raw input of the parser.
+ *
+ * @file
+ */
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+
+namespace svgscene {
+
+/**
+ * How the content of a file is handed to the parser.
+ */
+enum class InputMode {
+    /** Parser reads through the QIODevice buffer. */
+    Device,
+    /**
+     * File is memory mapped and the parser reads the mapped bytes directly. Falls back to
+     * reading the whole file, when the file cannot be mapped (e.g. a pipe).
+     */
+    Mapped,
+};
+
+/**
+ * Whole content of a file as a single contiguous byte range, memory mapped if possible.
+ *
+ * The bytes are only borrowed from the mapping, the input must outlive all views (including
+ * the QByteArray returned by `bytes()`) into it.
+ */
+class SvgInput {
+public:
+    /**
+     * @param file  opened file, must outlive the input
+     */
+    explicit SvgInput(QFile *file);
+    ~SvgInput();
+
+    SvgInput(const SvgInput &) = delete;
+    SvgInput &operator=(const SvgInput &) = delete;
+
+    bool isMapped() const;
+    const char *begin() const;
+    const char *end() const;
+    qint64 size() const;
+
+    /** Bytes wrapped without copying (see `QByteArray::fromRawData`). */
+    QByteArray bytes() const;
+
+private:
+    QFile *m_file;
+    uchar *m_map = nullptr;
+    /** Used only when mapping is not possible. */
+    QByteArray m_buffer;
+    const char *m_begin = nullptr;
+    qint64 m_size = 0;
+};
+
+} // namespace svgscene
@@ -0,0 +1,177 @@
+/**
+ * Kinds of the graphics items created by svgscene.
+ *
+ * Item classes of svgscene report their own `QGraphicsItem::type()` (see `ItemType`), shape and
+ * text items keep the types of the Qt classes. `itemCast` compares the type instead of walking
+ * the class hierarchy by `dynamic_cast`, and `SvgIndex` keeps items of each type in document
+ * order, so that searches for a class of svgscene (see `SvgsceneItem`) scan only the items of that
+ * class. Searches for Qt classes walk the tree, they find the items added by the application too.
+ *
+ * Classes of the application have types unknown here, they are checked by `dynamic_cast` still.
+ *
+ * @file
+ */
+#pragma once
+
+#include <QGraphicsItem>
+#include <type_traits>
+
+namespace svgscene {
+
+class GroupItem;
+class HyperlinkItem;
+class SimpleTextItem;
+class LazySubtreeItem;
+
+/**
+ * `QGraphicsItem::type()` of the item classes of svgscene. The values are stable.
+ */
+enum class ItemType : int {
+    Group = QGraphicsItem::UserType + 0x100,
+    Hyperlink,
+    SimpleText,
+    LazySubtree,
+};
+
+/** Whether the class of items with the type is known to `ItemKind`. */
+inline bool isKnownItemType(int type) {
+    return (type >= QGraphicsPathItem::Type && type <= QGraphicsItemGroup::Type)
+           || (type >= int(ItemType::Group) && type <= int(ItemType::LazySubtree));
+}
+
+/**
+ * Types of the items being instances of class T (including subclasses). Specialized for the
+ * classes of Qt and svgscene, `known` is false for other classes.
+ */
+template<typename T>
+struct ItemKind {
+    static const bool known = false;
+    static bool matches(int) { return false; }
+};
+
+template<>
+struct ItemKind<QGraphicsItem> {
+    static const bool known = true;
+    static bool matches(int) { return true; }
+};
+
+template<>
+struct ItemKind<QAbstractGraphicsShapeItem> {
+    static const bool known = true;
+    static bool matches(int type) {
+        return (type >= QGraphicsPathItem::Type && type <= QGraphicsPolygonItem::Type)
+               || type == QGraphicsSimpleTextItem::Type || type == int(ItemType::Group)
+               || type == int(ItemType::Hyperlink) || type == int(ItemType::SimpleText);
+    }
+};
+
+template<>
+struct ItemKind<QGraphicsPathItem> {
+    static const bool known = true;
+    static bool matches(int type) { return type == QGraphicsPathItem::Type; }
+};
+
+template<>
+struct ItemKind<QGraphicsRectItem> {
+    static const bool known = true;
+    static bool matches(int type) {
+        return type == QGraphicsRectItem::Type || type == int(ItemType::Group)
+               || type == int(ItemType::Hyperlink);
+    }
+};
+
+template<>
+struct ItemKind<QGraphicsEllipseItem> {
+    static const bool known = true;
+    static bool matches(int type) { return type == QGraphicsEllipseItem::Type; }
+};
+
+template<>
+struct ItemKind<QGraphicsTextItem> {
+    static const bool known = true;
+    static bool matches(int type) { return type == QGraphicsTextItem::Type; }
+};
+
+template<>
+struct ItemKind<QGraphicsSimpleTextItem> {
+    static const bool known = true;
+    static bool matches(int type) {
+        return type == QGraphicsSimpleTextItem::Type || type == int(ItemType::SimpleText);
+    }
+};
+
+template<>
+struct ItemKind<QGraphicsItemGroup> {
+    static const bool known = true;
+    static bool matches(int type) { return type == QGraphicsItemGroup::Type; }
+};
+
+template<>
+struct ItemKind<GroupItem> {
+    static const bool known = true;
+    static bool matches(int type) {
+        return type == int(ItemType::Group) || type == int(ItemType::Hyperlink);
+    }
+};
+
+template<>
+struct ItemKind<HyperlinkItem> {
+    static const bool known = true;
+    static bool matches(int type) { return type == int(ItemType::Hyperlink); }
+};
+
+template<>
+struct ItemKind<SimpleTextItem> {
+    static const bool known = true;
+    static bool matches(int type) { return type == int(ItemType::SimpleText); }
+};
+
+template<>
+struct ItemKind<LazySubtreeItem> {
+    static const bool known = true;
+    static bool matches(int type) { return type == int(ItemType::LazySubtree); }
+};
+
+/**
+ * Whether T is an item class of svgscene, its instances in a document are expected to be created
+ * by the handler (and thus indexed).
+ */
+template<typename T>
+struct SvgsceneItem
+    : std::integral_constant<
+          bool,
+          std::is_same<T, GroupItem>::value || std::is_same<T, HyperlinkItem>::value
+              || std::is_same<T, SimpleTextItem>::value> {};
+
+template<typename T>
+T *itemCast(QGraphicsItem *item, std::true_type) {
+    const int type = item->type();
+    if (isKnownItemType(type)) {
+        return ItemKind<T>::matches(type) ? static_cast<T *>(item) : nullptr;
+    }
+    return dynamic_cast<T *>(item);
+}
+
+template<typename T>
+T *itemCast(QGraphicsItem *item, std::false_type) {
+    return dynamic_cast<T *>(item);
+}
+
+/**
+ * Equivalent of `dynamic_cast<T *>(item)`, comparing the type of the item when both the class
+ * and the type are known.
+ */
+template<typename T>
+T *itemCast(QGraphicsItem *item) {
+    if (item == nullptr) {
+        return nullptr;
+    }
+    return itemCast<T>(item, std::integral_constant<bool, ItemKind<T>::known>());
+}
+
+template<typename T>
+const T *itemCast(const QGraphicsItem *item) {
+    return itemCast<T>(const_cast<QGraphicsItem *>(item));
+}
+
+} // namespace svgscene
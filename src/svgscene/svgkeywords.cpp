@@ -0,0 +1,211 @@
+#include "svgkeywords.h"
+
+namespace svgscene {
+
+namespace keywords {
+
+    #define SVGSCENE_KEYWORD_NAME(ident, name) name,
+    #define SVGSCENE_COLOR_NAME(name, argb) name,
+    #define SVGSCENE_COLOR_VALUE(name, argb) argb,
+
+    constexpr const char *KEYWORD_NAMES[] = { SVGSPEC_KEYWORDS(SVGSCENE_KEYWORD_NAME) };
+    constexpr const char *COLOR_NAMES[] = { SVGSPEC_COLOR_KEYWORDS(SVGSCENE_COLOR_NAME) };
+    constexpr QRgb COLOR_VALUES[] = { SVGSPEC_COLOR_KEYWORDS(SVGSCENE_COLOR_VALUE) };
+
+    #undef SVGSCENE_KEYWORD_NAME
+    #undef SVGSCENE_COLOR_NAME
+    #undef SVGSCENE_COLOR_VALUE
+
+    /**
+     * Parameters of a perfect hash. The seed was found by trying seeds until all names of the set
+     * landed in distinct slots.
+     */
+    struct KeywordSet {
+        static constexpr quint32 SEED = 0xa7106195u;
+        static constexpr int BITS = 6;
+        static constexpr int COUNT = sizeof(KEYWORD_NAMES) / sizeof(KEYWORD_NAMES[0]);
+        static constexpr const char *name(int index) { return KEYWORD_NAMES[index]; }
+    };
+
+    struct ColorSet {
+        static constexpr quint32 SEED = 0x57f026b8u;
+        static constexpr int BITS = 10;
+        static constexpr int COUNT = sizeof(COLOR_NAMES) / sizeof(COLOR_NAMES[0]);
+        static constexpr const char *name(int index) { return COLOR_NAMES[index]; }
+    };
+
+    constexpr quint32 lower(quint32 c) {
+        return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+    }
+
+    /** FNV-1a of the lowercase name starting at the seed. */
+    constexpr quint32 hash(const char *name, quint32 seed) {
+        return *name == '\0'
+                   ? seed
+                   : hash(name + 1, (seed ^ lower(static_cast<uchar>(*name))) * 16777619u);
+    }
+
+    template<int... I>
+    struct Indices {};
+
+    template<typename First, typename Second>
+    struct Concat;
+
+    template<int... First, int... Second>
+    struct Concat<Indices<First...>, Indices<Second...>> {
+        using type = Indices<First..., (int(sizeof...(First)) + Second)...>;
+    };
+
+    /** `Indices<0, ..., N - 1>`, built by halving to keep the instantiation depth logarithmic. */
+    template<int N>
+    struct MakeIndices {
+        using type = typename Concat<
+            typename MakeIndices<N / 2>::type,
+            typename MakeIndices<N - N / 2>::type>::type;
+    };
+
+    template<>
+    struct MakeIndices<0> {
+        using type = Indices<>;
+    };
+
+    template<>
+    struct MakeIndices<1> {
+        using type = Indices<0>;
+    };
+
+    template<typename Set>
+    constexpr int slotOf(int index) {
+        return static_cast<int>(hash(Set::name(index), Set::SEED) >> (32 - Set::BITS));
+    }
+
+    template<typename Set>
+    struct NameSlots {
+        short slots[Set::COUNT];
+    };
+
+    template<typename Set, int... Index>
+    constexpr NameSlots<Set> makeNameSlots(Indices<Index...>) {
+        return NameSlots<Set> { { short(slotOf<Set>(Index))... } };
+    }
+
+    /** Slot of each name, computed once per set. */
+    template<typename Set>
+    struct Hashed {
+        static constexpr NameSlots<Set> value
+            = makeNameSlots<Set>(typename MakeIndices<Set::COUNT>::type());
+    };
+
+    template<typename Set>
+    constexpr NameSlots<Set> Hashed<Set>::value;
+
+    /** Entry of the slot: index of the first name hashed to it plus one, 0 for empty slots. */
+    template<typename Set>
+    constexpr quint8 entryOf(int slot, int index) {
+        return index == Set::COUNT                      ? quint8(0)
+               : Hashed<Set>::value.slots[index] == slot ? quint8(index + 1)
+                                                         : entryOf<Set>(slot, index + 1);
+    }
+
+    constexpr int length(const char *name) {
+        return *name == '\0' ? 0 : 1 + length(name + 1);
+    }
+
+    template<typename Set>
+    constexpr int maxLength(int index, int longest) {
+        return index == Set::COUNT ? longest
+                                   : maxLength<Set>(
+                                       index + 1,
+                                       length(Set::name(index)) > longest
+                                           ? length(Set::name(index))
+                                           : longest);
+    }
+
+    /**
+     * Each slot is a separate constant expression, which keeps the evaluations small enough for
+     * the step limits of all compilers.
+     */
+    template<typename Set, int Slot>
+    struct Entry {
+        static constexpr quint8 value = entryOf<Set>(Slot, 0);
+    };
+
+    template<typename Set>
+    struct Table {
+        quint8 slots[1 << Set::BITS];
+    };
+
+    template<typename Set, int... Slot>
+    constexpr Table<Set> makeTable(Indices<Slot...>) {
+        return Table<Set> { { Entry<Set, Slot>::value... } };
+    }
+
+    /** Every name is the entry of its own slot, i.e. no two names collide. */
+    template<typename Set>
+    constexpr bool isPerfect(const Table<Set> &table, int index) {
+        return index == Set::COUNT
+               || (table.slots[slotOf<Set>(index)] == index + 1 && isPerfect(table, index + 1));
+    }
+
+    constexpr Table<KeywordSet> KEYWORD_TABLE
+        = makeTable<KeywordSet>(MakeIndices<1 << KeywordSet::BITS>::type());
+    constexpr Table<ColorSet> COLOR_TABLE
+        = makeTable<ColorSet>(MakeIndices<1 << ColorSet::BITS>::type());
+
+    static_assert(
+        KeywordSet::COUNT + 1 == int(Keyword::Count) && KeywordSet::COUNT < 255,
+        "Keyword enumeration out of sync with svgspec.h");
+    static_assert(ColorSet::COUNT < 255, "Slot entries are 8 bit");
+    static_assert(isPerfect(KEYWORD_TABLE, 0), "Keyword hash collides, search for a new seed");
+    static_assert(isPerfect(COLOR_TABLE, 0), "Color hash collides, search for a new seed");
+
+    /** Index of the only name of the set, which may equal the string, or -1. */
+    template<typename Set>
+    static int candidate(const Table<Set> &table, const QChar *str, int length) {
+        constexpr int max_length = maxLength<Set>(0, 0);
+        if (length > max_length) {
+            return -1;
+        }
+        quint32 h = Set::SEED;
+        for (int i = 0; i < length; ++i) {
+            const ushort c = str[i].unicode();
+            if (c >= 0x80) {
+                return -1;
+            }
+            h = (h ^ lower(c)) * 16777619u;
+        }
+        return table.slots[h >> (32 - Set::BITS)] - 1;
+    }
+
+    static bool equals(const char *name, const QChar *str, int length, bool ignore_case) {
+        for (int i = 0; i < length; ++i) {
+            const quint32 c = str[i].unicode();
+            const quint32 n = static_cast<uchar>(name[i]);
+            if (n == '\0' || (ignore_case ? lower(c) != n : c != n)) {
+                return false;
+            }
+        }
+        return name[length] == '\0';
+    }
+} // namespace keywords
+
+Keyword findKeyword(const QChar *str, int length) {
+    using namespace keywords;
+    const int index = candidate(KEYWORD_TABLE, str, length);
+    if (index < 0 || !equals(KEYWORD_NAMES[index], str, length, false)) {
+        return Keyword::Unknown;
+    }
+    return static_cast<Keyword>(index + 1);
+}
+
+bool findNamedColor(const QChar *str, int length, QRgb *rgb) {
+    using namespace keywords;
+    const int index = candidate(COLOR_TABLE, str, length);
+    if (index < 0 || !equals(COLOR_NAMES[index], str, length, true)) {
+        return false;
+    }
+    *rgb = COLOR_VALUES[index];
+    return true;
+}
+
+} // namespace svgscene
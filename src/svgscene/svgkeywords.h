@@ -0,0 +1,53 @@
+/**
+ * Lookup of keyword values and named colors.
+ *
+ * Both sets (see `svgspec.h`) are fixed, so each has a perfect hash: a seeded FNV-1a hash of the
+ * ASCII lowercase name, whose top bits select a slot of a small table. The seeds were searched
+ * offline; the slot tables are generated at compile time from the names and a `static_assert`
+ * fails the build, should the seed stop being collision free after the sets change. A lookup
+ * hashes the characters in place, reads one slot and compares one name. It never allocates.
+ *
+ * @file
+ */
+#pragma once
+
+#include "svgspec.h"
+
+#include <QRgb>
+#include <QString>
+#include <QStringRef>
+
+namespace svgscene {
+
+#define SVGSCENE_KEYWORD_ENUMERATOR(ident, name) ident,
+
+/**
+ * Keyword values of presentation attributes, in the order of `svgspec.h`.
+ */
+enum class Keyword : quint8 {
+    /** Not a keyword the parser knows. */
+    Unknown,
+    SVGSPEC_KEYWORDS(SVGSCENE_KEYWORD_ENUMERATOR)
+    /** Number of the values above, not a keyword. */
+    Count,
+};
+
+#undef SVGSCENE_KEYWORD_ENUMERATOR
+
+/** Keyword of the value, compared case-sensitively, or `Keyword::Unknown`. */
+Keyword findKeyword(const QChar *str, int length);
+
+inline Keyword findKeyword(const QString &str) {
+    return findKeyword(str.constData(), str.size());
+}
+
+inline Keyword findKeyword(const QStringRef &str) {
+    return findKeyword(str.constData(), str.size());
+}
+
+/**
+ * Looks up a color keyword ignoring ASCII case. Returns false, when the name is not a keyword.
+ */
+bool findNamedColor(const QChar *str, int length, QRgb *rgb);
+
+} // namespace svgscene
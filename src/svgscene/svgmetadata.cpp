@@ -1,55 +1,178 @@
 #include "svgmetadata.h"
 
+#include <QVariant>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
 namespace svgscene {
 
-XmlAttributes getXmlAttributes(const QGraphicsItem *element) {
-    QVariant raw = element->data(static_cast<int>(MetadataType::XmlAttributes));
-    if (!raw.isValid() || !raw.canConvert<XmlAttributes>()) {
-        throw std::out_of_range(
-            "XmlAttributes not present in the object.\n"
-            "Check whether the object was created by the svgscene parser.");
+const QString *ElementAttributes::find(const QString &name) const {
+    if (!atoms) {
+        return nullptr;
+    }
+    const Atom atom = atoms->find(name);
+    return (atom == atoms::INVALID) ? nullptr : attributes.find(atom);
+}
+
+using TablePointer = QSharedPointer<const ElementTable>;
+
+int getElementIndex(const QGraphicsItem *element) noexcept {
+    // The position is stored inline, reading it does not touch the heap.
+    const QVariant raw = element->data(static_cast<int>(MetadataType::XmlAttributes));
+    return (raw.userType() == QMetaType::UInt) ? int(raw.toUInt()) : -1;
+}
+
+const ElementTable *getElementTable(const QGraphicsItem *element) noexcept {
+    for (; element != nullptr; element = element->parentItem()) {
+        const QVariant raw = element->data(static_cast<int>(MetadataType::CssAttributes));
+        if (raw.userType() == qMetaTypeId<TablePointer>()) {
+            // The root item keeps holding the table, the pointer outlives the variant.
+            return static_cast<const TablePointer *>(raw.constData())->data();
+        }
+    }
+    return nullptr;
+}
+
+ElementHandle getElementHandle(const QGraphicsItem *element) noexcept {
+    ElementHandle handle;
+    handle.index = getElementIndex(element);
+    if (handle.index >= 0) {
+        handle.table = getElementTable(element);
+        if (handle.table == nullptr || handle.index >= handle.table->size()) {
+            return ElementHandle();
+        }
+    }
+    return handle;
+}
+
+static std::string missingMessage(const char *field) {
+    return std::string(field)
+           + " not present in the object.\n"
+             "Check whether the object was created by the svgscene parser.";
+}
+
+static ElementHandle requireHandle(const QGraphicsItem *element, const char *field) {
+    ElementHandle handle = getElementHandle(element);
+    if (!handle.isValid()) {
+        throw std::out_of_range(missingMessage(field));
+    }
+    return handle;
+}
+
+static const QString *attributeOf(const ElementHandle &handle, const QString &name) {
+    const Atom atom = handle.table->atoms()->find(name);
+    return (atom == atoms::INVALID) ? nullptr : handle.table->attributes(handle.index).find(atom);
+}
+
+static const QString *cssValueOf(const ElementHandle &handle, const QString &name) {
+    const Atom atom = handle.table->atoms()->find(name);
+    return (atom == atoms::INVALID) ? nullptr : handle.table->style(handle.index).declared(atom);
+}
+
+AttributeQuery::AttributeQuery(QString name, QString value)
+    : m_name(std::move(name))
+    , m_value(std::move(value)) {}
+
+bool AttributeQuery::matches(const ElementAttributes &attrs) const {
+    return m_name.isEmpty() || matches(attrs.atoms.data(), attrs.attributes);
+}
+
+bool AttributeQuery::matches(const QGraphicsItem *element) const {
+    if (m_name.isEmpty()) {
+        return true;
     }
-    return qvariant_cast<XmlAttributes>(raw);
+    const ElementHandle handle = requireHandle(element, "XmlAttributes");
+    return matches(handle.table->atoms().data(), handle.table->attributes(handle.index));
+}
+
+bool AttributeQuery::tryMatches(const QGraphicsItem *element) const noexcept {
+    if (m_name.isEmpty()) {
+        return true;
+    }
+    const ElementHandle handle = getElementHandle(element);
+    return handle.isValid()
+           && matches(handle.table->atoms().data(), handle.table->attributes(handle.index));
+}
+
+bool AttributeQuery::matches(const AtomTable *table, const AttributeList &attributes) const {
+    if (table != m_table) {
+        m_table = table;
+        m_atom = m_table ? m_table->find(m_name) : atoms::INVALID;
+    }
+    if (m_atom == atoms::INVALID) {
+        return false;
+    }
+    const QString *value = attributes.find(m_atom);
+    return value != nullptr && (m_value.isEmpty() || *value == m_value);
+}
+
+const QString *findXmlAttribute(const QGraphicsItem *element, const QString &name) noexcept {
+    const ElementHandle handle = getElementHandle(element);
+    return handle.isValid() ? attributeOf(handle, name) : nullptr;
+}
+
+const QString *findCssValue(const QGraphicsItem *element, const QString &attr_name) noexcept {
+    const ElementHandle handle = getElementHandle(element);
+    return handle.isValid() ? cssValueOf(handle, attr_name) : nullptr;
+}
+
+ElementAttributes getElementAttributes(const QGraphicsItem *element) {
+    const ElementHandle handle = requireHandle(element, "XmlAttributes");
+    return ElementAttributes { handle.table->atoms(), handle.table->attributes(handle.index) };
+}
+
+XmlAttributes getXmlAttributes(const QGraphicsItem *element) {
+    ElementAttributes attrs = getElementAttributes(element);
+    return attrs.attributes.toMap(*attrs.atoms);
 }
 QString getXmlAttribute(const QGraphicsItem *element, const QString &name) {
-    XmlAttributes attrs = getXmlAttributes(element);
-    if (!attrs.contains(name)) {
+    const QString *value = attributeOf(requireHandle(element, "XmlAttributes"), name);
+    if (value == nullptr) {
         throw std::out_of_range(
             "Element does not contain requested XML attribute.");
     }
-    return attrs.value(name);
+    return *value;
 }
 QString getXmlAttributeOr(
     const QGraphicsItem *element,
     const QString &name,
     const QString &defaultValue) noexcept {
-    XmlAttributes attrs = getXmlAttributes(element);
-    return attrs.value(name, defaultValue);
+    const QString *value = findXmlAttribute(element, name);
+    return value ? *value : defaultValue;
 }
 
-CssAttributes getCssAttributes(const QGraphicsItem *element) {
-    QVariant raw = element->data(static_cast<int>(MetadataType::CssAttributes));
-    if (!raw.isValid() || !raw.canConvert<CssAttributes>()) {
-        throw std::out_of_range(
-            "CssAttributes not present in the object.\n"
-            "Check whether the object was created by the svgscene parser.");
+const QString *ElementStyle::find(const QString &name) const {
+    if (!atoms) {
+        return nullptr;
     }
-    return qvariant_cast<CssAttributes>(raw);
+    const Atom atom = atoms->find(name);
+    return (atom == atoms::INVALID) ? nullptr : style.declared(atom);
+}
+
+ElementStyle getElementStyle(const QGraphicsItem *element) {
+    const ElementHandle handle = requireHandle(element, "CssAttributes");
+    return ElementStyle { handle.table->atoms(), handle.table->style(handle.index) };
+}
+
+CssAttributes getCssAttributes(const QGraphicsItem *element) {
+    ElementStyle style = getElementStyle(element);
+    return style.style->declared.toMap(*style.atoms);
 }
 QString getCssValue(const QGraphicsItem *element, const QString &attr_name) {
-    CssAttributes attrs = getCssAttributes(element);
-    if (!attrs.contains(attr_name)) {
+    const QString *value = cssValueOf(requireHandle(element, "CssAttributes"), attr_name);
+    if (value == nullptr) {
         throw std::out_of_range(
             "Element does not contain requested XML attribute.");
     }
-    return attrs.value(attr_name);
+    return *value;
 }
 QString getCssValueOr(
     const QGraphicsItem *element,
     const QString &attr_name,
     const QString &defaultValue) noexcept {
-    CssAttributes attrs = getCssAttributes(element);
-    return attrs.value(attr_name, defaultValue);
+    const QString *value = findCssValue(element, attr_name);
+    return value ? *value : defaultValue;
 }
 
 } // namespace svgscene
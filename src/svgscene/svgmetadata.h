@@ -1,7 +1,12 @@
 #pragma once
 
+#include "svgattributes.h"
+#include "svgelementtable.h"
+#include "svgstyle.h"
+
 #include <QGraphicsItem>
 #include <QMap>
+#include <QSharedPointer>
 #include <QString>
 
 namespace svgscene {
@@ -10,6 +15,10 @@ namespace svgscene {
  * Fields that can be found on SVG related `QGraphicsItem`s using the `data`
  * method.
  * Data are stored using QVariant (accessed by index).
+ *
+ * `XmlAttributes` holds the position of the element in the `ElementTable` of its document (see
+ * `svgelementtable.h`), which has both the attributes and the style. `CssAttributes` is set only
+ * on the root item, it holds the table itself.
  */
 enum class MetadataType {
     XmlAttributes = 1,
@@ -24,6 +33,84 @@ constexpr MetadataType LAST_VALUE = MetadataType::CssAttributes;
 
 using XmlAttributes = QMap<QString, QString>;
 
+/**
+ * XML attributes of an element in the form they are stored in the metadata table: interned names
+ * shared by the whole document and a flat list of values.
+ */
+struct ElementAttributes {
+    QSharedPointer<const AtomTable> atoms;
+    AttributeList attributes;
+
+    /** Pointer to the value of the attribute or nullptr, when not present. */
+    const QString *find(const QString &name) const;
+};
+
+/**
+ * Attribute filter (name and optionally value) that resolves the name to an atom only once per
+ * atom table, so that repeated matching during a tree search compares integers.
+ */
+class AttributeQuery {
+public:
+    /** Empty name matches any element, empty value matches any value. */
+    AttributeQuery(QString name, QString value);
+
+    bool matches(const ElementAttributes &attrs) const;
+    /** @throws std::out_of_range    if element has no XML data assigned */
+    bool matches(const QGraphicsItem *element) const;
+    /** Variant of the above, elements without XML data do not match (unless the name is empty). */
+    bool tryMatches(const QGraphicsItem *element) const noexcept;
+
+private:
+    bool matches(const AtomTable *table, const AttributeList &attributes) const;
+
+    QString m_name;
+    QString m_value;
+    mutable const AtomTable *m_table = nullptr;
+    mutable Atom m_atom = atoms::INVALID;
+};
+
+/**
+ * Position of the element's metadata in the table of its document, -1 if the element has none
+ * (it was not created by the svgscene). Reads only the element itself.
+ */
+int getElementIndex(const QGraphicsItem *element) noexcept;
+
+/**
+ * Table of the document the element belongs to, held by the nearest ancestor (or the element
+ * itself) that is a root item of a document. Null when there is none.
+ */
+const ElementTable *getElementTable(const QGraphicsItem *element) noexcept;
+
+/**
+ * Handle of the element's metadata, invalid if the element has none (it was not created by the
+ * svgscene) or it is not under the root item of its document.
+ */
+ElementHandle getElementHandle(const QGraphicsItem *element) noexcept;
+
+/**
+ * Pointer to the XML attribute of a element in the metadata table, without copying anything.
+ * It stays valid as long as the root item of the document exists and the document is not
+ * reloaded.
+ *
+ * @param element               DOM element
+ * @param name                  XML attribute name
+ * @return                      nullptr, when the attribute (or metadata) is not present
+ */
+const QString *findXmlAttribute(const QGraphicsItem *element, const QString &name) noexcept;
+
+/**
+ * Pointer to the declared CSS value of a element, see `findXmlAttribute`.
+ */
+const QString *findCssValue(const QGraphicsItem *element, const QString &attr_name) noexcept;
+
+/**
+ * Retrieve XML attributes of a element without conversion to a map.
+ *
+ * @param element               DOM element
+ * @throws std::out_of_range    if element has no XML data assigned (see `getXmlAttributes`)
+ */
+ElementAttributes getElementAttributes(const QGraphicsItem *element);
+
 /**
  * Retrieve all XML attributes of a element (including CSS).
  *
@@ -55,17 +142,30 @@ QString getXmlAttributeOr(
     const QString &defaultValue) noexcept;
 
 /**
- * CSS data of single element.
- *
- * TODO: make struct - number of attributes is fixed
- * TODO: decide, whether to store only supported attributes, in that case exposing css has
- *       probably no value
- * TODO: implement merge as method
- * TODO: use QStringRef for parsing values
- * TODO: all attributes names are known, they can be internalized
+ * CSS data of single element in the map form. The metadata table stores the computed style (see
+ * `ElementStyle`), this form is produced on demand for compatibility.
  */
 using CssAttributes = QMap<QString, QString>;
 
+/**
+ * Computed style of an element as stored in the metadata table.
+ */
+struct ElementStyle {
+    QSharedPointer<const AtomTable> atoms;
+    ComputedStyle style;
+
+    /** Pointer to the declared value of the property or nullptr, when not present. */
+    const QString *find(const QString &name) const;
+};
+
+/**
+ * Retrieve computed style of a element.
+ *
+ * @param element               DOM element
+ * @throws std::out_of_range    if element has no CSS data assigned (see `getCssAttributes`)
+ */
+ElementStyle getElementStyle(const QGraphicsItem *element);
+
 /**
  * Retrieve all CSS attributes of a element.
  *
@@ -99,5 +199,7 @@ QString getCssValueOr(
 } // namespace svgscene
 
 Q_DECLARE_METATYPE(svgscene::XmlAttributes)
+Q_DECLARE_METATYPE(svgscene::ElementAttributes)
+Q_DECLARE_METATYPE(svgscene::ElementStyle)
 // Not necessary, it refers to the same type signature as `XmlAttributes
 //Q_DECLARE_METATYPE(svgscene::CssAttributes)
@@ -0,0 +1,11 @@
+#include "svgnumber.h"
+
+#include <QByteArray>
+
+namespace svgscene {
+
+double number::parseSlow(const char *begin, int length) {
+    return QByteArray::fromRawData(begin, length).toDouble();
+}
+
+} // namespace svgscene
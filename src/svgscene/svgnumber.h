@@ -0,0 +1,162 @@
+/**
+ * Number scanning kernel shared by all numeric attribute parsers (path data, lists, lengths).
+ *
+ * Numbers are parsed in place from the source buffer. Mantissas of up to 19 significant digits
+ * are accumulated in a 64-bit integer; when the mantissa fits into a double exactly (at most
+ * 2^53) and the decimal exponent is small (at most 22), the result is a single correctly rounded
+ * multiplication or division by an exact power of ten (Clinger's fast path). This covers virtually
+ * all numbers in real documents. Remaining inputs are passed to the exact, locale independent
+ * conversion of Qt, so the result is correctly rounded for every input.
+ *
+ * @file
+ */
+#pragma once
+
+#include <QChar>
+#include <QtGlobal>
+
+namespace svgscene {
+
+namespace number {
+
+    /** Exact conversion of an ASCII number in the C locale, used for the rare slow cases. */
+    double parseSlow(const char *begin, int length);
+
+    /** Copies the scanned number to ASCII and converts it with `parseSlow`. */
+    template<typename Char>
+    double parseSlow(const Char *begin, const Char *end);
+
+    inline ushort code(QChar c) {
+        return c.unicode();
+    }
+
+    inline ushort code(char c) {
+        return static_cast<uchar>(c);
+    }
+
+    inline bool isDigit(ushort c) {
+        return unsigned(c - '0') < 10u;
+    }
+
+    /** Exact powers of ten representable by a double. */
+    static const double POWERS_OF_TEN[] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                            1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                            1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+    static const int MAX_FAST_EXPONENT = 22;
+    static const quint64 MAX_FAST_MANTISSA = quint64(1) << 53;
+    static const int MAX_MANTISSA_DIGITS = 19;
+} // namespace number
+
+/**
+ * Parses a number (`[+-]digits[.digits][(e|E)[+-]digits]`) and moves the pointer behind it.
+ *
+ * The sign and the decimal point are always consumed, the exponent only when followed by digits.
+ * Input must be terminated by a character, which is not part of a number (e.g. the terminating
+ * zero of QString). Returns 0, when there are no digits.
+ */
+template<typename Char>
+double parseNumber(const Char *&str) {
+    using number::code;
+    using number::isDigit;
+
+    const Char *begin = str;
+    bool negative = false;
+    if (code(*str) == '-') {
+        negative = true;
+        ++str;
+    } else if (code(*str) == '+') {
+        ++str;
+    }
+
+    quint64 mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    // Leading zeros are not significant.
+    while (code(*str) == '0') {
+        ++str;
+    }
+    while (isDigit(code(*str))) {
+        if (digits < number::MAX_MANTISSA_DIGITS) {
+            mantissa = mantissa * 10 + (code(*str) - '0');
+        } else {
+            ++exponent;
+        }
+        ++digits;
+        ++str;
+    }
+    if (code(*str) == '.') {
+        ++str;
+        if (digits == 0) {
+            while (code(*str) == '0') {
+                --exponent;
+                ++str;
+            }
+        }
+        while (isDigit(code(*str))) {
+            if (digits < number::MAX_MANTISSA_DIGITS) {
+                mantissa = mantissa * 10 + (code(*str) - '0');
+                --exponent;
+            }
+            ++digits;
+            ++str;
+        }
+    }
+    const bool truncated = digits > number::MAX_MANTISSA_DIGITS;
+
+    if (code(*str) == 'e' || code(*str) == 'E') {
+        const Char *e = str + 1;
+        bool negative_exponent = false;
+        if (code(*e) == '-') {
+            negative_exponent = true;
+            ++e;
+        } else if (code(*e) == '+') {
+            ++e;
+        }
+        if (isDigit(code(*e))) {
+            int explicit_exponent = 0;
+            while (isDigit(code(*e))) {
+                // Saturates, such exponents over- or underflow anyway.
+                if (explicit_exponent < 100000) {
+                    explicit_exponent = explicit_exponent * 10 + (code(*e) - '0');
+                }
+                ++e;
+            }
+            exponent += negative_exponent ? -explicit_exponent : explicit_exponent;
+            str = e;
+        }
+    }
+
+    if (mantissa == 0 && !truncated) {
+        return negative ? -0.0 : 0.0;
+    }
+    if (!truncated && mantissa <= number::MAX_FAST_MANTISSA
+        && exponent >= -number::MAX_FAST_EXPONENT && exponent <= number::MAX_FAST_EXPONENT) {
+        double value = static_cast<double>(mantissa);
+        if (exponent < 0) {
+            value /= number::POWERS_OF_TEN[-exponent];
+        } else {
+            value *= number::POWERS_OF_TEN[exponent];
+        }
+        return negative ? -value : value;
+    }
+    return number::parseSlow(begin, str);
+}
+
+template<typename Char>
+double number::parseSlow(const Char *begin, const Char *end) {
+    const int length = static_cast<int>(end - begin);
+    char stack_buffer[64];
+    char *buffer = (length < 64) ? stack_buffer : new char[length + 1];
+    for (int i = 0; i < length; ++i) {
+        buffer[i] = static_cast<char>(code(begin[i]));
+    }
+    buffer[length] = '\0';
+    const double value = parseSlow(buffer, length);
+    if (buffer != stack_buffer) {
+        delete[] buffer;
+    }
+    return value;
+}
+
+} // namespace svgscene
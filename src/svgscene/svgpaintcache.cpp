@@ -0,0 +1,72 @@
+#include "svgpaintcache.h"
+
+namespace svgscene {
+
+PaintKey::PaintKey(const ComputedStyle &style) : fill(style->fill), stroke(style->stroke) {
+    if (fill == PaintType::Color) {
+        fillColor = style->effectiveFillColor();
+    }
+    if (stroke == PaintType::Color) {
+        strokeColor = style->effectiveStrokeColor();
+        strokeWidth = style->strokeWidth;
+        strokeLinecap = style->strokeLinecap;
+        strokeLinejoin = style->strokeLinejoin;
+        strokeDashArray = style->strokeDashArray;
+        hasStrokeDashOffset = style->hasStrokeDashOffset;
+        strokeDashOffset = style->strokeDashOffset;
+    }
+}
+
+bool operator==(const PaintKey &a, const PaintKey &b) {
+    return a.fill == b.fill && a.fillColor == b.fillColor && a.stroke == b.stroke
+           && a.strokeColor == b.strokeColor && a.strokeWidth == b.strokeWidth
+           && a.strokeLinecap == b.strokeLinecap && a.strokeLinejoin == b.strokeLinejoin
+           && a.strokeDashArray == b.strokeDashArray
+           && a.hasStrokeDashOffset == b.hasStrokeDashOffset
+           && a.strokeDashOffset == b.strokeDashOffset;
+}
+
+uint qHash(const PaintKey &key, uint seed) {
+    // Documents differ mostly in colors and widths, the rest is compared on collisions.
+    uint hash = seed ^ uint(key.fill) ^ (uint(key.stroke) << 4);
+    hash ^= qHash(key.fillColor.rgba(), seed) * 31;
+    hash ^= qHash(key.strokeColor.rgba(), seed) * 131;
+    hash ^= qHash(key.strokeWidth, seed) * 1031;
+    return hash;
+}
+
+/**
+ * Resolution of the style, formerly done for each item.
+ */
+static Paint resolvePaint(const ComputedStyle &style) {
+    Paint paint;
+    if (style->fill == PaintType::Unset) {
+        // default fill
+    } else if (style->fill == PaintType::None) {
+        paint.hasBrush = true;
+        paint.brush = Qt::NoBrush;
+    } else {
+        paint.hasBrush = true;
+        paint.brush = style->effectiveFillColor();
+    }
+    if (style->stroke == PaintType::Color) {
+        QPen pen(style->effectiveStrokeColor());
+        pen.setWidthF(style->strokeWidth);
+        pen.setCapStyle(style->strokeLinecap);
+        pen.setJoinStyle(style->strokeLinejoin);
+        if (!style->strokeDashArray.isEmpty()) {
+            pen.setDashPattern(style->strokeDashArray);
+        }
+        if (style->hasStrokeDashOffset) {
+            pen.setDashOffset(style->strokeDashOffset);
+        }
+        paint.pen = pen;
+    }
+    return paint;
+}
+
+const Paint &PaintCache::get(const ComputedStyle &style) {
+    return ResolvedCache::get(style, resolvePaint);
+}
+
+} // namespace svgscene
@@ -0,0 +1,61 @@
+/**
+ * Sharing of pens and brushes.
+ *
+ * Drawings use only a few dozen distinct combinations of fill and stroke. Each combination is
+ * resolved into a `QPen` and `QBrush` once, all items with the same paint then share their
+ * implicitly shared data and applying a style is a hash lookup.
+ *
+ * @file
+ */
+#pragma once
+
+#include "svgresolvedcache.h"
+#include "svgstyle.h"
+
+#include <QBrush>
+#include <QPen>
+
+namespace svgscene {
+
+/**
+ * Pen and brush resolved from the computed style of a shape.
+ */
+struct Paint {
+    /** Fill was declared, otherwise the item keeps its default brush. */
+    bool hasBrush = false;
+    QBrush brush;
+    QPen pen = QPen(Qt::NoPen);
+};
+
+/**
+ * Properties of the computed style which determine `Paint`.
+ */
+struct PaintKey {
+    PaintType fill = PaintType::Unset;
+    QColor fillColor;
+    PaintType stroke = PaintType::Unset;
+    QColor strokeColor;
+    qreal strokeWidth = 0;
+    Qt::PenCapStyle strokeLinecap = Qt::FlatCap;
+    Qt::PenJoinStyle strokeLinejoin = Qt::MiterJoin;
+    QVector<qreal> strokeDashArray;
+    bool hasStrokeDashOffset = false;
+    qreal strokeDashOffset = 0;
+
+    /** Properties without effect (e.g. color of a `none` stroke) are left default. */
+    explicit PaintKey(const ComputedStyle &style);
+};
+
+bool operator==(const PaintKey &a, const PaintKey &b);
+uint qHash(const PaintKey &key, uint seed = 0);
+
+/**
+ * Paints of the shapes of a document, `size` is the number of distinct paints.
+ */
+class PaintCache : public ResolvedCache<PaintKey, Paint> {
+public:
+    /** Paint of the style, resolved on the first use. */
+    const Paint &get(const ComputedStyle &style);
+};
+
+} // namespace svgscene
@@ -0,0 +1,47 @@
+#include "svgpathcache.h"
+
+#include <QMutexLocker>
+
+namespace svgscene {
+
+PathCache::PathCache(int max_elements) : m_paths(max_elements) {}
+
+bool PathCache::find(const PathKey &key, QPainterPath &path) {
+    QMutexLocker locker(&m_mutex);
+    const QPainterPath *cached = m_paths.object(key);
+    if (cached == nullptr) {
+        ++m_misses;
+        return false;
+    }
+    ++m_hits;
+    path = *cached;
+    return true;
+}
+
+void PathCache::insert(const PathKey &key, const QPainterPath &path) {
+    QMutexLocker locker(&m_mutex);
+    // Empty paths still occupy an entry.
+    m_paths.insert(key, new QPainterPath(path), qMax(1, path.elementCount()));
+}
+
+void PathCache::clear() {
+    QMutexLocker locker(&m_mutex);
+    m_paths.clear();
+}
+
+quint64 PathCache::hits() const {
+    QMutexLocker locker(&m_mutex);
+    return m_hits;
+}
+
+quint64 PathCache::misses() const {
+    QMutexLocker locker(&m_mutex);
+    return m_misses;
+}
+
+PathCache &PathCache::global() {
+    static PathCache cache;
+    return cache;
+}
+
+} // namespace svgscene
@@ -0,0 +1,77 @@
+/**
+ * Sharing of decoded path data.
+ *
+ * Drawings repeat the same shapes (arrows, connectors, icons) many times with byte-identical `d`
+ * attributes. Each distinct path data is decoded only once and all elements get an implicitly
+ * shared copy of the same `QPainterPath`. Within a document the sharing needs no locking, see
+ * `SvgTreeBuilder`; `PathCache` additionally shares paths among documents of the process.
+ *
+ * @file
+ */
+#pragma once
+
+#include <QCache>
+#include <QMutex>
+#include <QPainterPath>
+#include <QString>
+
+namespace svgscene {
+
+/**
+ * Scope in which identical path data are decoded once.
+ */
+enum class PathCacheMode {
+    /** Every path element is decoded. */
+    None,
+    /** Identical paths of a document are shared. */
+    Document,
+    /** Paths are shared also with all documents parsed in this mode, see `PathCache::global`. */
+    Process,
+};
+
+struct PathKey {
+    QString data;
+    Qt::FillRule fillRule;
+};
+
+inline bool operator==(const PathKey &a, const PathKey &b) {
+    return a.fillRule == b.fillRule && a.data == b.data;
+}
+
+inline uint qHash(const PathKey &key, uint seed = 0) {
+    return qHash(key.data, seed) ^ uint(key.fillRule);
+}
+
+/**
+ * Thread safe cache of decoded paths. Least recently used paths are evicted, when the total
+ * number of path elements exceeds the limit.
+ */
+class PathCache {
+public:
+    /**
+     * @param max_elements  limit of `QPainterPath::elementCount` of all cached paths
+     */
+    explicit PathCache(int max_elements = 1 << 20);
+
+    PathCache(const PathCache &) = delete;
+    PathCache &operator=(const PathCache &) = delete;
+
+    /** Looks up a path, returns false when not cached. */
+    bool find(const PathKey &key, QPainterPath &path);
+    void insert(const PathKey &key, const QPainterPath &path);
+    void clear();
+
+    quint64 hits() const;
+    quint64 misses() const;
+
+    /** Cache used by `PathCacheMode::Process`. */
+    static PathCache &global();
+
+private:
+    mutable QMutex m_mutex;
+    QCache<PathKey, QPainterPath> m_paths;
+    quint64 m_hits = 0;
+    quint64 m_misses = 0;
+};
+
+} // namespace svgscene
@@ -0,0 +1,71 @@
+#include "svgreader.h"
+
+#include <QXmlStreamReader>
+
+namespace svgscene {
+
+bool SvgReader::needsMoreData() const {
+    return false;
+}
+
+QtXmlReader::QtXmlReader(QXmlStreamReader *xml) : m_xml(xml) {
+    m_xml->setNamespaceProcessing(false);
+}
+
+SvgReader::TokenType QtXmlReader::readNext() {
+    switch (m_xml->readNext()) {
+    case QXmlStreamReader::StartElement:
+        m_attributes = m_xml->attributes();
+        return StartElement;
+    case QXmlStreamReader::EndElement: return EndElement;
+    case QXmlStreamReader::Characters: return Characters;
+    case QXmlStreamReader::Comment: return Comment;
+    case QXmlStreamReader::ProcessingInstruction: return ProcessingInstruction;
+    case QXmlStreamReader::EndDocument: return EndDocument;
+    case QXmlStreamReader::Invalid: return Invalid;
+    case QXmlStreamReader::NoToken: return NoToken;
+    default: return Other;
+    }
+}
+
+bool QtXmlReader::atEnd() const {
+    return m_xml->atEnd();
+}
+
+bool QtXmlReader::hasError() const {
+    return m_xml->hasError();
+}
+
+QString QtXmlReader::errorString() const {
+    return m_xml->errorString();
+}
+
+Atom QtXmlReader::name(AtomTable &names) const {
+    return names.intern(m_xml->name());
+}
+
+int QtXmlReader::attributeCount() const {
+    return m_attributes.size();
+}
+
+Atom QtXmlReader::attributeName(int index, AtomTable &names) const {
+    return names.intern(m_attributes.at(index).name());
+}
+
+QString QtXmlReader::attributeValue(int index) const {
+    return m_attributes.at(index).value().toString();
+}
+
+QString QtXmlReader::text() const {
+    return m_xml->text().toString();
+}
+
+void QtXmlReader::skipCurrentElement() {
+    m_xml->skipCurrentElement();
+}
+
+bool QtXmlReader::needsMoreData() const {
+    return m_xml->error() == QXmlStreamReader::PrematureEndOfDocumentError;
+}
+
+} // namespace svgscene
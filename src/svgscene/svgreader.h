@@ -0,0 +1,102 @@
+/**
+ * Pull reader interface used by the handler to read the SVG document.
+ *
+ * The handler needs only a small subset of XML (elements, attributes and text), the interface is
+ * therefore much narrower than QXmlStreamReader and allows specialized implementations (see
+ * `svgtokenizer.h`). Names are returned as atoms so that the reader can intern them without
+ * allocating strings.
+ *
+ * @file
+ */
+#pragma once
+
+#include "svgattributes.h"
+
+#include <QString>
+#include <QXmlStreamAttributes>
+
+class QXmlStreamReader;
+
+namespace svgscene {
+
+/**
+ * Reader implementation used to parse a document.
+ */
+enum class ReaderBackend {
+    /** QXmlStreamReader with namespace processing disabled. */
+    QtXml,
+    /** UTF-8 tokenizer working directly on the input bytes, see `svgtokenizer.h`. */
+    Tokenizer,
+};
+
+class SvgReader {
+public:
+    enum TokenType {
+        NoToken,
+        /** Tokens the handler does not care about (XML declaration, DTD, ...). */
+        Other,
+        StartElement,
+        EndElement,
+        Characters,
+        Comment,
+        ProcessingInstruction,
+        EndDocument,
+        Invalid,
+    };
+
+    virtual ~SvgReader() = default;
+
+    virtual TokenType readNext() = 0;
+    virtual bool atEnd() const = 0;
+    virtual bool hasError() const = 0;
+    virtual QString errorString() const = 0;
+
+    /** Name of the current start or end element interned in the table. */
+    virtual Atom name(AtomTable &names) const = 0;
+
+    /** Attributes of the current start element. */
+    virtual int attributeCount() const = 0;
+    virtual Atom attributeName(int index, AtomTable &names) const = 0;
+    virtual QString attributeValue(int index) const = 0;
+
+    /** Text of the current characters token with entities resolved. */
+    virtual QString text() const = 0;
+
+    /** Reads until the end of the current element (including its end tag). */
+    virtual void skipCurrentElement() = 0;
+
+    /**
+     * True, when reading stopped because the input ended in the middle of the document and may
+     * continue once more data is added. Only incremental readers ever return true.
+     */
+    virtual bool needsMoreData() const;
+};
+
+/**
+ * Adapter of QXmlStreamReader.
+ */
+class QtXmlReader : public SvgReader {
+public:
+    /**
+     * @param xml   reader, must outlive the adapter; namespace processing is turned off
+     */
+    explicit QtXmlReader(QXmlStreamReader *xml);
+
+    TokenType readNext() override;
+    bool atEnd() const override;
+    bool hasError() const override;
+    QString errorString() const override;
+    Atom name(AtomTable &names) const override;
+    int attributeCount() const override;
+    Atom attributeName(int index, AtomTable &names) const override;
+    QString attributeValue(int index) const override;
+    QString text() const override;
+    void skipCurrentElement() override;
+    bool needsMoreData() const override;
+
+private:
+    QXmlStreamReader *m_xml;
+    QXmlStreamAttributes m_attributes;
+};
+
+} // namespace svgscene
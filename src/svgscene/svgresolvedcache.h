@@ -0,0 +1,78 @@
+/**
+ * Sharing of values resolved from computed styles.
+ *
+ * Items of a document repeat a few distinct styles. `ResolvedCache` resolves the value of each
+ * distinct key once, items then share the (implicitly shared) resolved value. The key holds only
+ * the properties of the computed style the value depends on, see `PaintCache` and `FontCache`.
+ *
+ * @file
+ */
+#pragma once
+
+#include "svgstyle.h"
+
+#include <QHash>
+
+namespace svgscene {
+
+/**
+ * Per-document cache of values resolved from computed styles. Not thread safe, used by the
+ * thread creating items.
+ *
+ * @tparam Key    properties determining the value, constructible from `ComputedStyle`,
+ *                hashable and equality comparable
+ * @tparam Value  resolved value
+ */
+template<typename Key, typename Value>
+class ResolvedCache {
+public:
+    /** Value of the style, `resolve(style)` on the first use of its key. */
+    const Value &get(const ComputedStyle &style, Value (*resolve)(const ComputedStyle &));
+    void clear();
+
+    /** Number of distinct values. */
+    int size() const;
+    quint64 hits() const;
+    quint64 misses() const;
+
+private:
+    QHash<Key, Value> m_values;
+    quint64 m_hits = 0;
+    quint64 m_misses = 0;
+};
+
+template<typename Key, typename Value>
+const Value &ResolvedCache<Key, Value>::get(
+    const ComputedStyle &style,
+    Value (*resolve)(const ComputedStyle &)) {
+    const Key key(style);
+    auto it = m_values.find(key);
+    if (it != m_values.end()) {
+        ++m_hits;
+        return it.value();
+    }
+    ++m_misses;
+    return m_values.insert(key, resolve(style)).value();
+}
+
+template<typename Key, typename Value>
+void ResolvedCache<Key, Value>::clear() {
+    m_values.clear();
+}
+
+template<typename Key, typename Value>
+int ResolvedCache<Key, Value>::size() const {
+    return m_values.size();
+}
+
+template<typename Key, typename Value>
+quint64 ResolvedCache<Key, Value>::hits() const {
+    return m_hits;
+}
+
+template<typename Key, typename Value>
+quint64 ResolvedCache<Key, Value>::misses() const {
+    return m_misses;
+}
+
+} // namespace svgscene
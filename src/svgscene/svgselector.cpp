@@ -0,0 +1,354 @@
+#include "svgselector.h"
+
+#include "svgmetadata.h"
+
+namespace svgscene {
+
+/**
+ * Recursive descent over the text of a selector. The text is terminated by the zero of QString,
+ * so looking at the current character is always safe.
+ */
+class SvgSelector::Parser {
+public:
+    Parser(const QString &text, SvgSelector &selector)
+        : m_begin(text.constData())
+        , m_pos(m_begin)
+        , m_end(m_begin + text.size())
+        , m_selector(selector) {}
+
+    bool parse() {
+        skipSpaces();
+        Combinator combinator = Combinator::Descendant;
+        for (;;) {
+            Compound compound;
+            compound.combinator = combinator;
+            if (!parseCompound(compound)) {
+                return false;
+            }
+            m_selector.m_compounds.append(compound);
+            const bool spaces = skipSpaces();
+            if (atEnd()) {
+                return true;
+            }
+            if (current() == '>') {
+                ++m_pos;
+                skipSpaces();
+                combinator = Combinator::Child;
+            } else if (spaces) {
+                combinator = Combinator::Descendant;
+            } else {
+                return fail(QStringLiteral("Unexpected character"));
+            }
+        }
+    }
+
+    const QString &error() const { return m_error; }
+
+private:
+    bool atEnd() const { return m_pos >= m_end; }
+    ushort current() const { return atEnd() ? 0 : m_pos->unicode(); }
+    ushort next() const { return (m_pos + 1 < m_end) ? m_pos[1].unicode() : 0; }
+
+    static bool isSpace(ushort c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+    /** Characters of element and attribute names, values and ids. */
+    static bool isNameChar(ushort c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+               || c == '-' || c == '_' || c == ':' || c >= 0x80;
+    }
+
+    /** Returns whether there were any spaces. */
+    bool skipSpaces() {
+        const QChar *start = m_pos;
+        while (!atEnd() && isSpace(current())) {
+            ++m_pos;
+        }
+        return m_pos != start;
+    }
+
+    QString readName() {
+        const QChar *start = m_pos;
+        while (!atEnd() && isNameChar(current())) {
+            ++m_pos;
+        }
+        return QString(start, int(m_pos - start));
+    }
+
+    bool parseCompound(Compound &compound) {
+        const QChar *start = m_pos;
+        if (current() == '*') {
+            ++m_pos;
+        } else if (isNameChar(current())) {
+            compound.tag = m_selector.nameIndex(readName());
+        }
+        while (!atEnd()) {
+            const ushort c = current();
+            if (c == '#' || c == '.') {
+                ++m_pos;
+                Condition condition;
+                condition.name = m_selector.nameIndex(
+                    (c == '#') ? QStringLiteral("id") : QStringLiteral("class"));
+                condition.op = (c == '#') ? Operator::Equals : Operator::Includes;
+                condition.value = readName();
+                if (condition.value.isEmpty()) {
+                    return fail(QStringLiteral("Expected name"));
+                }
+                compound.conditions.append(condition);
+            } else if (c == '[') {
+                if (!parseAttribute(compound)) {
+                    return false;
+                }
+            } else {
+                break;
+            }
+        }
+        if (m_pos == start) {
+            return fail(QStringLiteral("Expected selector"));
+        }
+        return true;
+    }
+
+    bool parseAttribute(Compound &compound) {
+        ++m_pos;
+        skipSpaces();
+        const QString name = readName();
+        if (name.isEmpty()) {
+            return fail(QStringLiteral("Expected attribute name"));
+        }
+        Condition condition;
+        condition.name = m_selector.nameIndex(name);
+        condition.op = Operator::Exists;
+        skipSpaces();
+        if (current() == '=') {
+            condition.op = Operator::Equals;
+            ++m_pos;
+        } else if (current() == '^' && next() == '=') {
+            condition.op = Operator::Prefix;
+            m_pos += 2;
+        } else if (current() == '~' && next() == '=') {
+            condition.op = Operator::Includes;
+            m_pos += 2;
+        }
+        if (condition.op != Operator::Exists) {
+            skipSpaces();
+            if (!readValue(condition.value)) {
+                return false;
+            }
+            skipSpaces();
+        }
+        if (current() != ']') {
+            return fail(QStringLiteral("Expected ']'"));
+        }
+        ++m_pos;
+        compound.conditions.append(condition);
+        return true;
+    }
+
+    bool readValue(QString &value) {
+        const ushort quote = current();
+        if (quote == '"' || quote == '\'') {
+            const QChar *start = ++m_pos;
+            while (!atEnd() && current() != quote) {
+                ++m_pos;
+            }
+            if (atEnd()) {
+                return fail(QStringLiteral("Unterminated string"));
+            }
+            value = QString(start, int(m_pos - start));
+            ++m_pos;
+            return true;
+        }
+        value = readName();
+        if (value.isEmpty()) {
+            return fail(QStringLiteral("Expected value"));
+        }
+        return true;
+    }
+
+    bool fail(const QString &message) {
+        m_error = QStringLiteral("%1 at offset %2").arg(message).arg(int(m_pos - m_begin));
+        return false;
+    }
+
+    const QChar *m_begin;
+    const QChar *m_pos;
+    const QChar *m_end;
+    SvgSelector &m_selector;
+    QString m_error;
+};
+
+SvgSelector SvgSelector::compile(const QString &text, QString *error) {
+    SvgSelector selector;
+    Parser parser(text, selector);
+    if (!parser.parse()) {
+        if (error != nullptr) {
+            *error = parser.error();
+        }
+        return SvgSelector();
+    }
+    selector.m_text = text;
+    return selector;
+}
+
+bool SvgSelector::isValid() const {
+    return !m_compounds.isEmpty();
+}
+
+const QString &SvgSelector::text() const {
+    return m_text;
+}
+
+int SvgSelector::nameIndex(const QString &name) {
+    int index = m_names.indexOf(name);
+    if (index < 0) {
+        index = m_names.size();
+        m_names.append(name);
+    }
+    return index;
+}
+
+void SvgSelector::resolve(const QSharedPointer<const AtomTable> &table) const {
+    if (table == m_table && table->size() == m_tableSize) {
+        return;
+    }
+    m_table = table;
+    m_tableSize = table->size();
+    m_atoms.resize(m_names.size());
+    for (int i = 0; i < m_names.size(); ++i) {
+        m_atoms[i] = table->find(m_names.at(i));
+    }
+}
+
+/** Whether the name is one of the whitespace separated names of the list. */
+static bool containsName(const QString &list, const QString &name) {
+    if (name.isEmpty()) {
+        return false;
+    }
+    for (int from = list.indexOf(name); from >= 0; from = list.indexOf(name, from + 1)) {
+        const int end = from + name.size();
+        if ((from == 0 || list.at(from - 1).isSpace())
+            && (end == list.size() || list.at(end).isSpace())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SvgSelector::matchesCompound(const ElementHandle &handle, const Compound &compound) const {
+    const ElementTable &table = *handle.table;
+    if (compound.tag >= 0) {
+        const Atom tag = m_atoms.at(compound.tag);
+        if (tag == atoms::INVALID || table.name(handle.index) != tag) {
+            return false;
+        }
+    }
+    const AttributeList &attributes = table.attributes(handle.index);
+    for (const Condition &condition : compound.conditions) {
+        const Atom atom = m_atoms.at(condition.name);
+        const QString *value = (atom == atoms::INVALID) ? nullptr : attributes.find(atom);
+        if (value == nullptr) {
+            return false;
+        }
+        switch (condition.op) {
+        case Operator::Exists: break;
+        case Operator::Equals:
+            if (*value != condition.value) {
+                return false;
+            }
+            break;
+        case Operator::Prefix:
+            if (condition.value.isEmpty() || !value->startsWith(condition.value)) {
+                return false;
+            }
+            break;
+        case Operator::Includes:
+            if (!containsName(*value, condition.value)) {
+                return false;
+            }
+            break;
+        }
+    }
+    return true;
+}
+
+/** Nearest ancestor created for an element, skips items added by the application. */
+static const QGraphicsItem *parentElement(const QGraphicsItem *item) {
+    for (item = item->parentItem(); item; item = item->parentItem()) {
+        if (getElementIndex(item) >= 0) {
+            return item;
+        }
+    }
+    return nullptr;
+}
+
+bool SvgSelector::matchesFrom(
+    const ElementTable &table,
+    const QGraphicsItem *element,
+    int compound) const {
+    ElementHandle handle;
+    handle.table = &table;
+    handle.index = getElementIndex(element);
+    if (!matchesCompound(handle, m_compounds.at(compound))) {
+        return false;
+    }
+    if (compound == 0) {
+        return true;
+    }
+    const bool child = m_compounds.at(compound).combinator == Combinator::Child;
+    for (const QGraphicsItem *parent = parentElement(element); parent;
+         parent = parentElement(parent)) {
+        if (matchesFrom(table, parent, compound - 1)) {
+            return true;
+        }
+        if (child) {
+            return false;
+        }
+    }
+    return false;
+}
+
+bool SvgSelector::matches(const QGraphicsItem *element) const {
+    if (element == nullptr || !isValid()) {
+        return false;
+    }
+    // Ancestors are in the same document, the table is looked up once.
+    const ElementHandle handle = getElementHandle(element);
+    if (!handle.isValid()) {
+        return false;
+    }
+    resolve(handle.table->atoms());
+    return matchesFrom(*handle.table, element, m_compounds.size() - 1);
+}
+
+const QVector<SvgIndex::Entry> *SvgSelector::candidates(const SvgIndex *index) const {
+    if (index == nullptr || !isValid()) {
+        return nullptr;
+    }
+    // The most selective condition of the last compound: id, class, indexed attribute value and
+    // presence of an indexed attribute.
+    const QVector<Condition> &conditions = m_compounds.last().conditions;
+    for (const Condition &condition : conditions) {
+        if (condition.op == Operator::Equals && m_names.at(condition.name) == QLatin1String("id")) {
+            return index->find(m_names.at(condition.name), condition.value);
+        }
+    }
+    for (const Condition &condition : conditions) {
+        if (condition.op == Operator::Includes
+            && m_names.at(condition.name) == QLatin1String("class")) {
+            return index->findClass(condition.value);
+        }
+    }
+    for (const Condition &condition : conditions) {
+        if (condition.op == Operator::Equals && index->isIndexed(m_names.at(condition.name))) {
+            return index->find(m_names.at(condition.name), condition.value);
+        }
+    }
+    for (const Condition &condition : conditions) {
+        if (index->isIndexed(m_names.at(condition.name))) {
+            return index->find(m_names.at(condition.name), QString());
+        }
+    }
+    return nullptr;
+}
+
+} // namespace svgscene
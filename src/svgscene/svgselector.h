@@ -0,0 +1,116 @@
+/**
+ * Compiled CSS-like selectors of elements.
+ *
+ * `SvgSelector::compile` parses a selector once, the result serves any number of queries of any
+ * documents (see `SvgDomTree::select` and `selectAll`). Supported syntax:
+ *
+ *  - `path`, `*`          element name, any element
+ *  - `#id`, `.class`      id, one of the class names
+ *  - `[attr]`             attribute present
+ *  - `[attr=value]`       attribute equal to the value
+ *  - `[attr^=prefix]`     attribute starting with the prefix
+ *  - `[attr~=name]`       one of the whitespace separated names of the attribute
+ *  - `a b`, `a > b`       descendant and child combinators
+ *
+ * Values are names or strings quoted by `"` or `'` (without escapes). Like `querySelectorAll` of
+ * the DOM, the whole selector is matched in the document and the results are limited to the
+ * descendants of the searched item. Candidates come from the index of the document (`svgindex.h`),
+ * when the last compound has an id, a class or an indexed attribute; otherwise the subtree is
+ * walked.
+ *
+ * Names are resolved to atoms once per atom table of the matched document. A selector must not
+ * be used by several threads at once, copies are independent.
+ *
+ * ## Example
+ * ```
+ *  static const SvgSelector LABELS = SvgSelector::compile("#registers > g text.value");
+ *  for (auto label : document.getRoot().selectAll<SimpleTextItem>(LABELS)) {
+ *    ...
+ *  }
+ * ```
+ *
+ * @file
+ */
+#pragma once
+
+#include "svgattributes.h"
+#include "svgelementtable.h"
+#include "svgindex.h"
+
+#include <QGraphicsItem>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+namespace svgscene {
+
+class SvgSelector {
+public:
+    /** Invalid selector, matches nothing. */
+    SvgSelector() = default;
+
+    /**
+     * Parses the selector.
+     *
+     * @param error  description of the syntax error with its offset, when not null
+     * @return       invalid selector, when the text is not a valid selector
+     */
+    static SvgSelector compile(const QString &text, QString *error = nullptr);
+
+    bool isValid() const;
+    /** Source of the selector. */
+    const QString &text() const;
+
+    /** Whether the element matches, elements without svgscene metadata never do. */
+    bool matches(const QGraphicsItem *element) const;
+
+    /**
+     * Items of the index in document order, all matches are among them. Null when the index
+     * cannot narrow the search (or is not complete).
+     */
+    const QVector<SvgIndex::Entry> *candidates(const SvgIndex *index) const;
+
+private:
+    enum class Operator { Exists, Equals, Prefix, Includes };
+    enum class Combinator { Descendant, Child };
+
+    struct Condition {
+        /** Index of the attribute name in `m_names`. */
+        int name;
+        Operator op;
+        QString value;
+    };
+
+    /** Conditions on a single element. */
+    struct Compound {
+        /** Index of the element name in `m_names`, -1 for any element. */
+        int tag = -1;
+        QVector<Condition> conditions;
+        /** Relation to the element of the compound on the left. */
+        Combinator combinator = Combinator::Descendant;
+    };
+
+    class Parser;
+
+    int nameIndex(const QString &name);
+    /** Resolves atoms of `m_names` in the table, unless it is the last one and did not grow. */
+    void resolve(const QSharedPointer<const AtomTable> &table) const;
+    bool matchesCompound(const ElementHandle &handle, const Compound &compound) const;
+    /**
+     * Matches the element by the compound and its ancestors by the compounds on the left. The
+     * element has metadata in the table of its document.
+     */
+    bool matchesFrom(const ElementTable &table, const QGraphicsItem *element, int compound) const;
+
+    QString m_text;
+    QVector<Compound> m_compounds;
+    /** Element and attribute names used by the compounds. */
+    QStringList m_names;
+    /** Table of `m_atoms`, kept alive so that its address is not reused. */
+    mutable QSharedPointer<const AtomTable> m_table;
+    mutable int m_tableSize = 0;
+    mutable QVector<Atom> m_atoms;
+};
+
+} // namespace svgscene
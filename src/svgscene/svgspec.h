@@ -7,74 +7,301 @@
 
 #include <QSet>
 
+/**
+ * Presentation attributes as `X(identifier, name)` pairs. The order is significant, it defines
+ * the numbering of predefined attribute atoms (see `svgattributes.h`).
+ *
+ * https://developer.mozilla.org/en-US/docs/Web/SVG/Attribute
+ */
+#define SVGSPEC_PRESENTATION_ATTRIBUTES(X)                                                         \
+    X(AlignmentBaseline, "alignment-baseline")                                                     \
+    X(BaselineShift, "baseline-shift")                                                             \
+    X(Clip, "clip")                                                                                \
+    X(ClipPath, "clip-path")                                                                       \
+    X(ClipRule, "clip-rule")                                                                       \
+    X(Color, "color")                                                                              \
+    X(ColorInterpolation, "color-interpolation")                                                   \
+    X(ColorInterpolationFilters, "color-interpolation-filters")                                    \
+    X(ColorProfile, "color-profile")                                                               \
+    X(ColorRendering, "color-rendering")                                                           \
+    X(Cursor, "cursor")                                                                            \
+    X(Direction, "direction")                                                                      \
+    X(Display, "display")                                                                          \
+    X(DominantBaseline, "dominant-baseline")                                                       \
+    X(EnableBackground, "enable-background")                                                       \
+    X(Fill, "fill")                                                                                \
+    X(FillOpacity, "fill-opacity")                                                                 \
+    X(FillRule, "fill-rule")                                                                       \
+    X(Filter, "filter")                                                                            \
+    X(FloodColor, "flood-color")                                                                   \
+    X(FloodOpacity, "flood-opacity")                                                               \
+    X(FontFamily, "font-family")                                                                   \
+    X(FontSize, "font-size")                                                                       \
+    X(FontSizeAdjust, "font-size-adjust")                                                          \
+    X(FontStretch, "font-stretch")                                                                 \
+    X(FontStyle, "font-style")                                                                     \
+    X(FontVariant, "font-variant")                                                                 \
+    X(FontWeight, "font-weight")                                                                   \
+    X(GlyphOrientationHorizontal, "glyph-orientation-horizontal")                                  \
+    X(GlyphOrientationVertical, "glyph-orientation-vertical")                                      \
+    X(ImageRendering, "image-rendering")                                                           \
+    X(Kerning, "kerning")                                                                          \
+    X(LetterSpacing, "letter-spacing")                                                             \
+    X(LightingColor, "lighting-color")                                                             \
+    X(MarkerEnd, "marker-end")                                                                     \
+    X(MarkerMid, "marker-mid")                                                                     \
+    X(MarkerStart, "marker-start")                                                                 \
+    X(Mask, "mask")                                                                                \
+    X(Opacity, "opacity")                                                                          \
+    X(Overflow, "overflow")                                                                        \
+    X(PointerEvents, "pointer-events")                                                             \
+    X(ShapeRendering, "shape-rendering")                                                           \
+    X(StopColor, "stop-color")                                                                     \
+    X(StopOpacity, "stop-opacity")                                                                 \
+    X(Stroke, "stroke")                                                                            \
+    X(StrokeDasharray, "stroke-dasharray")                                                         \
+    X(StrokeDashoffset, "stroke-dashoffset")                                                       \
+    X(StrokeLinecap, "stroke-linecap")                                                             \
+    X(StrokeLinejoin, "stroke-linejoin")                                                           \
+    X(StrokeMiterlimit, "stroke-miterlimit")                                                       \
+    X(StrokeOpacity, "stroke-opacity")                                                             \
+    X(StrokeWidth, "stroke-width")                                                                 \
+    X(TextAnchor, "text-anchor")                                                                   \
+    X(TextDecoration, "text-decoration")                                                           \
+    X(TextRendering, "text-rendering")                                                             \
+    X(Transform, "transform")                                                                      \
+    X(TransformOrigin, "transform-origin")                                                         \
+    X(UnicodeBidi, "unicode-bidi")                                                                 \
+    X(VectorEffect, "vector-effect")                                                               \
+    X(Visibility, "visibility")                                                                    \
+    X(WordSpacing, "word-spacing")                                                                 \
+    X(WritingMode, "writing-mode")
+
+/**
+ * Regular (non-presentation) attributes the parser reads, in the same format as above.
+ */
+#define SVGSPEC_COMMON_ATTRIBUTES(X)                                                               \
+    X(Id, "id")                                                                                    \
+    X(Class, "class")                                                                              \
+    X(Style, "style")                                                                              \
+    X(D, "d")                                                                                      \
+    X(X, "x")                                                                                      \
+    X(Y, "y")                                                                                      \
+    X(Width, "width")                                                                              \
+    X(Height, "height")                                                                            \
+    X(Cx, "cx")                                                                                    \
+    X(Cy, "cy")                                                                                    \
+    X(R, "r")                                                                                      \
+    X(Rx, "rx")                                                                                    \
+    X(Ry, "ry")                                                                                    \
+    X(Href, "href")
+
+/**
+ * Keyword values of the presentation attributes the parser interprets, as `X(identifier, name)`
+ * pairs. Values are matched case-sensitively, see `svgkeywords.h`.
+ *
+ * https://www.w3.org/TR/SVG11/propidx.html
+ */
+#define SVGSPEC_KEYWORDS(X)                                                                        \
+    X(None, "none")                                                                                \
+    X(CurrentColor, "currentColor")                                                                \
+    X(Inherit, "inherit")                                                                          \
+    X(Nonzero, "nonzero")                                                                          \
+    X(Evenodd, "evenodd")                                                                          \
+    X(Butt, "butt")                                                                                \
+    X(Round, "round")                                                                              \
+    X(Square, "square")                                                                            \
+    X(Miter, "miter")                                                                              \
+    X(Bevel, "bevel")                                                                              \
+    X(Normal, "normal")                                                                            \
+    X(Bold, "bold")                                                                                \
+    X(Bolder, "bolder")                                                                            \
+    X(Lighter, "lighter")                                                                          \
+    X(Thin, "thin")                                                                                \
+    X(Light, "light")                                                                              \
+    X(Medium, "medium")                                                                            \
+    X(Black, "black")                                                                              \
+    X(UltraCondensed, "ultra-condensed")                                                           \
+    X(ExtraCondensed, "extra-condensed")                                                           \
+    X(Condensed, "condensed")                                                                      \
+    X(SemiCondensed, "semi-condensed")                                                             \
+    X(SemiExpanded, "semi-expanded")                                                               \
+    X(Expanded, "expanded")                                                                        \
+    X(ExtraExpanded, "extra-expanded")                                                             \
+    X(UltraExpanded, "ultra-expanded")                                                             \
+    X(Italic, "italic")                                                                            \
+    X(Oblique, "oblique")                                                                          \
+    X(Start, "start")                                                                              \
+    X(Middle, "middle")                                                                            \
+    X(End, "end")
+
+/**
+ * Color keywords as `X(name, argb)` pairs, matched ignoring ASCII case. Besides the 147 keywords
+ * of SVG 1.1 this includes `transparent` of CSS 3, which `QColor` accepts as well.
+ *
+ * https://www.w3.org/TR/SVG11/types.html#ColorKeywords
+ */
+#define SVGSPEC_COLOR_KEYWORDS(X)                                                                  \
+    X("aliceblue", 0xfff0f8ff)                                                                     \
+    X("antiquewhite", 0xfffaebd7)                                                                  \
+    X("aqua", 0xff00ffff)                                                                          \
+    X("aquamarine", 0xff7fffd4)                                                                    \
+    X("azure", 0xfff0ffff)                                                                         \
+    X("beige", 0xfff5f5dc)                                                                         \
+    X("bisque", 0xffffe4c4)                                                                        \
+    X("black", 0xff000000)                                                                         \
+    X("blanchedalmond", 0xffffebcd)                                                                \
+    X("blue", 0xff0000ff)                                                                          \
+    X("blueviolet", 0xff8a2be2)                                                                    \
+    X("brown", 0xffa52a2a)                                                                         \
+    X("burlywood", 0xffdeb887)                                                                     \
+    X("cadetblue", 0xff5f9ea0)                                                                     \
+    X("chartreuse", 0xff7fff00)                                                                    \
+    X("chocolate", 0xffd2691e)                                                                     \
+    X("coral", 0xffff7f50)                                                                         \
+    X("cornflowerblue", 0xff6495ed)                                                                \
+    X("cornsilk", 0xfffff8dc)                                                                      \
+    X("crimson", 0xffdc143c)                                                                       \
+    X("cyan", 0xff00ffff)                                                                          \
+    X("darkblue", 0xff00008b)                                                                      \
+    X("darkcyan", 0xff008b8b)                                                                      \
+    X("darkgoldenrod", 0xffb8860b)                                                                 \
+    X("darkgray", 0xffa9a9a9)                                                                      \
+    X("darkgreen", 0xff006400)                                                                     \
+    X("darkgrey", 0xffa9a9a9)                                                                      \
+    X("darkkhaki", 0xffbdb76b)                                                                     \
+    X("darkmagenta", 0xff8b008b)                                                                   \
+    X("darkolivegreen", 0xff556b2f)                                                                \
+    X("darkorange", 0xffff8c00)                                                                    \
+    X("darkorchid", 0xff9932cc)                                                                    \
+    X("darkred", 0xff8b0000)                                                                       \
+    X("darksalmon", 0xffe9967a)                                                                    \
+    X("darkseagreen", 0xff8fbc8f)                                                                  \
+    X("darkslateblue", 0xff483d8b)                                                                 \
+    X("darkslategray", 0xff2f4f4f)                                                                 \
+    X("darkslategrey", 0xff2f4f4f)                                                                 \
+    X("darkturquoise", 0xff00ced1)                                                                 \
+    X("darkviolet", 0xff9400d3)                                                                    \
+    X("deeppink", 0xffff1493)                                                                      \
+    X("deepskyblue", 0xff00bfff)                                                                   \
+    X("dimgray", 0xff696969)                                                                       \
+    X("dimgrey", 0xff696969)                                                                       \
+    X("dodgerblue", 0xff1e90ff)                                                                    \
+    X("firebrick", 0xffb22222)                                                                     \
+    X("floralwhite", 0xfffffaf0)                                                                   \
+    X("forestgreen", 0xff228b22)                                                                   \
+    X("fuchsia", 0xffff00ff)                                                                       \
+    X("gainsboro", 0xffdcdcdc)                                                                     \
+    X("ghostwhite", 0xfff8f8ff)                                                                    \
+    X("gold", 0xffffd700)                                                                          \
+    X("goldenrod", 0xffdaa520)                                                                     \
+    X("gray", 0xff808080)                                                                          \
+    X("green", 0xff008000)                                                                         \
+    X("greenyellow", 0xffadff2f)                                                                   \
+    X("grey", 0xff808080)                                                                          \
+    X("honeydew", 0xfff0fff0)                                                                      \
+    X("hotpink", 0xffff69b4)                                                                       \
+    X("indianred", 0xffcd5c5c)                                                                     \
+    X("indigo", 0xff4b0082)                                                                        \
+    X("ivory", 0xfffffff0)                                                                         \
+    X("khaki", 0xfff0e68c)                                                                         \
+    X("lavender", 0xffe6e6fa)                                                                      \
+    X("lavenderblush", 0xfffff0f5)                                                                 \
+    X("lawngreen", 0xff7cfc00)                                                                     \
+    X("lemonchiffon", 0xfffffacd)                                                                  \
+    X("lightblue", 0xffadd8e6)                                                                     \
+    X("lightcoral", 0xfff08080)                                                                    \
+    X("lightcyan", 0xffe0ffff)                                                                     \
+    X("lightgoldenrodyellow", 0xfffafad2)                                                          \
+    X("lightgray", 0xffd3d3d3)                                                                     \
+    X("lightgreen", 0xff90ee90)                                                                    \
+    X("lightgrey", 0xffd3d3d3)                                                                     \
+    X("lightpink", 0xffffb6c1)                                                                     \
+    X("lightsalmon", 0xffffa07a)                                                                   \
+    X("lightseagreen", 0xff20b2aa)                                                                 \
+    X("lightskyblue", 0xff87cefa)                                                                  \
+    X("lightslategray", 0xff778899)                                                                \
+    X("lightslategrey", 0xff778899)                                                                \
+    X("lightsteelblue", 0xffb0c4de)                                                                \
+    X("lightyellow", 0xffffffe0)                                                                   \
+    X("lime", 0xff00ff00)                                                                          \
+    X("limegreen", 0xff32cd32)                                                                     \
+    X("linen", 0xfffaf0e6)                                                                         \
+    X("magenta", 0xffff00ff)                                                                       \
+    X("maroon", 0xff800000)                                                                        \
+    X("mediumaquamarine", 0xff66cdaa)                                                              \
+    X("mediumblue", 0xff0000cd)                                                                    \
+    X("mediumorchid", 0xffba55d3)                                                                  \
+    X("mediumpurple", 0xff9370db)                                                                  \
+    X("mediumseagreen", 0xff3cb371)                                                                \
+    X("mediumslateblue", 0xff7b68ee)                                                               \
+    X("mediumspringgreen", 0xff00fa9a)                                                             \
+    X("mediumturquoise", 0xff48d1cc)                                                               \
+    X("mediumvioletred", 0xffc71585)                                                               \
+    X("midnightblue", 0xff191970)                                                                  \
+    X("mintcream", 0xfff5fffa)                                                                     \
+    X("mistyrose", 0xffffe4e1)                                                                     \
+    X("moccasin", 0xffffe4b5)                                                                      \
+    X("navajowhite", 0xffffdead)                                                                   \
+    X("navy", 0xff000080)                                                                          \
+    X("oldlace", 0xfffdf5e6)                                                                       \
+    X("olive", 0xff808000)                                                                         \
+    X("olivedrab", 0xff6b8e23)                                                                     \
+    X("orange", 0xffffa500)                                                                        \
+    X("orangered", 0xffff4500)                                                                     \
+    X("orchid", 0xffda70d6)                                                                        \
+    X("palegoldenrod", 0xffeee8aa)                                                                 \
+    X("palegreen", 0xff98fb98)                                                                     \
+    X("paleturquoise", 0xffafeeee)                                                                 \
+    X("palevioletred", 0xffdb7093)                                                                 \
+    X("papayawhip", 0xffffefd5)                                                                    \
+    X("peachpuff", 0xffffdab9)                                                                     \
+    X("peru", 0xffcd853f)                                                                          \
+    X("pink", 0xffffc0cb)                                                                          \
+    X("plum", 0xffdda0dd)                                                                          \
+    X("powderblue", 0xffb0e0e6)                                                                    \
+    X("purple", 0xff800080)                                                                        \
+    X("red", 0xffff0000)                                                                           \
+    X("rosybrown", 0xffbc8f8f)                                                                     \
+    X("royalblue", 0xff4169e1)                                                                     \
+    X("saddlebrown", 0xff8b4513)                                                                   \
+    X("salmon", 0xfffa8072)                                                                        \
+    X("sandybrown", 0xfff4a460)                                                                    \
+    X("seagreen", 0xff2e8b57)                                                                      \
+    X("seashell", 0xfffff5ee)                                                                      \
+    X("sienna", 0xffa0522d)                                                                        \
+    X("silver", 0xffc0c0c0)                                                                        \
+    X("skyblue", 0xff87ceeb)                                                                       \
+    X("slateblue", 0xff6a5acd)                                                                     \
+    X("slategray", 0xff708090)                                                                     \
+    X("slategrey", 0xff708090)                                                                     \
+    X("snow", 0xfffffafa)                                                                          \
+    X("springgreen", 0xff00ff7f)                                                                   \
+    X("steelblue", 0xff4682b4)                                                                     \
+    X("tan", 0xffd2b48c)                                                                           \
+    X("teal", 0xff008080)                                                                          \
+    X("thistle", 0xffd8bfd8)                                                                       \
+    X("tomato", 0xffff6347)                                                                        \
+    X("transparent", 0x00000000)                                                                   \
+    X("turquoise", 0xff40e0d0)                                                                     \
+    X("violet", 0xffee82ee)                                                                        \
+    X("wheat", 0xfff5deb3)                                                                         \
+    X("white", 0xffffffff)                                                                         \
+    X("whitesmoke", 0xfff5f5f5)                                                                    \
+    X("yellow", 0xffffff00)                                                                        \
+    X("yellowgreen", 0xff9acd32)
+
 namespace svgscene { namespace svgspec {
 
+    #define SVGSPEC_STRING_LITERAL(ident, name) QStringLiteral(name),
+
     /**
      * https://developer.mozilla.org/en-US/docs/Web/SVG/Attribute
      */
     static const QSet<QString> presentation_attributes {
         // NOLINT(cert-err58-cpp)
-        QStringLiteral("alignment-baseline"),
-        QStringLiteral("baseline-shift"),
-        QStringLiteral("clip"),
-        QStringLiteral("clip-path"),
-        QStringLiteral("clip-rule"),
-        QStringLiteral("color"),
-        QStringLiteral("color-interpolation"),
-        QStringLiteral("color-interpolation-filters"),
-        QStringLiteral("color-profile"),
-        QStringLiteral("color-rendering"),
-        QStringLiteral("cursor"),
-        QStringLiteral("direction"),
-        QStringLiteral("display"),
-        QStringLiteral("dominant-baseline"),
-        QStringLiteral("enable-background"),
-        QStringLiteral("fill"),
-        QStringLiteral("fill-opacity"),
-        QStringLiteral("fill-rule"),
-        QStringLiteral("filter"),
-        QStringLiteral("flood-color"),
-        QStringLiteral("flood-opacity"),
-        QStringLiteral("font-family"),
-        QStringLiteral("font-size"),
-        QStringLiteral("font-size-adjust"),
-        QStringLiteral("font-stretch"),
-        QStringLiteral("font-style"),
-        QStringLiteral("font-variant"),
-        QStringLiteral("font-weight"),
-        QStringLiteral("glyph-orientation-horizontal"),
-        QStringLiteral("glyph-orientation-vertical"),
-        QStringLiteral("image-rendering"),
-        QStringLiteral("kerning"),
-        QStringLiteral("letter-spacing"),
-        QStringLiteral("lighting-color"),
-        QStringLiteral("marker-end"),
-        QStringLiteral("marker-mid"),
-        QStringLiteral("marker-start"),
-        QStringLiteral("mask"),
-        QStringLiteral("opacity"),
-        QStringLiteral("overflow"),
-        QStringLiteral("pointer-events"),
-        QStringLiteral("shape-rendering"),
-        QStringLiteral("stop-color"),
-        QStringLiteral("stop-opacity"),
-        QStringLiteral("stroke"),
-        QStringLiteral("stroke-dasharray"),
-        QStringLiteral("stroke-dashoffset"),
-        QStringLiteral("stroke-linecap"),
-        QStringLiteral("stroke-linejoin"),
-        QStringLiteral("stroke-miterlimit"),
-        QStringLiteral("stroke-opacity"),
-        QStringLiteral("stroke-width"),
-        QStringLiteral("text-anchor"),
-        QStringLiteral("text-decoration"),
-        QStringLiteral("text-rendering"),
-        QStringLiteral("transform"),
-        QStringLiteral("transform-origin"),
-        QStringLiteral("unicode-bidi"),
-        QStringLiteral("vector-effect"),
-        QStringLiteral("visibility"),
-        QStringLiteral("word-spacing"),
-        QStringLiteral("writing-mode"),
+        SVGSPEC_PRESENTATION_ATTRIBUTES(SVGSPEC_STRING_LITERAL)
     };
+
+    #undef SVGSPEC_STRING_LITERAL
 }} // namespace svgscene::svgspec
\ No newline at end of file
@@ -0,0 +1,95 @@
+#include "svgstats.h"
+
+#include <QJsonObject>
+
+namespace svgscene {
+
+const char *phaseName(ParsePhase phase) {
+    switch (phase) {
+    case ParsePhase::Tokenize: return "tokenize";
+    case ParsePhase::Attributes: return "attributes";
+    case ParsePhase::Geometry: return "geometry";
+    case ParsePhase::Style: return "style";
+    case ParsePhase::Text: return "text";
+    case ParsePhase::SceneInsertion: return "sceneInsertion";
+    }
+    return "unknown";
+}
+
+void ParseProfile::add(const ParseProfile &other) {
+    for (int i = 0; i < PARSE_PHASE_COUNT; ++i) {
+        phases[i].count += other.phases[i].count;
+        phases[i].nanoseconds += other.phases[i].nanoseconds;
+    }
+    for (auto it = other.elements.constBegin(); it != other.elements.constEnd(); ++it) {
+        ElementStats &stats = elements[it.key()];
+        stats.count += it->count;
+        stats.nanoseconds += it->nanoseconds;
+        stats.attributeBytes += it->attributeBytes;
+        stats.pathSegments += it->pathSegments;
+    }
+}
+
+/** JSON numbers are doubles, counters stay exact up to 2^53. */
+static QJsonValue number(quint64 value) {
+    return QJsonValue(double(value));
+}
+
+QByteArray ParseStats::toJson(QJsonDocument::JsonFormat format) const {
+    QJsonObject path_cache;
+    path_cache.insert(QStringLiteral("hits"), number(pathCacheHits));
+    path_cache.insert(QStringLiteral("misses"), number(pathCacheMisses));
+    path_cache.insert(QStringLiteral("savedElements"), number(pathCacheSavedElements));
+
+    QJsonObject transform_cache;
+    transform_cache.insert(QStringLiteral("hits"), number(transformCacheHits));
+    transform_cache.insert(QStringLiteral("misses"), number(transformCacheMisses));
+
+    QJsonObject paint_cache;
+    paint_cache.insert(QStringLiteral("size"), number(paintCacheSize));
+    paint_cache.insert(QStringLiteral("hits"), number(paintCacheHits));
+    paint_cache.insert(QStringLiteral("misses"), number(paintCacheMisses));
+
+    QJsonObject font_cache;
+    font_cache.insert(QStringLiteral("size"), number(fontCacheSize));
+    font_cache.insert(QStringLiteral("hits"), number(fontCacheHits));
+    font_cache.insert(QStringLiteral("misses"), number(fontCacheMisses));
+
+    QJsonObject arena;
+    arena.insert(QStringLiteral("allocations"), number(arenaAllocations));
+    arena.insert(QStringLiteral("blocks"), number(arenaBlocks));
+
+    QJsonObject root;
+    root.insert(QStringLiteral("pathCache"), path_cache);
+    root.insert(QStringLiteral("transformCache"), transform_cache);
+    root.insert(QStringLiteral("paintCache"), paint_cache);
+    root.insert(QStringLiteral("fontCache"), font_cache);
+    root.insert(QStringLiteral("arena"), arena);
+    root.insert(QStringLiteral("profiled"), profiled);
+
+    if (profiled) {
+        QJsonObject phases;
+        for (int i = 0; i < PARSE_PHASE_COUNT; ++i) {
+            const PhaseStats &stats = profile.phases[i];
+            QJsonObject phase;
+            phase.insert(QStringLiteral("count"), number(stats.count));
+            phase.insert(QStringLiteral("ns"), number(stats.nanoseconds));
+            phases.insert(QString::fromLatin1(phaseName(ParsePhase(i))), phase);
+        }
+        root.insert(QStringLiteral("phases"), phases);
+
+        QJsonObject elements;
+        for (auto it = profile.elements.constBegin(); it != profile.elements.constEnd(); ++it) {
+            QJsonObject element;
+            element.insert(QStringLiteral("count"), number(it->count));
+            element.insert(QStringLiteral("ns"), number(it->nanoseconds));
+            element.insert(QStringLiteral("attributeBytes"), number(it->attributeBytes));
+            element.insert(QStringLiteral("pathSegments"), number(it->pathSegments));
+            elements.insert(it.key(), element);
+        }
+        root.insert(QStringLiteral("elements"), elements);
+    }
+    return QJsonDocument(root).toJson(format);
+}
+
+} // namespace svgscene
@@ -0,0 +1,142 @@
+/**
+ * Counters collected while parsing a document.
+ *
+ * The cache counters are always collected. Timers of the phases and counters per element name
+ * are collected only when profiling is enabled (see `ParseOptions::profile`), otherwise each
+ * measured place costs one test of a null pointer.
+ *
+ * @file
+ */
+#pragma once
+
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QMap>
+#include <QString>
+#include <QtGlobal>
+
+namespace svgscene {
+
+/** Parts of the parse measured by the profiling. */
+enum class ParsePhase : quint8 {
+    /** Reading of the XML tokens (including the `SvgTreeBuilder` dispatch). */
+    Tokenize,
+    /** Reading of attributes, presentation attributes and `style` merged into the style. */
+    Attributes,
+    /** Decoding of paths, transforms and shapes (wall time of all threads). */
+    Geometry,
+    /** Pens and brushes applied to the items. */
+    Style,
+    /** Fonts applied to the text items and their text set. */
+    Text,
+    /** Items added to the scene and their parents. */
+    SceneInsertion,
+};
+
+constexpr int PARSE_PHASE_COUNT = int(ParsePhase::SceneInsertion) + 1;
+
+/** Name of the phase used in the JSON output, e.g. `sceneInsertion`. */
+const char *phaseName(ParsePhase phase);
+
+struct PhaseStats {
+    /** Number of measured intervals. */
+    quint64 count = 0;
+    quint64 nanoseconds = 0;
+};
+
+struct ElementStats {
+    quint64 count = 0;
+    /** Time spent on the elements in the tree phase (attributes) and creating their items. */
+    quint64 nanoseconds = 0;
+    /** Size of the attribute values in memory. */
+    quint64 attributeBytes = 0;
+    /** Elements of the decoded paths (`QPainterPath::elementCount`). */
+    quint64 pathSegments = 0;
+};
+
+/** Timers and counters of the profiling. */
+struct ParseProfile {
+    PhaseStats phases[PARSE_PHASE_COUNT];
+    /** Keyed by the element name. */
+    QMap<QString, ElementStats> elements;
+
+    PhaseStats &phase(ParsePhase phase) { return phases[int(phase)]; }
+    const PhaseStats &phase(ParsePhase phase) const { return phases[int(phase)]; }
+
+    /** Adds the counters of the other profile to this one. */
+    void add(const ParseProfile &other);
+};
+
+/**
+ * Adds the time from its construction to its destruction to a phase, does nothing without
+ * a profile.
+ */
+class PhaseTimer {
+public:
+    PhaseTimer(ParseProfile *profile, ParsePhase phase) : m_profile(profile), m_phase(phase) {
+        if (m_profile != nullptr) {
+            m_timer.start();
+        }
+    }
+
+    ~PhaseTimer() {
+        if (m_profile != nullptr) {
+            PhaseStats &stats = m_profile->phase(m_phase);
+            ++stats.count;
+            stats.nanoseconds += quint64(m_timer.nsecsElapsed());
+        }
+    }
+
+    PhaseTimer(const PhaseTimer &) = delete;
+    PhaseTimer &operator=(const PhaseTimer &) = delete;
+
+private:
+    ParseProfile *m_profile;
+    ParsePhase m_phase;
+    QElapsedTimer m_timer;
+};
+
+struct ParseStats {
+    /** Path elements whose data had to be decoded. */
+    quint64 pathCacheMisses = 0;
+    /** Path elements sharing an already decoded path (from the same document or the process). */
+    quint64 pathCacheHits = 0;
+    /** Path elements (`QPainterPath::Element`) not allocated thanks to the sharing. */
+    quint64 pathCacheSavedElements = 0;
+
+    /** Elements whose transform list had to be parsed. */
+    quint64 transformCacheMisses = 0;
+    /** Elements sharing an already parsed transform list of the document. */
+    quint64 transformCacheHits = 0;
+
+    /** Distinct pen and brush combinations of the document's shapes, see `svgpaintcache.h`. */
+    quint64 paintCacheSize = 0;
+    /** Shapes reusing an already resolved pen and brush. */
+    quint64 paintCacheHits = 0;
+    /** Shapes whose pen and brush had to be resolved. */
+    quint64 paintCacheMisses = 0;
+
+    /** Distinct fonts of the document's text items, see `svgfontcache.h`. */
+    quint64 fontCacheSize = 0;
+    /** Text items reusing an already resolved font and its metrics. */
+    quint64 fontCacheHits = 0;
+    /** Text items whose font had to be resolved. */
+    quint64 fontCacheMisses = 0;
+
+    /** Temporary arrays of the parse served by arenas instead of the heap, see `svgarena.h`. */
+    quint64 arenaAllocations = 0;
+    /** Blocks the arenas allocated from the heap for them. */
+    quint64 arenaBlocks = 0;
+
+    /** Whether `profile` was collected. */
+    bool profiled = false;
+    ParseProfile profile;
+
+    /**
+     * All counters as a JSON object, for telemetry. Counters are numbers, times are in
+     * nanoseconds; `phases` and `elements` are present only when profiled.
+     */
+    QByteArray toJson(QJsonDocument::JsonFormat format = QJsonDocument::Indented) const;
+};
+
+} // namespace svgscene
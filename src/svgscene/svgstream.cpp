@@ -0,0 +1,144 @@
+#include "svgstream.h"
+
+#include "svghandler.h"
+#include "utils/logging.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+
+LOG_CATEGORY("svgscene.stream");
+
+namespace svgscene {
+
+/** Size of the chunks read from a file per slice. */
+static const qint64 FILE_CHUNK_SIZE = 256 * 1024;
+/** Tokens read between checks of the slice time. */
+static const int TOKENS_PER_CHECK = 64;
+
+SvgStreamLoader::SvgStreamLoader(QGraphicsScene *scene, QObject *parent)
+    : QObject(parent)
+    , m_handler(new SvgHandler(scene))
+    , m_reader(&m_xml) {}
+
+SvgStreamLoader::~SvgStreamLoader() = default;
+
+void SvgStreamLoader::setSliceTime(int msecs) {
+    m_sliceTime = msecs;
+}
+
+void SvgStreamLoader::setSliceTokens(int tokens) {
+    m_sliceTokens = tokens;
+}
+
+void SvgStreamLoader::setOptions(const ParseOptions &options) {
+    m_builder.setOptions(options);
+    m_handler->setIndexedAttributes(options.indexedAttributes);
+    m_handler->setIndexedSearch(options.indexedSearch);
+}
+
+bool SvgStreamLoader::loadFile(const QString &filename) {
+    m_file.reset(new QFile(filename));
+    if (!m_file->open(QIODevice::ReadOnly)) {
+        WARN() << "cannot open" << filename << m_file->errorString();
+        m_file.reset();
+        return false;
+    }
+    setTotalSize(m_file->size());
+    scheduleSlice();
+    return true;
+}
+
+void SvgStreamLoader::addData(const QByteArray &data) {
+    if (m_dataFinished) {
+        WARN() << "data added after the end of the document";
+        return;
+    }
+    m_xml.addData(data);
+    m_bytesAdded += data.size();
+    scheduleSlice();
+}
+
+void SvgStreamLoader::finishData() {
+    m_dataFinished = true;
+    scheduleSlice();
+}
+
+void SvgStreamLoader::setTotalSize(qint64 bytes) {
+    m_bytesTotal = bytes;
+}
+
+bool SvgStreamLoader::isFinished() const {
+    return m_finished;
+}
+
+QString SvgStreamLoader::errorString() const {
+    if (m_xml.hasError() && !m_reader.needsMoreData()) {
+        return m_xml.errorString();
+    }
+    return QString();
+}
+
+SvgDocument SvgStreamLoader::document() const {
+    return m_handler->getDocument();
+}
+
+void SvgStreamLoader::scheduleSlice() {
+    if (m_sliceScheduled || m_finished) {
+        return;
+    }
+    m_sliceScheduled = true;
+    QMetaObject::invokeMethod(this, "processSlice", Qt::QueuedConnection);
+}
+
+void SvgStreamLoader::processSlice() {
+    m_sliceScheduled = false;
+    if (m_finished) {
+        return;
+    }
+    if (m_file) {
+        const QByteArray chunk = m_file->read(FILE_CHUNK_SIZE);
+        m_xml.addData(chunk);
+        m_bytesAdded += chunk.size();
+        if (chunk.isEmpty() || m_file->atEnd()) {
+            m_file.reset();
+            m_dataFinished = true;
+        }
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    int tokens = 0;
+    bool reading = true;
+    while (reading && timer.elapsed() < m_sliceTime
+           && (m_sliceTokens <= 0 || tokens < m_sliceTokens)) {
+        const int batch = (m_sliceTokens > 0) ? qMin(TOKENS_PER_CHECK, m_sliceTokens - tokens)
+                                              : TOKENS_PER_CHECK;
+        reading = m_builder.readSome(&m_reader, batch);
+        tokens += batch;
+    }
+    m_builder.decodePending();
+    m_handler->loadIncrement(m_builder.tree(), m_builder.tree().nodes().size(), false);
+    emit progress(m_xml.characterOffset(), m_bytesTotal);
+
+    if (reading || m_file) {
+        // Budget exhausted or next chunk of the file is waiting.
+        scheduleSlice();
+    } else if (!m_reader.needsMoreData() || m_dataFinished) {
+        finish();
+    }
+    // Otherwise waits for `addData`.
+}
+
+void SvgStreamLoader::finish() {
+    m_finished = true;
+    if (m_reader.needsMoreData()) {
+        WARN() << "document ended prematurely";
+    } else if (m_xml.hasError()) {
+        WARN() << "XML error:" << m_xml.errorString();
+    }
+    const SvgTree tree = m_builder.take();
+    m_handler->loadIncrement(tree, tree.nodes().size(), true);
+    emit finished();
+}
+
+} // namespace svgscene
@@ -0,0 +1,112 @@
+/**
+ * Cooperative incremental loading.
+ *
+ * `SvgStreamLoader` parses the document in short slices run from the event loop, so that the
+ * application stays responsive and items created so far are displayed while the rest is being
+ * read. Data can be fed in chunks as they arrive (e.g. from a network reply), reading overlaps with
+ * parsing then.
+ *
+ * ## Example
+ * ```
+ *  auto *loader = new SvgStreamLoader(scene, this);
+ *  connect(loader, &SvgStreamLoader::progress, bar, [bar](qint64 done, qint64 total) {
+ *      bar->setValue(int(100 * done / qMax<qint64>(total, 1)));
+ *  });
+ *  connect(loader, &SvgStreamLoader::finished, this, [this, loader] {
+ *      install(loader->document());
+ *      loader->deleteLater();
+ *  });
+ *  loader->loadFile(path);
+ * ```
+ *
+ * @file
+ */
+#pragma once
+
+#include "svgdocument.h"
+#include "svgreader.h"
+#include "svgtree.h"
+
+#include <QObject>
+#include <QScopedPointer>
+#include <QSharedPointer>
+#include <QXmlStreamReader>
+
+class QFile;
+class QGraphicsScene;
+
+namespace svgscene {
+
+class SvgHandler;
+
+class SvgStreamLoader : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @param scene     scene where produced elements will be placed
+     */
+    explicit SvgStreamLoader(QGraphicsScene *scene, QObject *parent = nullptr);
+    ~SvgStreamLoader() override;
+
+    /** Time spent parsing in a single slice before yielding to the event loop, 10 ms default. */
+    void setSliceTime(int msecs);
+    /** Maximum number of XML tokens read in a single slice, 0 (default) means no limit. */
+    void setSliceTokens(int tokens);
+    /** Options of the geometry decoding and `indexedAttributes`, see `ParseOptions`. */
+    void setOptions(const ParseOptions &options);
+
+    /** Reads the file in chunks, one chunk per slice. Returns false, if it cannot be opened. */
+    bool loadFile(const QString &filename);
+    /**
+     * Appends the next chunk of the document. Parsing continues in the next slice.
+     *
+     * @param data          any part of the document, need not end at a token boundary
+     */
+    void addData(const QByteArray &data);
+    /** No more data will be added, the document is complete. */
+    void finishData();
+    /** Total size of the document in bytes for the progress, if known in advance. */
+    void setTotalSize(qint64 bytes);
+
+    bool isFinished() const;
+    /** Error of the XML reader, empty if the document was read successfully. */
+    QString errorString() const;
+    /** Loaded document, available once `finished` was emitted (throws, if it has no root). */
+    SvgDocument document() const;
+
+signals:
+    /**
+     * Emitted after each slice.
+     *
+     * @param bytes_read    position of the reader in the document (counted in characters,
+     *                      which equals bytes for ASCII documents)
+     * @param bytes_total   total size, -1 when not known
+     */
+    void progress(qint64 bytes_read, qint64 bytes_total);
+    /** The whole document was processed (or reading stopped on an error). */
+    void finished();
+
+private slots:
+    void processSlice();
+
+private:
+    void scheduleSlice();
+    void finish();
+
+    QSharedPointer<SvgHandler> m_handler;
+    QXmlStreamReader m_xml;
+    QtXmlReader m_reader;
+    SvgTreeBuilder m_builder;
+    QScopedPointer<QFile> m_file;
+
+    int m_sliceTime = 10;
+    int m_sliceTokens = 0;
+    qint64 m_bytesAdded = 0;
+    qint64 m_bytesTotal = -1;
+    bool m_dataFinished = false;
+    bool m_sliceScheduled = false;
+    bool m_finished = false;
+};
+
+} // namespace svgscene
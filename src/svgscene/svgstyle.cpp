@@ -0,0 +1,48 @@
+#include "svgstyle.h"
+
+namespace svgscene {
+
+static QColor withOpacity(QColor color, bool has_opacity, qreal opacity) {
+    if (has_opacity && color.isValid()) {
+        color.setAlphaF(opacity);
+    }
+    return color;
+}
+
+QColor ComputedStyleData::effectiveFillColor() const {
+    return withOpacity(fillColor, hasFillOpacity, fillOpacity);
+}
+
+QColor ComputedStyleData::effectiveStrokeColor() const {
+    return withOpacity(strokeColor, hasStrokeOpacity, strokeOpacity);
+}
+
+/** All default constructed styles share the same data until edited. */
+static const QSharedDataPointer<ComputedStyleData> &defaultData() {
+    static const QSharedDataPointer<ComputedStyleData> data(new ComputedStyleData());
+    return data;
+}
+
+ComputedStyle::ComputedStyle() : d(defaultData()) {}
+
+const ComputedStyleData &ComputedStyle::get() const {
+    return *d.constData();
+}
+
+const ComputedStyleData *ComputedStyle::operator->() const {
+    return d.constData();
+}
+
+ComputedStyleData &ComputedStyle::edit() {
+    return *d.data();
+}
+
+const QString *ComputedStyle::declared(Atom property) const {
+    return d.constData()->declared.find(property);
+}
+
+bool ComputedStyle::isSharedWith(const ComputedStyle &other) const {
+    return d.constData() == other.d.constData();
+}
+
+} // namespace svgscene
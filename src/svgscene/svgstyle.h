@@ -0,0 +1,107 @@
+/**
+ * Computed style of an SVG element.
+ *
+ * Style is inherited from the parent element and usually only a few properties (if any) are
+ * overridden by the child. The style is therefore stored in an implicitly shared structure, an
+ * element that does not override anything shares the data with its parent and inheritance costs
+ * a single pointer copy. Values are parsed to their typed form once, when the property is
+ * declared, not when it is applied to each item.
+ *
+ * @file
+ */
+#pragma once
+
+#include "svgattributes.h"
+
+#include <QColor>
+#include <QFont>
+#include <QSharedData>
+#include <QSharedDataPointer>
+#include <QVector>
+
+namespace svgscene {
+
+/**
+ * Kind of paint (fill or stroke) value.
+ */
+enum class PaintType : quint8 {
+    /** Property not declared (or declared empty). */
+    Unset,
+    None,
+    /** Color value, the color may be invalid (`currentColor`, `inherit`, unknown names). */
+    Color,
+};
+
+/**
+ * Unit of the `font-size` property, sizes in other units are ignored.
+ */
+enum class FontSizeUnit : quint8 {
+    None,
+    Px,
+    Pt,
+};
+
+/**
+ * Typed values of the supported properties. Defaults correspond to undeclared properties.
+ */
+struct ComputedStyleData : public QSharedData {
+    /** Values as declared in the document (including unsupported properties). */
+    AttributeList declared;
+
+    PaintType fill = PaintType::Unset;
+    QColor fillColor;
+    bool hasFillOpacity = false;
+    qreal fillOpacity = 1;
+    Qt::FillRule fillRule = Qt::WindingFill;
+
+    PaintType stroke = PaintType::Unset;
+    QColor strokeColor;
+    bool hasStrokeOpacity = false;
+    qreal strokeOpacity = 1;
+    qreal strokeWidth = 0;
+    Qt::PenCapStyle strokeLinecap = Qt::FlatCap;
+    Qt::PenJoinStyle strokeLinejoin = Qt::MiterJoin;
+    /** Empty, when not declared, `none` or invalid. */
+    QVector<qreal> strokeDashArray;
+    bool hasStrokeDashOffset = false;
+    qreal strokeDashOffset = 0;
+
+    QString fontFamily;
+    FontSizeUnit fontSizeUnit = FontSizeUnit::None;
+    qreal fontSize = 0;
+    QFont::Weight fontWeight = QFont::Normal;
+    QFont::Stretch fontStretch = QFont::Unstretched;
+    QFont::Style fontStyle = QFont::StyleNormal;
+    Qt::Alignment textAnchor = Qt::AlignLeft;
+
+    /** Fill color with `fill-opacity` applied. */
+    QColor effectiveFillColor() const;
+    /** Stroke color with `stroke-opacity` applied. */
+    QColor effectiveStrokeColor() const;
+};
+
+/**
+ * Copy-on-write handle to computed style. Copying is cheap, the data are detached only when
+ * `edit` is called.
+ */
+class ComputedStyle {
+public:
+    ComputedStyle();
+
+    const ComputedStyleData &get() const;
+    const ComputedStyleData *operator->() const;
+
+    /** Detaches the data (if shared) and returns them for modification. */
+    ComputedStyleData &edit();
+
+    /** Declared value of a property or nullptr. */
+    const QString *declared(Atom property) const;
+
+    /** True, when both handles point to the same data (no property was overridden). */
+    bool isSharedWith(const ComputedStyle &other) const;
+
+private:
+    QSharedDataPointer<ComputedStyleData> d;
+};
+
+} // namespace svgscene
@@ -0,0 +1,440 @@
+#include "svgtokenizer.h"
+
+#include <cstring>
+
+namespace svgscene {
+
+enum DecodeMode {
+    DecodeText,
+    DecodeCData,
+    DecodeAttribute,
+};
+
+static inline bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static inline bool isNameChar(char c) {
+    switch (c) {
+    case ' ':
+    case '\t':
+    case '\n':
+    case '\r':
+    case '/':
+    case '>':
+    case '<':
+    case '=':
+    case '?':
+    case '"':
+    case '\'': return false;
+    default: return true;
+    }
+}
+
+static inline bool startsWith(const char *pos, const char *end, const char *literal, int length) {
+    return end - pos >= length && std::memcmp(pos, literal, static_cast<size_t>(length)) == 0;
+}
+
+static inline const char *findChar(const char *begin, const char *end, char c) {
+    return static_cast<const char *>(std::memchr(begin, c, static_cast<size_t>(end - begin)));
+}
+
+static void appendUtf8(QByteArray &out, uint code_point) {
+    if (code_point < 0x80) {
+        out.append(static_cast<char>(code_point));
+    } else if (code_point < 0x800) {
+        out.append(static_cast<char>(0xc0 | (code_point >> 6)));
+        out.append(static_cast<char>(0x80 | (code_point & 0x3f)));
+    } else if (code_point < 0x10000) {
+        out.append(static_cast<char>(0xe0 | (code_point >> 12)));
+        out.append(static_cast<char>(0x80 | ((code_point >> 6) & 0x3f)));
+        out.append(static_cast<char>(0x80 | (code_point & 0x3f)));
+    } else {
+        out.append(static_cast<char>(0xf0 | (code_point >> 18)));
+        out.append(static_cast<char>(0x80 | ((code_point >> 12) & 0x3f)));
+        out.append(static_cast<char>(0x80 | ((code_point >> 6) & 0x3f)));
+        out.append(static_cast<char>(0x80 | (code_point & 0x3f)));
+    }
+}
+
+/**
+ * Resolves predefined entity or character reference (text between `&` and `;`).
+ */
+static bool appendReference(QByteArray &out, const char *name, int length) {
+    if (length >= 2 && name[0] == '#') {
+        uint code_point = 0;
+        const bool hex = (name[1] == 'x');
+        for (int i = hex ? 2 : 1; i < length; ++i) {
+            const char c = name[i];
+            uint digit;
+            if (c >= '0' && c <= '9') {
+                digit = static_cast<uint>(c - '0');
+            } else if (hex && c >= 'a' && c <= 'f') {
+                digit = static_cast<uint>(c - 'a' + 10);
+            } else if (hex && c >= 'A' && c <= 'F') {
+                digit = static_cast<uint>(c - 'A' + 10);
+            } else {
+                return false;
+            }
+            code_point = code_point * (hex ? 16 : 10) + digit;
+            if (code_point > 0x10ffff) {
+                return false;
+            }
+        }
+        appendUtf8(out, code_point);
+        return true;
+    }
+    struct Entity {
+        const char *name;
+        int length;
+        char value;
+    };
+    static const Entity ENTITIES[] = {
+        { "lt", 2, '<' },     { "gt", 2, '>' },       { "amp", 3, '&' },
+        { "quot", 4, '"' },   { "apos", 4, '\'' },
+    };
+    for (const Entity &entity : ENTITIES) {
+        if (entity.length == length && std::memcmp(entity.name, name, size_t(length)) == 0) {
+            out.append(entity.value);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Converts raw input to string applying XML end-of-line handling, attribute value normalization
+ * and reference resolution as required by the mode.
+ */
+static QString decodeSpan(const char *begin, int size, DecodeMode mode) {
+    bool plain = true;
+    for (int i = 0; i < size && plain; ++i) {
+        const char c = begin[i];
+        plain = !(c == '\r' || (c == '&' && mode != DecodeCData)
+                  || (mode == DecodeAttribute && (c == '\n' || c == '\t')));
+    }
+    if (plain) {
+        return QString::fromUtf8(begin, size);
+    }
+
+    QByteArray buffer;
+    buffer.reserve(size);
+    for (int i = 0; i < size; ++i) {
+        char c = begin[i];
+        if (c == '\r') {
+            c = '\n';
+            if (i + 1 < size && begin[i + 1] == '\n') {
+                ++i;
+            }
+        }
+        if (mode == DecodeAttribute && (c == '\n' || c == '\t')) {
+            c = ' ';
+        }
+        if (c == '&' && mode != DecodeCData) {
+            const char *semicolon = findChar(begin + i, begin + size, ';');
+            if (semicolon != nullptr) {
+                const int name_start = i + 1;
+                const int name_length = static_cast<int>(semicolon - begin) - name_start;
+                if (appendReference(buffer, begin + name_start, name_length)) {
+                    i = static_cast<int>(semicolon - begin);
+                    continue;
+                }
+            }
+        }
+        buffer.append(c);
+    }
+    return QString::fromUtf8(buffer);
+}
+
+SvgTokenizer::SvgTokenizer(const char *begin, const char *end) : m_pos(begin), m_end(end) {
+    // Byte order mark
+    if (startsWith(m_pos, m_end, "\xef\xbb\xbf", 3)) {
+        m_pos += 3;
+    }
+}
+
+bool SvgTokenizer::isSupportedEncoding(const char *begin, const char *end) {
+    if (startsWith(begin, end, "\xef\xbb\xbf", 3)) {
+        return true;
+    }
+    if (startsWith(begin, end, "\xff\xfe", 2) || startsWith(begin, end, "\xfe\xff", 2)) {
+        return false;
+    }
+    if (!startsWith(begin, end, "<?xml", 5)) {
+        return true;
+    }
+    const QByteArray declaration(begin, static_cast<int>(qMin<qint64>(end - begin, 256)));
+    const int declaration_end = declaration.indexOf("?>");
+    const int encoding = declaration.indexOf("encoding");
+    if (encoding < 0 || (declaration_end >= 0 && encoding > declaration_end)) {
+        return true;
+    }
+    int quote = encoding + 8;
+    while (quote < declaration.size() && declaration.at(quote) != '"'
+           && declaration.at(quote) != '\'') {
+        ++quote;
+    }
+    if (quote >= declaration.size()) {
+        return false;
+    }
+    const int close = declaration.indexOf(declaration.at(quote), quote + 1);
+    if (close < 0) {
+        return false;
+    }
+    const QByteArray name = declaration.mid(quote + 1, close - quote - 1).toLower();
+    return name == "utf-8" || name == "utf8" || name == "us-ascii" || name == "ascii";
+}
+
+SvgReader::TokenType SvgTokenizer::readNext() {
+    if (atEnd()) {
+        return m_token;
+    }
+    m_attributes.clear();
+    if (m_pendingEnd) {
+        m_pendingEnd = false;
+        m_name = m_openElements.takeLast();
+        return m_token = EndElement;
+    }
+    if (m_pos >= m_end) {
+        if (!m_openElements.isEmpty()) {
+            return fail("Premature end of document.");
+        }
+        return m_token = EndDocument;
+    }
+    if (*m_pos != '<') {
+        const char *next = findChar(m_pos, m_end, '<');
+        if (next == nullptr) {
+            next = m_end;
+        }
+        m_text.begin = m_pos;
+        m_text.size = static_cast<int>(next - m_pos);
+        m_textIsCData = false;
+        m_pos = next;
+        // Whitespace around the root element is not part of the document content.
+        return m_token = m_openElements.isEmpty() ? Other : Characters;
+    }
+    return m_token = readMarkup();
+}
+
+SvgReader::TokenType SvgTokenizer::readMarkup() {
+    const char *markup = m_pos + 1;
+    if (startsWith(markup, m_end, "!--", 3)) {
+        m_pos = markup + 3;
+        const char *start = m_pos;
+        if (!skipPast("-->", 3)) {
+            return fail("Unterminated comment.");
+        }
+        m_text.begin = start;
+        m_text.size = static_cast<int>(m_pos - 3 - start);
+        return Comment;
+    }
+    if (startsWith(markup, m_end, "![CDATA[", 8)) {
+        m_pos = markup + 8;
+        const char *start = m_pos;
+        if (!skipPast("]]>", 3)) {
+            return fail("Unterminated CDATA section.");
+        }
+        m_text.begin = start;
+        m_text.size = static_cast<int>(m_pos - 3 - start);
+        m_textIsCData = true;
+        return Characters;
+    }
+    if (startsWith(markup, m_end, "!", 1)) {
+        // DOCTYPE with optional internal subset, only skipped.
+        int depth = 0;
+        char quote = 0;
+        for (m_pos = markup + 1; m_pos < m_end; ++m_pos) {
+            const char c = *m_pos;
+            if (quote != 0) {
+                if (c == quote) {
+                    quote = 0;
+                }
+            } else if (c == '"' || c == '\'') {
+                quote = c;
+            } else if (c == '[') {
+                ++depth;
+            } else if (c == ']') {
+                --depth;
+            } else if (c == '>' && depth <= 0) {
+                ++m_pos;
+                return Other;
+            }
+        }
+        return fail("Unterminated declaration.");
+    }
+    if (startsWith(markup, m_end, "?", 1)) {
+        m_pos = markup + 1;
+        Span target;
+        readName(target);
+        if (!skipPast("?>", 2)) {
+            return fail("Unterminated processing instruction.");
+        }
+        const bool is_declaration = target.size == 3 && std::memcmp(target.begin, "xml", 3) == 0;
+        return is_declaration ? Other : ProcessingInstruction;
+    }
+    if (startsWith(markup, m_end, "/", 1)) {
+        m_pos = markup + 1;
+        return readEndTag();
+    }
+    m_pos = markup;
+    return readStartTag();
+}
+
+SvgReader::TokenType SvgTokenizer::readStartTag() {
+    if (!readName(m_name)) {
+        return fail("Expected element name.");
+    }
+    for (;;) {
+        skipSpaces();
+        if (m_pos >= m_end) {
+            return fail("Unterminated start tag.");
+        }
+        if (*m_pos == '>') {
+            ++m_pos;
+            break;
+        }
+        if (*m_pos == '/') {
+            if (m_pos + 1 < m_end && m_pos[1] == '>') {
+                m_pos += 2;
+                m_pendingEnd = true;
+                break;
+            }
+            return fail("Expected '>'.");
+        }
+        RawAttribute attr;
+        if (!readName(attr.name)) {
+            return fail("Expected attribute name.");
+        }
+        skipSpaces();
+        if (m_pos >= m_end || *m_pos != '=') {
+            return fail("Expected '='.");
+        }
+        ++m_pos;
+        skipSpaces();
+        if (m_pos >= m_end || (*m_pos != '"' && *m_pos != '\'')) {
+            return fail("Expected quoted attribute value.");
+        }
+        const char quote = *m_pos++;
+        const char *close = findChar(m_pos, m_end, quote);
+        if (close == nullptr) {
+            return fail("Unterminated attribute value.");
+        }
+        attr.value.begin = m_pos;
+        attr.value.size = static_cast<int>(close - m_pos);
+        m_pos = close + 1;
+        m_attributes.append(attr);
+    }
+    m_openElements.append(m_name);
+    return StartElement;
+}
+
+SvgReader::TokenType SvgTokenizer::readEndTag() {
+    Span name;
+    if (!readName(name)) {
+        return fail("Expected element name.");
+    }
+    skipSpaces();
+    if (m_pos >= m_end || *m_pos != '>') {
+        return fail("Expected '>'.");
+    }
+    ++m_pos;
+    if (m_openElements.isEmpty()) {
+        return fail("Unexpected end tag.");
+    }
+    const Span &open = m_openElements.last();
+    if (open.size != name.size
+        || std::memcmp(open.begin, name.begin, static_cast<size_t>(name.size)) != 0) {
+        return fail("Opening and ending tag mismatch.");
+    }
+    m_openElements.removeLast();
+    m_name = name;
+    return EndElement;
+}
+
+bool SvgTokenizer::readName(Span &name) {
+    name.begin = m_pos;
+    while (m_pos < m_end && isNameChar(*m_pos)) {
+        ++m_pos;
+    }
+    name.size = static_cast<int>(m_pos - name.begin);
+    return name.size > 0;
+}
+
+void SvgTokenizer::skipSpaces() {
+    while (m_pos < m_end && isSpace(*m_pos)) {
+        ++m_pos;
+    }
+}
+
+bool SvgTokenizer::skipPast(const char *terminator, int length) {
+    const char *pos = m_pos;
+    while ((pos = findChar(pos, m_end, terminator[0])) != nullptr) {
+        if (startsWith(pos, m_end, terminator, length)) {
+            m_pos = pos + length;
+            return true;
+        }
+        ++pos;
+    }
+    m_pos = m_end;
+    return false;
+}
+
+SvgReader::TokenType SvgTokenizer::fail(const char *message) {
+    m_error = QString::fromLatin1(message);
+    return m_token = Invalid;
+}
+
+bool SvgTokenizer::atEnd() const {
+    return m_token == EndDocument || m_token == Invalid;
+}
+
+bool SvgTokenizer::hasError() const {
+    return m_token == Invalid;
+}
+
+QString SvgTokenizer::errorString() const {
+    return m_error;
+}
+
+Atom SvgTokenizer::intern(const Span &span, AtomTable &names) {
+    for (int i = 0; i < span.size; ++i) {
+        if (static_cast<uchar>(span.begin[i]) >= 0x80) {
+            return names.intern(QString::fromUtf8(span.begin, span.size));
+        }
+    }
+    return names.intern(span.begin, span.size);
+}
+
+Atom SvgTokenizer::name(AtomTable &names) const {
+    return intern(m_name, names);
+}
+
+int SvgTokenizer::attributeCount() const {
+    return m_attributes.size();
+}
+
+Atom SvgTokenizer::attributeName(int index, AtomTable &names) const {
+    return intern(m_attributes.at(index).name, names);
+}
+
+QString SvgTokenizer::attributeValue(int index) const {
+    const Span &value = m_attributes.at(index).value;
+    return decodeSpan(value.begin, value.size, DecodeAttribute);
+}
+
+QString SvgTokenizer::text() const {
+    return decodeSpan(m_text.begin, m_text.size, m_textIsCData ? DecodeCData : DecodeText);
+}
+
+void SvgTokenizer::skipCurrentElement() {
+    int depth = 1;
+    while (depth > 0 && !atEnd()) {
+        switch (readNext()) {
+        case StartElement: ++depth; break;
+        case EndElement: --depth; break;
+        default: break;
+        }
+    }
+}
+
+} // namespace svgscene
@@ -0,0 +1,93 @@
+/**
+ * Specialized UTF-8 pull tokenizer for well-formed SVG.
+ *
+ * Supports exactly what the handler consumes: elements, attributes, text (with predefined and
+ * numeric character references), comments, CDATA sections and processing instructions. DTDs are
+ * skipped, custom entities and namespaces are not processed (same as QXmlStreamReader with
+ * namespace processing turned off). Scanning relies on `memchr`, which the C library implements
+ * with vector instructions.
+ *
+ * Names are interned without allocation. Attribute values and text are decoded straight from
+ * UTF-8, but always into owned strings: the tree builder reads every attribute of every element
+ * and stores the values in the tree, so none of them stays a view into the input.
+ *
+ * ## Differences from QXmlStreamReader
+ * Well-formed documents give the same tree with both readers (`svgscene_bench --check-readers`
+ * compares them on the samples). Some malformed input is accepted on purpose, where
+ * QXmlStreamReader reports an error and the parse ends at that point:
+ * - references to undefined entities (e.g. `&nbsp;`) and a bare `&` are kept as literal text,
+ * - duplicate attributes are not rejected, the last value is kept.
+ *
+ * @file
+ */
+#pragma once
+
+#include "svgreader.h"
+
+#include <QVarLengthArray>
+#include <QVector>
+
+namespace svgscene {
+
+class SvgTokenizer : public SvgReader {
+public:
+    /**
+     * @param begin   start of UTF-8 encoded document, must outlive the tokenizer
+     * @param end     end of the document
+     */
+    SvgTokenizer(const char *begin, const char *end);
+
+    /**
+     * Checks the XML declaration, only UTF-8 (and its ASCII subset) documents are supported.
+     */
+    static bool isSupportedEncoding(const char *begin, const char *end);
+
+    TokenType readNext() override;
+    bool atEnd() const override;
+    bool hasError() const override;
+    QString errorString() const override;
+    Atom name(AtomTable &names) const override;
+    int attributeCount() const override;
+    Atom attributeName(int index, AtomTable &names) const override;
+    QString attributeValue(int index) const override;
+    QString text() const override;
+    void skipCurrentElement() override;
+
+private:
+    /** View into the input. */
+    struct Span {
+        const char *begin = nullptr;
+        int size = 0;
+    };
+
+    struct RawAttribute {
+        Span name;
+        Span value;
+    };
+
+    TokenType readMarkup();
+    TokenType readStartTag();
+    TokenType readEndTag();
+    bool readName(Span &name);
+    void skipSpaces();
+    /** Moves behind the terminator, returns false, when not found. */
+    bool skipPast(const char *terminator, int length);
+    TokenType fail(const char *message);
+
+    static Atom intern(const Span &span, AtomTable &names);
+
+    const char *m_pos;
+    const char *m_end;
+    TokenType m_token = NoToken;
+    QString m_error;
+
+    Span m_name;
+    QVarLengthArray<RawAttribute, 16> m_attributes;
+    Span m_text;
+    bool m_textIsCData = false;
+    /** Self-closing element, the end element token is reported by the next read. */
+    bool m_pendingEnd = false;
+    QVector<Span> m_openElements;
+};
+
+} // namespace svgscene
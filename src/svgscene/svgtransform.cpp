@@ -0,0 +1,192 @@
+#include "svgtransform.h"
+
+#include "svgnumber.h"
+
+#include <QVarLengthArray>
+#include <QtMath>
+
+namespace svgscene {
+
+/** Transform functions with their accepted argument counts. */
+struct TransformFunction {
+    /** Index in `TRANSFORM_FUNCTIONS`. */
+    enum Index { Matrix, Translate, Scale, Rotate, SkewX, SkewY };
+
+    const char *name;
+    int minArguments;
+    int maxArguments;
+};
+
+static const TransformFunction TRANSFORM_FUNCTIONS[] = {
+    { "matrix", 6, 6 }, { "translate", 1, 2 }, { "scale", 1, 2 },
+    { "rotate", 1, 3 }, { "skewX", 1, 1 },     { "skewY", 1, 1 },
+};
+
+/**
+ * Reading position within the list. The string is terminated by the zero of QString, so looking
+ * at the current character is always safe.
+ */
+class TransformScanner {
+public:
+    explicit TransformScanner(const QString &value)
+        : m_begin(value.constData())
+        , m_pos(m_begin)
+        , m_end(m_begin + value.size()) {}
+
+    bool atEnd() const { return m_pos >= m_end; }
+    ushort current() const { return atEnd() ? 0 : m_pos->unicode(); }
+    int offset() const { return static_cast<int>(m_pos - m_begin); }
+
+    void skipSpaces() {
+        while (!atEnd() && isSpace(current())) {
+            ++m_pos;
+        }
+    }
+
+    /** Skips whitespace and at most one comma (`comma-wsp?`). */
+    void skipSeparator() {
+        skipSpaces();
+        if (current() == ',') {
+            ++m_pos;
+            skipSpaces();
+        }
+    }
+
+    /** Skips whitespace and any number of commas between transforms. */
+    void skipSeparators() {
+        while (!atEnd() && (isSpace(current()) || current() == ',')) {
+            ++m_pos;
+        }
+    }
+
+    /** Returns index of the function name at the position, or -1. */
+    int readFunction() {
+        const int count = sizeof(TRANSFORM_FUNCTIONS) / sizeof(TRANSFORM_FUNCTIONS[0]);
+        for (int i = 0; i < count; ++i) {
+            const char *name = TRANSFORM_FUNCTIONS[i].name;
+            int length = 0;
+            while (name[length] != '\0' && m_pos + length < m_end
+                   && m_pos[length].unicode() == static_cast<uchar>(name[length])) {
+                ++length;
+            }
+            if (name[length] == '\0') {
+                m_pos += length;
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    bool read(char c) {
+        if (current() != static_cast<uchar>(c)) {
+            return false;
+        }
+        ++m_pos;
+        return true;
+    }
+
+    /** Reads a number, fails when there are no digits. */
+    bool readNumber(qreal &value) {
+        const QChar *p = m_pos;
+        if (p->unicode() == '+' || p->unicode() == '-') {
+            ++p;
+        }
+        if (p->unicode() == '.') {
+            ++p;
+        }
+        if (atEnd() || !number::isDigit(p->unicode())) {
+            return false;
+        }
+        value = parseNumber(m_pos);
+        return true;
+    }
+
+    static bool startsNumber(ushort c) {
+        return number::isDigit(c) || c == '+' || c == '-' || c == '.';
+    }
+
+private:
+    static bool isSpace(ushort c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+    const QChar *m_begin;
+    const QChar *m_pos;
+    const QChar *m_end;
+};
+
+static bool fail(QString *error, const QString &message, const TransformScanner &scanner) {
+    if (error != nullptr) {
+        *error = QStringLiteral("%1 at offset %2").arg(message).arg(scanner.offset());
+    }
+    return false;
+}
+
+bool parseTransform(const QString &value, QTransform *transform, QString *error) {
+    TransformScanner scanner(value);
+    QTransform result;
+    scanner.skipSpaces();
+    while (!scanner.atEnd()) {
+        const int function = scanner.readFunction();
+        if (function < 0) {
+            return fail(error, QStringLiteral("Unknown transform function"), scanner);
+        }
+        const TransformFunction &spec = TRANSFORM_FUNCTIONS[function];
+        scanner.skipSpaces();
+        if (!scanner.read('(')) {
+            return fail(error, QStringLiteral("Expected '('"), scanner);
+        }
+        scanner.skipSpaces();
+        QVarLengthArray<qreal, 6> args;
+        while (TransformScanner::startsNumber(scanner.current())) {
+            if (args.size() == spec.maxArguments) {
+                return fail(error, QStringLiteral("Too many arguments"), scanner);
+            }
+            qreal arg;
+            if (!scanner.readNumber(arg)) {
+                return fail(error, QStringLiteral("Invalid number"), scanner);
+            }
+            args.append(arg);
+            scanner.skipSeparator();
+        }
+        if (!scanner.read(')')) {
+            return fail(error, QStringLiteral("Expected number or ')'"), scanner);
+        }
+        // Only `rotate` has an optional pair of arguments, other functions a single optional one.
+        if (args.size() < spec.minArguments
+            || (function == TransformFunction::Rotate && args.size() == 2)) {
+            return fail(
+                error,
+                QStringLiteral("Wrong number of arguments of %1").arg(QLatin1String(spec.name)),
+                scanner);
+        }
+
+        // Each function applies before the ones to its left, QTransform methods prepend.
+        switch (function) {
+        case TransformFunction::Matrix:
+            result = QTransform(args[0], args[1], args[2], args[3], args[4], args[5]) * result;
+            break;
+        case TransformFunction::Translate:
+            result.translate(args[0], args.size() == 2 ? args[1] : 0);
+            break;
+        case TransformFunction::Scale:
+            result.scale(args[0], args.size() == 2 ? args[1] : args[0]);
+            break;
+        case TransformFunction::Rotate:
+            if (args.size() == 3) {
+                result.translate(args[1], args[2]);
+                result.rotate(args[0]);
+                result.translate(-args[1], -args[2]);
+            } else {
+                result.rotate(args[0]);
+            }
+            break;
+        case TransformFunction::SkewX: result.shear(qTan(qDegreesToRadians(args[0])), 0); break;
+        case TransformFunction::SkewY: result.shear(0, qTan(qDegreesToRadians(args[0]))); break;
+        default: break;
+        }
+        scanner.skipSeparators();
+    }
+    *transform = result;
+    return true;
+}
+
+} // namespace svgscene
@@ -0,0 +1,29 @@
+/**
+ * Parser of the `transform` attribute.
+ *
+ * Implements the transform list grammar of SVG 1.1 (`matrix`, `translate`, `scale`,
+ * `rotate(a [cx cy])`, `skewX`, `skewY`, separated by whitespace and commas) and builds the
+ * `QTransform` directly. Like in path data, a sign may separate two numbers without a comma.
+ * Malformed lists are rejected as a whole: browsers ignore the attribute in that case, applying
+ * the transforms up to the error would place the element somewhere else.
+ *
+ * https://www.w3.org/TR/SVG11/coords.html#TransformAttribute
+ *
+ * @file
+ */
+#pragma once
+
+#include <QString>
+#include <QTransform>
+
+namespace svgscene {
+
+/**
+ * Parses a transform list. On success the result is written to `transform`. On failure it is
+ * left untouched and `error` (when given) describes the problem and its position.
+ *
+ * An empty list (or whitespace only) is valid and yields the identity.
+ */
+bool parseTransform(const QString &value, QTransform *transform, QString *error = nullptr);
+
+} // namespace svgscene
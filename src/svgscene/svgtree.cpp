@@ -0,0 +1,1468 @@
+#include "svgtree.h"
+
+#include "svgarena.h"
+#include "svgcompiled.h"
+#include "svgkeywords.h"
+#include "svgnumber.h"
+#include "svgtokenizer.h"
+#include "svgtransform.h"
+#include "utils/logging.h"
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+#include <QXmlStreamReader>
+#include <QtMath>
+#include <utility>
+
+LOG_CATEGORY("svgscene.parsing");
+
+namespace svgscene {
+
+// see: https://www.w3.org/TR/SVG11/
+
+// '0' is 0x30 and '9' is 0x39
+static inline bool isDigit(ushort ch) {
+    static quint16 magic = 0x3ff;
+    return ((ch >> 4) == 3) && (magic >> (ch & 15));
+}
+
+static qreal toDouble(const QChar *&str) {
+    return parseNumber(str);
+}
+
+static qreal toDouble(const QString &str, bool *ok = nullptr) {
+    const QChar *c = str.constData();
+    qreal res = toDouble(c);
+    if (ok) {
+        *ok = ((*c) == QLatin1Char('\0'));
+    }
+    return res;
+}
+
+/*
+static qreal toDouble(const QStringRef &str, bool *ok = nullptr)
+{
+    const QChar *c = str.constData();
+    qreal res = toDouble(c);
+    if (ok) {
+        *ok = (c == (str.constData() + str.length()));
+    }
+    return res;
+}
+*/
+template<typename Array>
+static inline void parseNumbersArray(const QChar *&str, Array &points) {
+    while (str->isSpace())
+        ++str;
+    while (isDigit(str->unicode()) || *str == QLatin1Char('-') || *str == QLatin1Char('+')
+           || *str == QLatin1Char('.')) {
+        points.append(toDouble(str));
+        while (str->isSpace())
+            ++str;
+        if (*str == QLatin1Char(','))
+            ++str;
+        // eat the rest of space
+        while (str->isSpace())
+            ++str;
+    }
+}
+
+static void parsePercentageList(const QChar *&str, ArenaArray<qreal> &points) {
+    while (str->isSpace())
+        ++str;
+    while ((*str >= QLatin1Char('0') && *str <= QLatin1Char('9')) || *str == QLatin1Char('-')
+           || *str == QLatin1Char('+') || *str == QLatin1Char('.')) {
+        points.append(toDouble(str));
+        while (str->isSpace())
+            ++str;
+        if (*str == QLatin1Char('%'))
+            ++str;
+        while (str->isSpace())
+            ++str;
+        if (*str == QLatin1Char(','))
+            ++str;
+        // eat the rest of space
+        while (str->isSpace())
+            ++str;
+    }
+}
+
+static inline int qsvg_h2i(char hex) {
+    if (hex >= '0' && hex <= '9')
+        return hex - '0';
+    if (hex >= 'a' && hex <= 'f')
+        return hex - 'a' + 10;
+    if (hex >= 'A' && hex <= 'F')
+        return hex - 'A' + 10;
+    return -1;
+}
+static inline int qsvg_hex2int(const char *s) {
+    return (qsvg_h2i(s[0]) << 4) | qsvg_h2i(s[1]);
+}
+static inline int qsvg_hex2int(char s) {
+    int h = qsvg_h2i(s);
+    return (h << 4) | h;
+}
+
+bool qsvg_get_hex_rgb(const char *name, QRgb *rgb) {
+    if (name[0] != '#')
+        return false;
+    name++;
+    int len = static_cast<int>(qstrlen(name));
+    int r, g, b;
+    if (len == 12) {
+        r = qsvg_hex2int(name);
+        g = qsvg_hex2int(name + 4);
+        b = qsvg_hex2int(name + 8);
+    } else if (len == 9) {
+        r = qsvg_hex2int(name);
+        g = qsvg_hex2int(name + 3);
+        b = qsvg_hex2int(name + 6);
+    } else if (len == 6) {
+        r = qsvg_hex2int(name);
+        g = qsvg_hex2int(name + 2);
+        b = qsvg_hex2int(name + 4);
+    } else if (len == 3) {
+        r = qsvg_hex2int(name[0]);
+        g = qsvg_hex2int(name[1]);
+        b = qsvg_hex2int(name[2]);
+    } else {
+        r = g = b = -1;
+    }
+    if ((uint)r > 255 || (uint)g > 255 || (uint)b > 255) {
+        *rgb = 0;
+        return false;
+    }
+    *rgb = qRgb(r, g, b);
+    return true;
+}
+
+bool qsvg_get_hex_rgb(const QChar *str, int len, QRgb *rgb) {
+    if (len > 13)
+        return false;
+    char tmp[16];
+    for (int i = 0; i < len; ++i)
+        tmp[i] = str[i].toLatin1();
+    tmp[len] = 0;
+    return qsvg_get_hex_rgb(tmp, rgb);
+}
+
+/** Component lists of `rgb()` are temporaries of `arena`. */
+static QColor parseColor(const QString &color, Arena &arena) {
+    QColor ret;
+    {
+        QStringRef color_str = QStringRef(&color).trimmed();
+        if (color_str.isEmpty())
+            return ret;
+        switch (color_str.at(0).unicode()) {
+        case '#': {
+            // #rrggbb is very very common, so let's tackle it here
+            // rather than falling back to QColor
+            QRgb rgb;
+            bool ok = qsvg_get_hex_rgb(color_str.unicode(), color_str.length(), &rgb);
+            if (ok)
+                ret.setRgb(rgb);
+            break;
+        }
+        case 'r':
+            // starts with "rgb(", ends with ")" and consists of at least 7
+            // characters "rgb(,,)"
+            if (color_str.length() >= 7 && color_str.at(color_str.length() - 1) == QLatin1Char(')')
+                && QStringRef(color_str.string(), color_str.position(), 4)
+                       == QLatin1String("rgb(")) {
+                ArenaScope scope(arena);
+                ArenaArray<qreal> compo(arena, 4);
+                const QChar *s = color_str.constData() + 4;
+                parseNumbersArray(s, compo);
+                // 1 means that it failed after reaching non-parsable
+                // character which is going to be "%"
+                if (compo.size() == 1) {
+                    s = color_str.constData() + 4;
+                    compo.clear();
+                    parsePercentageList(s, compo);
+                    for (qreal &i : compo)
+                        i *= (qreal)2.55;
+                }
+                if (compo.size() == 3) {
+                    ret = QColor(int(compo[0]), int(compo[1]), int(compo[2]));
+                }
+                break;
+            }
+            // Named color (red, rosybrown, royalblue).
+            Q_FALLTHROUGH();
+        default: {
+            // `currentColor` and `inherit` are not named colors, the result is invalid for them.
+            QRgb rgb;
+            if (findNamedColor(color_str.constData(), color_str.length(), &rgb))
+                ret = QColor::fromRgba(rgb);
+            break;
+        }
+        }
+    }
+    return ret;
+}
+
+static qreal parseOpacity(const QString &opacity) {
+    bool ok = true;
+    qreal op = qMin(qreal(1.0), qMax(qreal(0.0), toDouble(opacity, &ok)));
+    if (!ok)
+        op = 1.0;
+    return op;
+}
+
+/** Lengths separated by commas and/or whitespace, scanned in place. */
+static QVector<qreal> parseDashArray(const QString &dash_pattern) {
+    QVector<qreal> arr;
+    if (dash_pattern.isEmpty() || dash_pattern == QLatin1String("none")) {
+        return arr;
+    }
+    const QChar *str = dash_pattern.constData();
+    parseNumbersArray(str, arr);
+    if (*str != QLatin1Char('\0')) {
+        LOG() << "Invalid stroke dash definition:" << dash_pattern;
+        arr.clear();
+    }
+    return arr;
+}
+
+// the arc handling code underneath is from XSVG (BSD license)
+/*
+ * Copyright  2002 USC/Information Sciences Institute
+ *
+ * Permission to use, copy, modify, distribute, and sell this software
+ * and its documentation for any purpose is hereby granted without
+ * fee, provided that the above copyright notice appear in all copies
+ * and that both that copyright notice and this permission notice
+ * appear in supporting documentation, and that the name of
+ * Information Sciences Institute not be used in advertising or
+ * publicity pertaining to distribution of the software without
+ * specific, written prior permission.  Information Sciences Institute
+ * makes no representations about the suitability of this software for
+ * any purpose.  It is provided "as is" without express or implied
+ * warranty.
+ *
+ * INFORMATION SCIENCES INSTITUTE DISCLAIMS ALL WARRANTIES WITH REGARD
+ * TO THIS SOFTWARE, INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS, IN NO EVENT SHALL INFORMATION SCIENCES
+ * INSTITUTE BE LIABLE FOR ANY SPECIAL, INDIRECT OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA
+ * OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+static void pathArcSegment(
+    QPainterPath &path,
+    qreal xc,
+    qreal yc,
+    qreal th0,
+    qreal th1,
+    qreal rx,
+    qreal ry,
+    qreal xAxisRotation) {
+    qreal sinTh, cosTh;
+    qreal a00, a01, a10, a11;
+    qreal x1, y1, x2, y2, x3, y3;
+    qreal t;
+    qreal thHalf;
+    sinTh = qSin(xAxisRotation * (M_PI / 180.0));
+    cosTh = qCos(xAxisRotation * (M_PI / 180.0));
+    a00 = cosTh * rx;
+    a01 = -sinTh * ry;
+    a10 = sinTh * rx;
+    a11 = cosTh * ry;
+    thHalf = 0.5 * (th1 - th0);
+    t = (8.0 / 3.0) * qSin(thHalf * 0.5) * qSin(thHalf * 0.5) / qSin(thHalf);
+    x1 = xc + qCos(th0) - t * qSin(th0);
+    y1 = yc + qSin(th0) + t * qCos(th0);
+    x3 = xc + qCos(th1);
+    y3 = yc + qSin(th1);
+    x2 = x3 + t * qSin(th1);
+    y2 = y3 - t * qCos(th1);
+    path.cubicTo(
+        a00 * x1 + a01 * y1, a10 * x1 + a11 * y1, a00 * x2 + a01 * y2, a10 * x2 + a11 * y2,
+        a00 * x3 + a01 * y3, a10 * x3 + a11 * y3);
+}
+
+static void pathArc(
+    QPainterPath &path,
+    qreal rx,
+    qreal ry,
+    qreal x_axis_rotation,
+    int large_arc_flag,
+    int sweep_flag,
+    qreal x,
+    qreal y,
+    qreal curx,
+    qreal cury) {
+    qreal sin_th, cos_th;
+    qreal a00, a01, a10, a11;
+    qreal x0, y0, x1, y1, xc, yc;
+    qreal d, sfactor, sfactor_sq;
+    qreal th0, th1, th_arc;
+    int i, n_segs;
+    qreal dx, dy, dx1, dy1, Pr1, Pr2, Px, Py, check;
+    rx = qAbs(rx);
+    ry = qAbs(ry);
+    sin_th = qSin(x_axis_rotation * (M_PI / 180.0));
+    cos_th = qCos(x_axis_rotation * (M_PI / 180.0));
+    dx = (curx - x) / 2.0;
+    dy = (cury - y) / 2.0;
+    dx1 = cos_th * dx + sin_th * dy;
+    dy1 = -sin_th * dx + cos_th * dy;
+    Pr1 = rx * rx;
+    Pr2 = ry * ry;
+    Px = dx1 * dx1;
+    Py = dy1 * dy1;
+    /* Spec : check if radii are large enough */
+    check = Px / Pr1 + Py / Pr2;
+    if (check > 1) {
+        rx = rx * qSqrt(check);
+        ry = ry * qSqrt(check);
+    }
+    a00 = cos_th / rx;
+    a01 = sin_th / rx;
+    a10 = -sin_th / ry;
+    a11 = cos_th / ry;
+    x0 = a00 * curx + a01 * cury;
+    y0 = a10 * curx + a11 * cury;
+    x1 = a00 * x + a01 * y;
+    y1 = a10 * x + a11 * y;
+    /* (x0, y0) is current point in transformed coordinate space.
+       (x1, y1) is new point in transformed coordinate space.
+       The arc fits a unit-radius circle in this space.
+    */
+    d = (x1 - x0) * (x1 - x0) + (y1 - y0) * (y1 - y0);
+    sfactor_sq = 1.0 / d - 0.25;
+    if (sfactor_sq < 0)
+        sfactor_sq = 0;
+    sfactor = qSqrt(sfactor_sq);
+    if (sweep_flag == large_arc_flag)
+        sfactor = -sfactor;
+    xc = 0.5 * (x0 + x1) - sfactor * (y1 - y0);
+    yc = 0.5 * (y0 + y1) + sfactor * (x1 - x0);
+    /* (xc, yc) is center of the circle. */
+    th0 = qAtan2(y0 - yc, x0 - xc);
+    th1 = qAtan2(y1 - yc, x1 - xc);
+    th_arc = th1 - th0;
+    if (th_arc < 0 && sweep_flag)
+        th_arc += 2 * M_PI;
+    else if (th_arc > 0 && !sweep_flag)
+        th_arc -= 2 * M_PI;
+    n_segs = qCeil(qAbs(th_arc / (M_PI * 0.5 + 0.001)));
+    for (i = 0; i < n_segs; i++) {
+        pathArcSegment(
+            path, xc, yc, th0 + i * th_arc / n_segs, th0 + (i + 1) * th_arc / n_segs, rx, ry,
+            x_axis_rotation);
+    }
+}
+
+/**
+ * Numbers of the commands are temporaries of `arena`, it is rewound on return. The data is a whole
+ * QString, its terminating zero stops `parseNumbersArray` at the end.
+ */
+static bool parsePathDataFast(const QString &dataStr, QPainterPath &path, Arena &arena) {
+    qreal x0 = 0, y0 = 0; // starting point
+    qreal x = 0, y = 0;   // current point
+    char lastMode = 0;
+    QPointF ctrlPt;
+    ArenaScope scope(arena);
+    // Reused by all commands, a long polyline grows it once instead of spilling to the heap.
+    ArenaArray<qreal> arg(arena, 64);
+    const QChar *str = dataStr.constData();
+    const QChar *end = str + dataStr.size();
+    while (str != end) {
+        while (str->isSpace())
+            ++str;
+        if (str == end)
+            break;
+        QChar pathElem = *str;
+        ++str;
+        arg.clear();
+        parseNumbersArray(str, arg);
+        if (pathElem == QLatin1Char('z') || pathElem == QLatin1Char('Z'))
+            arg.append(0); // dummy
+        const qreal *num = arg.constData();
+        int count = arg.count();
+        while (count > 0) {
+            qreal offsetX = x; // correction offsets
+            qreal offsetY = y; // for relative commands
+            switch (pathElem.unicode()) {
+            case 'm': {
+                if (count < 2) {
+                    num++;
+                    count--;
+                    break;
+                }
+                x = x0 = num[0] + offsetX;
+                y = y0 = num[1] + offsetY;
+                num += 2;
+                count -= 2;
+                path.moveTo(x0, y0);
+                // As per 1.2  spec 8.3.2 The "moveto" commands
+                // If a 'moveto' is followed by multiple pairs of coordinates
+                // without explicit commands, the subsequent pairs shall be
+                // treated as implicit 'lineto' commands.
+                pathElem = QLatin1Char('l');
+            } break;
+            case 'M': {
+                if (count < 2) {
+                    num++;
+                    count--;
+                    break;
+                }
+                x = x0 = num[0];
+                y = y0 = num[1];
+                num += 2;
+                count -= 2;
+                path.moveTo(x0, y0);
+                // As per 1.2  spec 8.3.2 The "moveto" commands
+                // If a 'moveto' is followed by multiple pairs of coordinates
+                // without explicit commands, the subsequent pairs shall be
+                // treated as implicit 'lineto' commands.
+                pathElem = QLatin1Char('L');
+            } break;
+            case 'z':
+            case 'Z': {
+                x = x0;
+                y = y0;
+                count--; // skip dummy
+                num++;
+                path.closeSubpath();
+            } break;
+            case 'l': {
+                if (count < 2) {
+                    num++;
+                    count--;
+                    break;
+                }
+                x = num[0] + offsetX;
+                y = num[1] + offsetY;
+                num += 2;
+                count -= 2;
+                path.lineTo(x, y);
+            } break;
+            case 'L': {
+                if (count < 2) {
+                    num++;
+                    count--;
+                    break;
+                }
+                x = num[0];
+                y = num[1];
+                num += 2;
+                count -= 2;
+                path.lineTo(x, y);
+            } break;
+            case 'h': {
+                x = num[0] + offsetX;
+                num++;
+                count--;
+                path.lineTo(x, y);
+            } break;
+            case 'H': {
+                x = num[0];
+                num++;
+                count--;
+                path.lineTo(x, y);
+            } break;
+            case 'v': {
+                y = num[0] + offsetY;
+                num++;
+                count--;
+                path.lineTo(x, y);
+            } break;
+            case 'V': {
+                y = num[0];
+                num++;
+                count--;
+                path.lineTo(x, y);
+            } break;
+            case 'c': {
+                if (count < 6) {
+                    num += count;
+                    count = 0;
+                    break;
+                }
+                QPointF c1(num[0] + offsetX, num[1] + offsetY);
+                QPointF c2(num[2] + offsetX, num[3] + offsetY);
+                QPointF e(num[4] + offsetX, num[5] + offsetY);
+                num += 6;
+                count -= 6;
+                path.cubicTo(c1, c2, e);
+                ctrlPt = c2;
+                x = e.x();
+                y = e.y();
+                break;
+            }
+            case 'C': {
+                if (count < 6) {
+                    num += count;
+                    count = 0;
+                    break;
+                }
+                QPointF c1(num[0], num[1]);
+                QPointF c2(num[2], num[3]);
+                QPointF e(num[4], num[5]);
+                num += 6;
+                count -= 6;
+                path.cubicTo(c1, c2, e);
+                ctrlPt = c2;
+                x = e.x();
+                y = e.y();
+                break;
+            }
+            case 's': {
+                if (count < 4) {
+                    num += count;
+                    count = 0;
+                    break;
+                }
+                QPointF c1;
+                if (lastMode == 'c' || lastMode == 'C' || lastMode == 's' || lastMode == 'S')
+                    c1 = QPointF(2 * x - ctrlPt.x(), 2 * y - ctrlPt.y());
+                else
+                    c1 = QPointF(x, y);
+                QPointF c2(num[0] + offsetX, num[1] + offsetY);
+                QPointF e(num[2] + offsetX, num[3] + offsetY);
+                num += 4;
+                count -= 4;
+                path.cubicTo(c1, c2, e);
+                ctrlPt = c2;
+                x = e.x();
+                y = e.y();
+                break;
+            }
+            case 'S': {
+                if (count < 4) {
+                    num += count;
+                    count = 0;
+                    break;
+                }
+                QPointF c1;
+                if (lastMode == 'c' || lastMode == 'C' || lastMode == 's' || lastMode == 'S')
+                    c1 = QPointF(2 * x - ctrlPt.x(), 2 * y - ctrlPt.y());
+                else
+                    c1 = QPointF(x, y);
+                QPointF c2(num[0], num[1]);
+                QPointF e(num[2], num[3]);
+                num += 4;
+                count -= 4;
+                path.cubicTo(c1, c2, e);
+                ctrlPt = c2;
+                x = e.x();
+                y = e.y();
+                break;
+            }
+            case 'q': {
+                if (count < 4) {
+                    num += count;
+                    count = 0;
+                    break;
+                }
+                QPointF c(num[0] + offsetX, num[1] + offsetY);
+                QPointF e(num[2] + offsetX, num[3] + offsetY);
+                num += 4;
+                count -= 4;
+                path.quadTo(c, e);
+                ctrlPt = c;
+                x = e.x();
+                y = e.y();
+                break;
+            }
+            case 'Q': {
+                if (count < 4) {
+                    num += count;
+                    count = 0;
+                    break;
+                }
+                QPointF c(num[0], num[1]);
+                QPointF e(num[2], num[3]);
+                num += 4;
+                count -= 4;
+                path.quadTo(c, e);
+                ctrlPt = c;
+                x = e.x();
+                y = e.y();
+                break;
+            }
+            case 't': {
+                if (count < 2) {
+                    num += count;
+                    count = 0;
+                    break;
+                }
+                QPointF e(num[0] + offsetX, num[1] + offsetY);
+                num += 2;
+                count -= 2;
+                QPointF c;
+                if (lastMode == 'q' || lastMode == 'Q' || lastMode == 't' || lastMode == 'T')
+                    c = QPointF(2 * x - ctrlPt.x(), 2 * y - ctrlPt.y());
+                else
+                    c = QPointF(x, y);
+                path.quadTo(c, e);
+                ctrlPt = c;
+                x = e.x();
+                y = e.y();
+                break;
+            }
+            case 'T': {
+                if (count < 2) {
+                    num += count;
+                    count = 0;
+                    break;
+                }
+                QPointF e(num[0], num[1]);
+                num += 2;
+                count -= 2;
+                QPointF c;
+                if (lastMode == 'q' || lastMode == 'Q' || lastMode == 't' || lastMode == 'T')
+                    c = QPointF(2 * x - ctrlPt.x(), 2 * y - ctrlPt.y());
+                else
+                    c = QPointF(x, y);
+                path.quadTo(c, e);
+                ctrlPt = c;
+                x = e.x();
+                y = e.y();
+                break;
+            }
+            case 'a': {
+                if (count < 7) {
+                    num += count;
+                    count = 0;
+                    break;
+                }
+                qreal rx = (*num++);
+                qreal ry = (*num++);
+                qreal xAxisRotation = (*num++);
+                qreal largeArcFlag = (*num++);
+                qreal sweepFlag = (*num++);
+                qreal ex = (*num++) + offsetX;
+                qreal ey = (*num++) + offsetY;
+                count -= 7;
+                qreal curx = x;
+                qreal cury = y;
+                pathArc(
+                    path, rx, ry, xAxisRotation, int(largeArcFlag), int(sweepFlag), ex, ey, curx,
+                    cury);
+                x = ex;
+                y = ey;
+            } break;
+            case 'A': {
+                if (count < 7) {
+                    num += count;
+                    count = 0;
+                    break;
+                }
+                qreal rx = (*num++);
+                qreal ry = (*num++);
+                qreal xAxisRotation = (*num++);
+                qreal largeArcFlag = (*num++);
+                qreal sweepFlag = (*num++);
+                qreal ex = (*num++);
+                qreal ey = (*num++);
+                count -= 7;
+                qreal curx = x;
+                qreal cury = y;
+                pathArc(
+                    path, rx, ry, xAxisRotation, int(largeArcFlag), int(sweepFlag), ex, ey, curx,
+                    cury);
+                x = ex;
+                y = ey;
+            } break;
+            default: return false;
+            }
+            lastMode = pathElem.toLatin1();
+        }
+    }
+    return true;
+}
+
+
+static SvgNodeKind kindOf(const QString &name) {
+    if (name == QLatin1String("svg"))
+        return SvgNodeKind::Svg;
+    if (name == QLatin1String("defs"))
+        return SvgNodeKind::Defs;
+    if (name == QLatin1String("g"))
+        return SvgNodeKind::Group;
+    if (name == QLatin1String("a"))
+        return SvgNodeKind::Hyperlink;
+    if (name == QLatin1String("rect"))
+        return SvgNodeKind::Rect;
+    if (name == QLatin1String("circle"))
+        return SvgNodeKind::Circle;
+    if (name == QLatin1String("ellipse"))
+        return SvgNodeKind::Ellipse;
+    if (name == QLatin1String("path"))
+        return SvgNodeKind::Path;
+    if (name == QLatin1String("text"))
+        return SvgNodeKind::TextElement;
+    if (name == QLatin1String("tspan"))
+        return SvgNodeKind::Tspan;
+    if (name == QLatin1String("flowRoot"))
+        return SvgNodeKind::FlowRoot;
+    return SvgNodeKind::Unknown;
+}
+
+/** Smaller documents are decoded on the calling thread, starting threads would cost more. */
+static const int MIN_PARALLEL_ELEMENTS = 512;
+
+/** Tokens read between polls of `ParseOptions::isCanceled`. */
+static const int CANCEL_CHECK_TOKENS = 4096;
+
+/** Distinct path data to be decoded into a slot of the tree. */
+struct PathJob {
+    int node;
+    int slot;
+};
+
+/** Distinct transform list (trimmed) to be parsed into a slot of the tree. */
+struct TransformJob {
+    QString value;
+    int slot;
+};
+
+/** Elements whose character data end up in a text item. */
+static bool isTextContainer(SvgNodeKind kind) {
+    return kind == SvgNodeKind::TextElement || kind == SvgNodeKind::Tspan
+           || kind == SvgNodeKind::FlowRoot;
+}
+
+/** Elements whose item gets the `transform` attribute applied. */
+static bool isTransformable(SvgNodeKind kind) {
+    switch (kind) {
+    case SvgNodeKind::Text:
+    case SvgNodeKind::Unknown:
+    case SvgNodeKind::Svg:
+    case SvgNodeKind::Defs: return false;
+    default: return true;
+    }
+}
+
+SvgTree::SvgTree() : m_atoms(new AtomTable()) {}
+
+const QVector<SvgNode> &SvgTree::nodes() const {
+    return m_nodes;
+}
+
+bool SvgTree::isEmpty() const {
+    return m_nodes.isEmpty();
+}
+
+QSharedPointer<const AtomTable> SvgTree::atoms() const {
+    return m_atoms;
+}
+
+QPainterPath SvgTree::path(const SvgNode &node) const {
+    return (node.path < 0) ? QPainterPath() : m_paths.at(node.path);
+}
+
+QTransform SvgTree::transform(const SvgNode &node) const {
+    return (node.transform < 0) ? QTransform() : m_transforms.at(node.transform);
+}
+
+bool SvgTree::hasTransform(const SvgNode &node) const {
+    return node.transform >= 0;
+}
+
+QString SvgTree::text(const SvgNode &node) const {
+    return (node.text < 0) ? QString() : m_texts.at(node.text);
+}
+
+const ParseStats &SvgTree::stats() const {
+    return m_stats;
+}
+
+SvgTreeBuilder::SvgTreeBuilder(bool skip_definitions)
+    : m_skipDefinitions(skip_definitions)
+    , m_initialStyle(initialStyle()) {}
+
+ComputedStyle SvgTreeBuilder::initialStyle() {
+    ComputedStyle style;
+    // TODO Choose some reasonable set.
+    ComputedStyleData &d = style.edit();
+    d.declared.insert(atoms::StrokeWidth, QStringLiteral("1"));
+    d.strokeWidth = 1;
+    return style;
+}
+
+void SvgTreeBuilder::read(SvgReader *reader) {
+    if (!m_options.isCanceled) {
+        while (!reader->atEnd()) {
+            readToken(reader);
+        }
+        return;
+    }
+    while (readSome(reader, CANCEL_CHECK_TOKENS)) {
+        if (m_options.isCanceled()) {
+            DEBUG() << "parse canceled";
+            return;
+        }
+    }
+}
+
+bool SvgTreeBuilder::readSome(SvgReader *reader, int max_tokens) {
+    for (int i = 0; i < max_tokens && !reader->atEnd(); ++i) {
+        readToken(reader);
+    }
+    return !reader->atEnd();
+}
+
+void SvgTreeBuilder::readToken(SvgReader *reader) {
+    SvgReader::TokenType token;
+    {
+        PhaseTimer timer(profile(), ParsePhase::Tokenize);
+        token = reader->readNext();
+    }
+    switch (token) {
+    case SvgReader::StartElement: startElement(reader); break;
+    case SvgReader::EndElement: endElement(); break;
+    case SvgReader::Characters: characters(reader->text()); break;
+    case SvgReader::ProcessingInstruction:
+        DEBUG() << "ProcessingInstruction";
+        // processingInstruction(xml->processingInstructionTarget().toString(),
+        // xml->processingInstructionData().toString());
+        break;
+    default: break;
+    }
+}
+
+void SvgTreeBuilder::decodePending() {
+    decodeGeometry();
+}
+
+const SvgTree &SvgTreeBuilder::tree() const {
+    return m_tree;
+}
+
+SvgTree SvgTreeBuilder::take() {
+    QVector<SvgNode> &nodes = m_tree.m_nodes;
+    for (int index : m_open) {
+        nodes[index].end = nodes.size();
+    }
+    m_open.clear();
+    m_textDepth = 0;
+    // The tree of a canceled parse is thrown away, its geometry is not needed.
+    if (!m_options.isCanceled || !m_options.isCanceled()) {
+        decodeGeometry();
+    }
+    m_decoded = 0;
+    m_knownPaths.clear();
+    m_knownTransforms.clear();
+    m_tree.m_stats.arenaAllocations += m_arena.allocations();
+    m_tree.m_stats.arenaBlocks += m_arena.blocks();
+    m_arena.release();
+    SvgTree tree = std::move(m_tree);
+    m_tree = SvgTree();
+    m_tree.m_stats.profiled = m_options.profile;
+    return tree;
+}
+
+void SvgTreeBuilder::setOptions(const ParseOptions &options) {
+    m_options = options;
+    m_tree.m_stats.profiled = options.profile;
+}
+
+ParseProfile *SvgTreeBuilder::profile() {
+    return m_options.profile ? &m_tree.m_stats.profile : nullptr;
+}
+
+void SvgTreeBuilder::startElement(SvgReader *reader) {
+    QVector<SvgNode> &nodes = m_tree.m_nodes;
+    SvgNode node;
+    node.name = reader->name(*m_tree.m_atoms);
+    node.kind = kindOf(m_tree.m_atoms->name(node.name));
+    node.parent = m_open.isEmpty() ? -1 : m_open.last();
+    node.style = (node.parent < 0) ? m_initialStyle : nodes.at(node.parent).style;
+    ParseProfile *profile = this->profile();
+    QElapsedTimer timer;
+    if (profile != nullptr) {
+        timer.start();
+    }
+    if (node.kind == SvgNodeKind::Defs && m_skipDefinitions) {
+        // The end tag is consumed too, so the element stays open until its parent ends. Kept as
+        // it always was, later siblings inherit its style.
+        reader->skipCurrentElement();
+    } else {
+        node.attributes = parseXmlAttributes(reader, node.style);
+    }
+    DEBUG() << QString(m_open.size() + 1, '-') << ">"
+            << "+ start element:" << m_tree.m_atoms->name(node.name)
+            << "id:" << node.attributes.value(atoms::Id);
+    mergeCSSAttributes(node.style, atoms::Style, node.attributes);
+    if (node.kind == SvgNodeKind::Group || node.kind == SvgNodeKind::Hyperlink) {
+        node.ownStyle = presentationStyle(node.attributes);
+    }
+    if (profile != nullptr) {
+        const quint64 ns = quint64(timer.nsecsElapsed());
+        PhaseStats &phase = profile->phase(ParsePhase::Attributes);
+        ++phase.count;
+        phase.nanoseconds += ns;
+        ElementStats &element = profile->elements[m_tree.m_atoms->name(node.name)];
+        ++element.count;
+        element.nanoseconds += ns;
+        for (const Attribute &attr : node.attributes) {
+            element.attributeBytes += quint64(attr.value.size()) * sizeof(QChar);
+        }
+    }
+    if (isTextContainer(node.kind)) {
+        ++m_textDepth;
+    }
+    m_open.append(nodes.size());
+    nodes.append(node);
+}
+
+void SvgTreeBuilder::endElement() {
+    if (m_open.isEmpty()) {
+        WARN() << "end element without start element";
+        return;
+    }
+    SvgNode &node = m_tree.m_nodes[m_open.takeLast()];
+    node.closed = true;
+    node.end = m_tree.m_nodes.size();
+    if (isTextContainer(node.kind)) {
+        --m_textDepth;
+    }
+}
+
+void SvgTreeBuilder::characters(const QString &text) {
+    DEBUG() << "characters element:" << text;
+    if (m_textDepth == 0) {
+        // Only text items consume characters, this drops mostly the indentation.
+        DEBUG() << "characters are not part of text element, will be ignored";
+        return;
+    }
+    SvgNode node;
+    node.kind = SvgNodeKind::Text;
+    node.parent = m_open.last();
+    node.end = m_tree.m_nodes.size() + 1;
+    node.text = m_tree.m_texts.size();
+    m_tree.m_texts.append(text);
+    m_tree.m_nodes.append(node);
+}
+
+AttributeList SvgTreeBuilder::parseXmlAttributes(SvgReader *reader, ComputedStyle &style) {
+    AttributeList xml;
+    const int count = reader->attributeCount();
+    for (int i = 0; i < count; ++i) {
+        const Atom name = reader->attributeName(i, *m_tree.m_atoms);
+        const QString value = reader->attributeValue(i);
+        xml.insert(name, value);
+
+        /*
+         * """
+         * The presentation attributes thus will participate in the CSS2 cascade
+         * as if they were replaced by corresponding CSS style rules placed at
+         * the start of the author style sheet with a specificity of zero. In
+         * general, this means that the presentation attributes have lower
+         * priority than other CSS style rules specified in author style sheets
+         * or ‘style’ attributes.
+         * """
+         * https://www.w3.org/TR/SVG/styling.html#UsingPresentationAttributes
+         */
+        if (AtomTable::isPresentation(name)) {
+            setStyleProperty(style, name, value);
+        }
+    }
+    return xml;
+}
+
+void SvgTreeBuilder::mergeCSSAttributes(
+    ComputedStyle &style,
+    Atom attr_name,
+    const AttributeList &xml_attributes) {
+    const QString *css = xml_attributes.find(attr_name);
+    if (css == nullptr) {
+        return;
+    }
+    // Declarations are scanned in place, only the property values are copied.
+    int begin = 0;
+    while (begin < css->size()) {
+        int end = css->indexOf(QLatin1Char(';'), begin);
+        if (end < 0) {
+            end = css->size();
+        }
+        const QStringRef declaration = css->midRef(begin, end - begin);
+        const int ix = declaration.indexOf(QLatin1Char(':'));
+        if (ix > 0) {
+            const Atom name = m_tree.m_atoms->intern(declaration.left(ix).trimmed());
+            setStyleProperty(style, name, declaration.mid(ix + 1).trimmed().toString());
+        }
+        begin = end + 1;
+    }
+}
+
+void SvgTreeBuilder::setStyleProperty(ComputedStyle &style, Atom property, const QString &value) {
+    const QString *current = style.declared(property);
+    if (current != nullptr && *current == value) {
+        return;
+    }
+    ComputedStyleData &d = style.edit();
+    d.declared.insert(property, value);
+    const Keyword keyword = findKeyword(value);
+    switch (property) {
+    case atoms::Fill:
+        if (value.isEmpty()) {
+            d.fill = PaintType::Unset;
+        } else if (keyword == Keyword::None) {
+            d.fill = PaintType::None;
+        } else {
+            d.fill = PaintType::Color;
+            d.fillColor = parseColorCached(value);
+        }
+        break;
+    case atoms::FillOpacity:
+        d.hasFillOpacity = !value.isEmpty();
+        d.fillOpacity = parseOpacity(value);
+        break;
+    case atoms::FillRule:
+        d.fillRule = (keyword == Keyword::Evenodd) ? Qt::OddEvenFill : Qt::WindingFill;
+        break;
+    case atoms::Stroke:
+        if (value.isEmpty()) {
+            d.stroke = PaintType::Unset;
+        } else if (keyword == Keyword::None) {
+            d.stroke = PaintType::None;
+        } else {
+            d.stroke = PaintType::Color;
+            d.strokeColor = parseColorCached(value);
+        }
+        break;
+    case atoms::StrokeOpacity:
+        d.hasStrokeOpacity = !value.isEmpty();
+        d.strokeOpacity = parseOpacity(value);
+        break;
+    case atoms::StrokeWidth: d.strokeWidth = toDouble(value); break;
+    case atoms::StrokeLinecap:
+        switch (keyword) {
+        case Keyword::Round: d.strokeLinecap = Qt::RoundCap; break;
+        case Keyword::Square: d.strokeLinecap = Qt::SquareCap; break;
+        default: d.strokeLinecap = Qt::FlatCap; break; // butt
+        }
+        break;
+    case atoms::StrokeLinejoin:
+        switch (keyword) {
+        case Keyword::Round: d.strokeLinejoin = Qt::RoundJoin; break;
+        case Keyword::Bevel: d.strokeLinejoin = Qt::BevelJoin; break;
+        default: d.strokeLinejoin = Qt::MiterJoin; break; // miter
+        }
+        break;
+    case atoms::StrokeDasharray: d.strokeDashArray = parseDashArray(value); break;
+    case atoms::StrokeDashoffset: {
+        d.hasStrokeDashOffset = false;
+        if (!(value.isEmpty() || keyword == Keyword::None)) {
+            bool ok;
+            double offset = value.toDouble(&ok);
+            if (ok) {
+                d.hasStrokeDashOffset = true;
+                d.strokeDashOffset = offset;
+            } else {
+                LOG() << "Invalid stroke dash offset:" << value;
+            }
+        }
+        break;
+    }
+    case atoms::FontSize:
+        d.fontSizeUnit = FontSizeUnit::None;
+        if (value.endsWith(QLatin1String("px"))) {
+            d.fontSizeUnit = FontSizeUnit::Px;
+            d.fontSize = toDouble(value.mid(0, value.size() - 2));
+        } else if (value.endsWith(QLatin1String("pt"))) {
+            d.fontSizeUnit = FontSizeUnit::Pt;
+            d.fontSize = toDouble(value.mid(0, value.size() - 2));
+        }
+        break;
+    case atoms::FontFamily: d.fontFamily = value; break;
+    case atoms::FontWeight:
+        switch (keyword) {
+        case Keyword::Thin: d.fontWeight = QFont::Thin; break;
+        case Keyword::Light: d.fontWeight = QFont::Light; break;
+        case Keyword::Medium: d.fontWeight = QFont::Medium; break;
+        case Keyword::Bold: d.fontWeight = QFont::Bold; break;
+        case Keyword::Black: d.fontWeight = QFont::Black; break;
+        default: d.fontWeight = QFont::Normal; break; // normal
+        }
+        break;
+    case atoms::FontStretch:
+        switch (keyword) {
+        case Keyword::UltraCondensed: d.fontStretch = QFont::UltraCondensed; break;
+        case Keyword::ExtraCondensed: d.fontStretch = QFont::ExtraCondensed; break;
+        case Keyword::Condensed: d.fontStretch = QFont::Condensed; break;
+        case Keyword::SemiCondensed: d.fontStretch = QFont::SemiCondensed; break;
+        case Keyword::SemiExpanded: d.fontStretch = QFont::SemiExpanded; break;
+        case Keyword::Expanded: d.fontStretch = QFont::Expanded; break;
+        case Keyword::ExtraExpanded: d.fontStretch = QFont::ExtraExpanded; break;
+        case Keyword::UltraExpanded: d.fontStretch = QFont::UltraExpanded; break;
+        default: d.fontStretch = QFont::Unstretched; break; // normal
+        }
+        break;
+    case atoms::FontStyle:
+        switch (keyword) {
+        case Keyword::Italic: d.fontStyle = QFont::StyleItalic; break;
+        case Keyword::Oblique: d.fontStyle = QFont::StyleOblique; break;
+        default: d.fontStyle = QFont::StyleNormal; break; // normal
+        }
+        break;
+    case atoms::TextAnchor:
+        switch (keyword) {
+        case Keyword::Middle: d.textAnchor = Qt::AlignHCenter; break;
+        case Keyword::End: d.textAnchor = Qt::AlignRight; break;
+        default: d.textAnchor = Qt::AlignLeft; break;
+        }
+        break;
+    default: break;
+    }
+}
+
+ComputedStyle SvgTreeBuilder::presentationStyle(const AttributeList &xml_attributes) {
+    ComputedStyle style;
+    for (const Attribute &attr : xml_attributes) {
+        if (AtomTable::isPresentation(attr.name)) {
+            setStyleProperty(style, attr.name, attr.value);
+        }
+    }
+    return style;
+}
+
+QColor SvgTreeBuilder::parseColorCached(const QString &value) {
+    auto it = m_colorCache.constFind(value);
+    if (it != m_colorCache.constEnd()) {
+        return it.value();
+    }
+    QColor color = parseColor(value, m_arena);
+    m_colorCache.insert(value, color);
+    return color;
+}
+
+
+/**
+ * Decodes shape of an element, the rectangle is written to the node directly. Path data and
+ * transforms are decoded separately (see `decodePath` and `decodeTransform`), so that identical
+ * values are decoded once.
+ */
+static void decodeElement(SvgNode &node) {
+    const AttributeList &xml = node.attributes;
+    switch (node.kind) {
+    case SvgNodeKind::Rect: {
+        qreal x = xml.value(atoms::X).toDouble();
+        qreal y = xml.value(atoms::Y).toDouble();
+        qreal w = xml.value(atoms::Width).toDouble();
+        qreal h = xml.value(atoms::Height).toDouble();
+        node.geometry = QRectF(x, y, w, h);
+        break;
+    }
+    case SvgNodeKind::Circle: {
+        qreal cx = toDouble(xml.value(atoms::Cx));
+        qreal cy = toDouble(xml.value(atoms::Cy));
+        qreal rx = toDouble(xml.value(atoms::R));
+        QRectF r(0, 0, 2 * rx, 2 * rx);
+        r.translate(cx - rx, cy - rx);
+        node.geometry = r;
+        break;
+    }
+    case SvgNodeKind::Ellipse: {
+        qreal cx = toDouble(xml.value(atoms::Cx));
+        qreal cy = toDouble(xml.value(atoms::Cy));
+        qreal rx = toDouble(xml.value(atoms::Rx));
+        qreal ry = toDouble(xml.value(atoms::Ry));
+        QRectF r(0, 0, 2 * rx, 2 * ry);
+        r.translate(cx - rx, cy - ry);
+        node.geometry = r;
+        break;
+    }
+    case SvgNodeKind::TextElement:
+    case SvgNodeKind::Tspan: {
+        qreal x = toDouble(xml.value(atoms::X));
+        qreal y = toDouble(xml.value(atoms::Y));
+        node.geometry = QRectF(QPointF(x, y), QSizeF());
+        break;
+    }
+    default: break;
+    }
+}
+
+/** Invalid lists are reported and ignored as a whole, see `svgtransform.h`. */
+static QTransform decodeTransform(const QString &value) {
+    QTransform transform;
+    QString error;
+    if (!parseTransform(value, &transform, &error)) {
+        LOG() << "Invalid transform" << value << ":" << error;
+    }
+    return transform;
+}
+
+/**
+ * Runs in parallel for different elements, the data (possibly shared with other elements) is only
+ * read.
+ */
+static QPainterPath decodePath(const SvgNode &node, Arena &arena) {
+    const QString data = node.attributes.value(atoms::D);
+    QPainterPath p;
+    parsePathDataFast(data, p, arena);
+    p.setFillRule(node.style->fillRule);
+    return p;
+}
+
+/**
+ * Geometry decoding shared by all threads. Elements (shapes), distinct paths and distinct
+ * transforms are split into chunks in document order, each thread claims the next unprocessed
+ * chunk until all are done.
+ */
+class GeometryJobs {
+public:
+    GeometryJobs(
+        SvgNode *nodes,
+        const QVector<int> &elements,
+        const QVector<PathJob> &paths,
+        QPainterPath *path_slots,
+        const QVector<TransformJob> &transforms,
+        QTransform *transform_slots,
+        int chunk_size)
+        : m_nodes(nodes)
+        , m_elements(elements)
+        , m_paths(paths)
+        , m_pathSlots(path_slots)
+        , m_transforms(transforms)
+        , m_transformSlots(transform_slots)
+        , m_chunkSize(chunk_size) {}
+
+    int size() const { return m_elements.size() + m_paths.size() + m_transforms.size(); }
+
+    /** Temporaries of each thread live in its own arena, freed when the thread is done. */
+    void drain() {
+        const int size = this->size();
+        Arena arena;
+        for (;;) {
+            const int begin = m_next.fetchAndAddRelaxed(m_chunkSize);
+            if (begin >= size) {
+                break;
+            }
+            const int end = qMin(begin + m_chunkSize, size);
+            for (int i = begin; i < end; ++i) {
+                run(i, arena);
+            }
+        }
+        m_arenaAllocations.fetchAndAddRelaxed(int(arena.allocations()));
+        m_arenaBlocks.fetchAndAddRelaxed(int(arena.blocks()));
+    }
+
+    quint64 arenaAllocations() const { return quint64(m_arenaAllocations.loadAcquire()); }
+    quint64 arenaBlocks() const { return quint64(m_arenaBlocks.loadAcquire()); }
+
+private:
+    void run(int i, Arena &arena) {
+        if (i < m_elements.size()) {
+            decodeElement(m_nodes[m_elements.at(i)]);
+            return;
+        }
+        i -= m_elements.size();
+        if (i < m_paths.size()) {
+            const PathJob &job = m_paths.at(i);
+            m_pathSlots[job.slot] = decodePath(m_nodes[job.node], arena);
+            return;
+        }
+        const TransformJob &job = m_transforms.at(i - m_paths.size());
+        m_transformSlots[job.slot] = decodeTransform(job.value);
+    }
+
+    SvgNode *m_nodes;
+    const QVector<int> &m_elements;
+    const QVector<PathJob> &m_paths;
+    QPainterPath *m_pathSlots;
+    const QVector<TransformJob> &m_transforms;
+    QTransform *m_transformSlots;
+    const int m_chunkSize;
+    QAtomicInt m_next { 0 };
+    QAtomicInt m_arenaAllocations { 0 };
+    QAtomicInt m_arenaBlocks { 0 };
+};
+
+class GeometryWorker : public QRunnable {
+public:
+    explicit GeometryWorker(GeometryJobs *jobs) : m_jobs(jobs) {}
+    void run() override { m_jobs->drain(); }
+
+private:
+    GeometryJobs *m_jobs;
+};
+
+void SvgTreeBuilder::decodeGeometry() {
+    ParseProfile *profile = this->profile();
+    PhaseTimer timer(profile, ParsePhase::Geometry);
+    QVector<SvgNode> &nodes = m_tree.m_nodes;
+    QVector<QPainterPath> &path_slots = m_tree.m_paths;
+    QVector<QTransform> &transform_slots = m_tree.m_transforms;
+    ParseStats &stats = m_tree.m_stats;
+    QVector<int> elements;
+    elements.reserve(nodes.size());
+    QVector<PathJob> paths;
+    // Slots of paths shared by later elements of the document.
+    QHash<PathKey, int> &known = m_knownPaths;
+    // Slot of every element sharing a path of the document, the saving is known after decoding.
+    QVector<int> shared;
+    QVector<TransformJob> transforms;
+    // Elements with a transform, identities are dropped after decoding.
+    QVector<int> transformed;
+    // Nodes read since the last call, the tree may be decoded in several steps.
+    const int first = m_decoded;
+    m_decoded = nodes.size();
+    for (int i = first; i < nodes.size(); ++i) {
+        SvgNode &node = nodes[i];
+        if (node.kind == SvgNodeKind::Text) {
+            continue;
+        }
+        elements.append(i);
+        const QString *transform = isTransformable(node.kind)
+                                       ? node.attributes.find(atoms::Transform)
+                                       : nullptr;
+        // Shares the data of the attribute, unless there is whitespace to trim.
+        const QString transform_key = transform ? transform->trimmed() : QString();
+        if (!transform_key.isEmpty()) {
+            auto slot = m_knownTransforms.constFind(transform_key);
+            if (slot != m_knownTransforms.constEnd()) {
+                node.transform = slot.value();
+                ++stats.transformCacheHits;
+            } else {
+                node.transform = transform_slots.size();
+                transform_slots.append(QTransform());
+                m_knownTransforms.insert(transform_key, node.transform);
+                transforms.append({ transform_key, node.transform });
+                ++stats.transformCacheMisses;
+            }
+            transformed.append(i);
+        }
+        if (node.kind != SvgNodeKind::Path) {
+            continue;
+        }
+        if (m_options.pathCache == PathCacheMode::None) {
+            node.path = path_slots.size();
+            path_slots.append(QPainterPath());
+            paths.append({ i, node.path });
+            ++stats.pathCacheMisses;
+            continue;
+        }
+        const PathKey key { node.attributes.value(atoms::D), node.style->fillRule };
+        auto slot = known.constFind(key);
+        if (slot != known.constEnd()) {
+            node.path = slot.value();
+            shared.append(node.path);
+            ++stats.pathCacheHits;
+            continue;
+        }
+        node.path = path_slots.size();
+        known.insert(key, node.path);
+        QPainterPath cached;
+        if (m_options.pathCache == PathCacheMode::Process
+            && PathCache::global().find(key, cached)) {
+            path_slots.append(cached);
+            ++stats.pathCacheHits;
+            stats.pathCacheSavedElements += cached.elementCount();
+        } else {
+            path_slots.append(QPainterPath());
+            paths.append({ i, node.path });
+            ++stats.pathCacheMisses;
+        }
+    }
+
+    int threads = (m_options.threads > 0) ? m_options.threads : QThread::idealThreadCount();
+    if (elements.size() < MIN_PARALLEL_ELEMENTS) {
+        threads = 1;
+    }
+    // Several chunks per thread keep the threads busy, when paths differ in length.
+    const int jobs_count = elements.size() + paths.size() + transforms.size();
+    const int chunk_size = qMax(1, jobs_count / (threads * 8));
+    // The nodes and slots must not be detached while other threads write to them.
+    GeometryJobs jobs(
+        nodes.data(), elements, paths, path_slots.data(), transforms, transform_slots.data(),
+        chunk_size);
+    if (threads > 1) {
+        // Own pool, the caller itself may run in the global one.
+        QThreadPool pool;
+        pool.setMaxThreadCount(threads - 1);
+        for (int i = 0; i < threads - 1; ++i) {
+            auto *worker = new GeometryWorker(&jobs);
+            worker->setAutoDelete(true);
+            pool.start(worker);
+        }
+        jobs.drain();
+        pool.waitForDone();
+    } else {
+        jobs.drain();
+    }
+    stats.arenaAllocations += jobs.arenaAllocations();
+    stats.arenaBlocks += jobs.arenaBlocks();
+
+    // Identity (or invalid) lists keep their slot, so that later hits resolve the same way.
+    for (int index : transformed) {
+        SvgNode &node = nodes[index];
+        if (transform_slots.at(node.transform).isIdentity()) {
+            node.transform = -1;
+        }
+    }
+
+    for (int slot : shared) {
+        stats.pathCacheSavedElements += path_slots.at(slot).elementCount();
+    }
+    if (profile != nullptr) {
+        for (int index : elements) {
+            const SvgNode &node = nodes.at(index);
+            if (node.kind == SvgNodeKind::Path) {
+                profile->elements[m_tree.m_atoms->name(node.name)].pathSegments
+                    += quint64(path_slots.at(node.path).elementCount());
+            }
+        }
+    }
+    if (m_options.pathCache == PathCacheMode::Process) {
+        for (const PathJob &job : paths) {
+            const SvgNode &node = nodes.at(job.node);
+            const PathKey key { node.attributes.value(atoms::D), node.style->fillRule };
+            PathCache::global().insert(key, path_slots.at(job.slot));
+        }
+    }
+}
+
+SvgTree parseTreeFromFileName(const QString &filename, const ParseOptions &options) {
+    if (!options.cacheDirectory.isEmpty()) {
+        return CompiledCache(options.cacheDirectory).load(filename, options);
+    }
+    QFile file(filename);
+    file.open(QIODevice::ReadOnly);
+    return parseTreeFromFile(&file, options);
+}
+
+SvgTree parseTreeFromFile(QFile *file, const ParseOptions &options) {
+    SvgTreeBuilder builder;
+    builder.setOptions(options);
+    if (options.input == InputMode::Mapped || options.reader == ReaderBackend::Tokenizer) {
+        // The reader decodes directly from the mapped pages, no copy of the file is made.
+        SvgInput input(file);
+        if (options.reader == ReaderBackend::Tokenizer
+            && SvgTokenizer::isSupportedEncoding(input.begin(), input.end())) {
+            SvgTokenizer tokenizer(input.begin(), input.end());
+            builder.read(&tokenizer);
+        } else {
+            QXmlStreamReader xml(input.bytes());
+            QtXmlReader reader(&xml);
+            builder.read(&reader);
+        }
+    } else {
+        QXmlStreamReader xml(file);
+        QtXmlReader reader(&xml);
+        builder.read(&reader);
+    }
+    return builder.take();
+}
+
+SvgTree parseTree(QXmlStreamReader *xml, bool skip_definitions) {
+    SvgTreeBuilder builder(skip_definitions);
+    QtXmlReader reader(xml);
+    builder.read(&reader);
+    return builder.take();
+}
+
+} // namespace svgscene
@@ -0,0 +1,294 @@
+/**
+ * Intermediate document tree.
+ *
+ * Parsing is split into two phases. The first phase reads the XML into `SvgTree`, resolving
+ * styles and decoding geometry on the way. It does not touch any graphics item or scene and can
+ * run on any thread. The second phase (`SvgHandler::load(const SvgTree &)`) only constructs the
+ * Qt items and has to run on the thread owning the scene.
+ *
+ * ## Example
+ * ```
+ *  QFuture<SvgTree> tree = QtConcurrent::run([path] { return parseTreeFromFileName(path); });
+ *  // ... other startup work ...
+ *  SvgDocument document = materialize(scene, tree.result());
+ * ```
+ *
+ * @file
+ */
+#pragma once
+
+#include "svgarena.h"
+#include "svgattributes.h"
+#include "svginput.h"
+#include "svgpathcache.h"
+#include "svgreader.h"
+#include "svgstats.h"
+#include "svgstyle.h"
+
+#include <QColor>
+#include <QHash>
+#include <QPainterPath>
+#include <QRectF>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QTransform>
+#include <QVector>
+#include <functional>
+
+class QDataStream;
+class QXmlStreamReader;
+
+namespace svgscene {
+
+/**
+ * Options of the parse entrypoints.
+ */
+struct ParseOptions {
+    /** How the file is read, see `svginput.h`. */
+    InputMode input = InputMode::Mapped;
+    /**
+     * XML reader implementation, see `svgreader.h`. The tokenizer always reads the whole file at
+     * once (mapped, if possible). Documents in encodings other than UTF-8 fall back to QtXml.
+     */
+    ReaderBackend reader = ReaderBackend::QtXml;
+    /**
+     * Number of threads decoding paths and transforms, 0 means one per core. Small documents are
+     * always decoded on the calling thread. The result does not depend on the thread count.
+     */
+    int threads = 0;
+    /** Sharing of identical path data, see `svgpathcache.h`. */
+    PathCacheMode pathCache = PathCacheMode::Document;
+    /**
+     * Directory of compiled documents (see `svgcompiled.h`), empty disables the cache. Used only
+     * by the entrypoints taking a file name.
+     */
+    QString cacheDirectory;
+    /**
+     * Children of large groups are created on demand, see `SvgHandler::setLazy`. Used only by the
+     * entrypoints creating items.
+     */
+    bool lazy = false;
+    /**
+     * Collects times of the parse phases and counters per element name, see `svgstats.h`. Trees
+     * loaded from the compiled cache have no profile of the tree phase.
+     */
+    bool profile = false;
+    /**
+     * Attributes indexed for searches in addition to `id` and `class`, see `svgindex.h`. Used
+     * only by the entrypoints creating items.
+     */
+    QStringList indexedAttributes;
+    /**
+     * Searches of the document look attributes up in the index (see `svgindex.h`) instead of
+     * walking the items. The index refers to the items created by the parse. Searches reject
+     * entries of items deleted by the application, `SvgDocument::rebuildIndex` drops them. Used
+     * only by the entrypoints creating items.
+     */
+    bool indexedSearch = false;
+    /**
+     * Polled by the tree phase between slices of the input, the parse stops early once it returns
+     * true (and keeps returning true) and the tree is incomplete then. Used by `parseAsync`.
+     */
+    std::function<bool()> isCanceled;
+
+    ParseOptions() = default;
+    explicit ParseOptions(InputMode input) : input(input) {}
+};
+
+/**
+ * Elements the handler knows how to materialize.
+ */
+enum class SvgNodeKind : quint8 {
+    /** Character data, see `SvgTree::text`. */
+    Text,
+    /** Any element not listed below. */
+    Unknown,
+    Svg,
+    Defs,
+    Group,
+    Hyperlink,
+    Rect,
+    Circle,
+    Ellipse,
+    Path,
+    TextElement,
+    Tspan,
+    FlowRoot,
+};
+
+/**
+ * Element or character data of the document.
+ *
+ * Nodes are stored in document order, descendants of a node directly follow it.
+ */
+struct SvgNode {
+    SvgNodeKind kind = SvgNodeKind::Unknown;
+    /** Whether the end tag was read. Malformed input may leave elements open. */
+    bool closed = false;
+    /** Element name, invalid for character data. */
+    Atom name = atoms::INVALID;
+    /** Index of the parent element, -1 for top level nodes. */
+    int parent = -1;
+    /** Index behind the last descendant. */
+    int end = 0;
+
+    AttributeList attributes;
+    /** Inherited style with the element's own declarations applied. */
+    ComputedStyle style;
+    /** Style of presentation attributes only, used by groups and hyperlinks. */
+    ComputedStyle ownStyle;
+
+    /** Rectangle of rect, circle and ellipse. Position of text elements is its top left. */
+    QRectF geometry;
+    /** Index of the decoded path, transform and character data in the tree, or -1. */
+    int path = -1;
+    int transform = -1;
+    int text = -1;
+};
+
+/**
+ * Result of the first parse phase. Copying is cheap, all containers are implicitly shared.
+ */
+class SvgTree {
+public:
+    SvgTree();
+
+    const QVector<SvgNode> &nodes() const;
+    bool isEmpty() const;
+
+    /** Names of all elements and attributes in the tree. */
+    QSharedPointer<const AtomTable> atoms() const;
+
+    /**
+     * Path data of the node, the fill rule is already applied. Empty for non-path nodes. Nodes
+     * with identical data may share the path (see `ParseOptions::pathCache`).
+     */
+    QPainterPath path(const SvgNode &node) const;
+    /** Transform of the node, identity when not declared or invalid. */
+    QTransform transform(const SvgNode &node) const;
+    bool hasTransform(const SvgNode &node) const;
+    /** Character data. */
+    QString text(const SvgNode &node) const;
+
+    const ParseStats &stats() const;
+
+private:
+    friend class SvgTreeBuilder;
+    friend QDataStream &operator<<(QDataStream &out, const SvgTree &tree);
+    friend QDataStream &operator>>(QDataStream &in, SvgTree &tree);
+
+    QSharedPointer<AtomTable> m_atoms;
+    QVector<SvgNode> m_nodes;
+    QVector<QPainterPath> m_paths;
+    QVector<QTransform> m_transforms;
+    QVector<QString> m_texts;
+    ParseStats m_stats;
+};
+
+/** Compiled form of the tree, see `svgcompiled.h`. */
+QDataStream &operator<<(QDataStream &out, const SvgTree &tree);
+QDataStream &operator>>(QDataStream &in, SvgTree &tree);
+
+/**
+ * First phase of the parse, does not use any GUI objects.
+ */
+class SvgTreeBuilder {
+public:
+    /**
+     * @param skip_definitions  content of `defs` elements is not read
+     */
+    explicit SvgTreeBuilder(bool skip_definitions = false);
+
+    /** Reads the whole document. */
+    void read(SvgReader *reader);
+
+    /**
+     * Reads at most `max_tokens` tokens, used by incremental parsing (see `svgstream.h`).
+     * Returns false, when the reader stopped (end of the document, error or missing data).
+     */
+    bool readSome(SvgReader *reader, int max_tokens);
+    /**
+     * Decodes geometry of the elements read since the last call. Nodes of `tree` are complete
+     * up to the end of the vector afterwards, except for ends of the open elements.
+     */
+    void decodePending();
+    /** The tree being built, valid until the next read. */
+    const SvgTree &tree() const;
+
+    /** Decodes geometry and hands over the tree. The builder is empty afterwards. */
+    SvgTree take();
+
+    /**
+     * Only the options of geometry decoding (`threads`, `pathCache`), `profile` and `isCanceled`
+     * (by `read`) are used.
+     */
+    void setOptions(const ParseOptions &options);
+
+    /** Style of the document, parent of the top level elements. */
+    static ComputedStyle initialStyle();
+
+private:
+    void readToken(SvgReader *reader);
+    void startElement(SvgReader *reader);
+    void endElement();
+    void characters(const QString &text);
+
+    AttributeList parseXmlAttributes(SvgReader *reader, ComputedStyle &style);
+    void
+    mergeCSSAttributes(ComputedStyle &style, Atom attr_name, const AttributeList &xml_attributes);
+    /** Declares property on the style, detaching it only when the value differs. */
+    void setStyleProperty(ComputedStyle &style, Atom property, const QString &value);
+    /** Style made only from presentation attributes of the element (no inheritance). */
+    ComputedStyle presentationStyle(const AttributeList &xml_attributes);
+    QColor parseColorCached(const QString &value);
+
+    /** Decodes paths, transforms and shapes of elements not decoded yet, possibly in parallel. */
+    void decodeGeometry();
+    /** Profile of the tree being built, null when not profiling. */
+    ParseProfile *profile();
+
+    SvgTree m_tree;
+    bool m_skipDefinitions;
+    /** Indices of open elements. */
+    QVector<int> m_open;
+    ComputedStyle m_initialStyle;
+    /** Number of open elements whose character data are kept. */
+    int m_textDepth = 0;
+    ParseOptions m_options;
+    /** Documents use only a few distinct colors, each is parsed once. */
+    QHash<QString, QColor> m_colorCache;
+    /** Number of nodes with decoded geometry. */
+    int m_decoded = 0;
+    /** Slot of each distinct path decoded so far. */
+    QHash<PathKey, int> m_knownPaths;
+    /** Slot of each distinct (trimmed) transform list parsed so far. */
+    QHash<QString, int> m_knownTransforms;
+    /** Temporaries of the parse on the reading thread, released by `take`. */
+    Arena m_arena;
+};
+
+/**
+ * Parses file into the intermediate tree. Safe to call from any thread.
+ *
+ * @param filename  path to a SVG file
+ * @param options   see `ParseOptions`
+ */
+SvgTree
+parseTreeFromFileName(const QString &filename, const ParseOptions &options = ParseOptions());
+
+/**
+ * Parses file into the intermediate tree. Safe to call from any thread, the file must not be used
+ * by other threads meanwhile.
+ *
+ * @param file      opened file
+ * @param options   see `ParseOptions`, input mode defaults to `InputMode::Device` here
+ */
+SvgTree
+parseTreeFromFile(QFile *file, const ParseOptions &options = ParseOptions(InputMode::Device));
+
+/**
+ * Parses XML stream into the intermediate tree.
+ */
+SvgTree parseTree(QXmlStreamReader *xml, bool skip_definitions = false);
+
+} // namespace svgscene